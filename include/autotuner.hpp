@@ -0,0 +1,76 @@
+#pragma once
+
+#include "config.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace bloxminer {
+
+class Miner;
+
+/**
+ * Searches worker count, placement, SMT use and chunk length for the best
+ * hashrate and the best KH/W on this machine
+ *
+ * Runs against a live Miner connected to its pool, so shares found while
+ * tuning are submitted as usual. Each configuration is applied through the
+ * runtime resize/placement API, left to warm up, then measured in windows
+ * (hashrate from the per-thread counters, power from RAPL energy deltas)
+ * until the 95% confidence interval of both is within the requested
+ * fraction of their mean.
+ *
+ * The search is staged rather than exhaustive: thread counts first, then
+ * placement and SMT variants of the leaders, then chunk length.
+ */
+class Autotuner {
+public:
+    enum class Goal {
+        Hashrate,
+        Efficiency
+    };
+
+    struct Options {
+        uint32_t warmup_seconds = 15;   // After every change, before measuring
+        uint32_t window_seconds = 5;    // One sample
+        uint32_t min_windows = 3;
+        uint32_t max_windows = 12;
+        double confidence = 0.02;       // Target 95% CI half-width, relative to mean
+    };
+
+    Autotuner(Miner& miner, const MinerConfig& config, const Options& options);
+    Autotuner(Miner& miner, const MinerConfig& config) : Autotuner(miner, config, Options()) {}
+
+    /**
+     * Run the search; blocks for several minutes
+     * Leaves the miner running the winner for goal.
+     * @return false if stopped or nothing could be measured
+     */
+    bool run(Goal goal, TunedProfile& best_hashrate, TunedProfile& best_efficiency);
+
+    /**
+     * Abort run() within about 100 ms
+     */
+    void stop() { m_stop = true; }
+
+    /**
+     * One-line summary of a profile and its measurements, for logs
+     */
+    static std::string describe(const TunedProfile& profile);
+
+private:
+    Miner& m_miner;
+    MinerConfig m_config;
+    Options m_options;
+    std::atomic<bool> m_stop{false};
+    bool m_have_rapl = false;
+    TunedProfile m_applied;  // What the miner is running now
+
+    void apply(const TunedProfile& profile);
+    bool wait_for_hashes();
+    bool sleep_seconds(uint32_t seconds);
+    bool measure(TunedProfile& profile);
+};
+
+}  // namespace bloxminer
@@ -14,6 +14,47 @@ struct PoolConfig {
     uint16_t port = 3956;
     int priority = 0;      // lower = higher priority
     int fail_count = 0;    // consecutive failures
+    bool tls = false;      // stratum+ssl
+    bool tls_verify = true;  // Check the pool's certificate chain and hostname
+};
+
+/**
+ * How mining threads are placed on cores
+ */
+enum class ThreadPlacement {
+    Pinned,    // One core per thread (when threads <= cores)
+    Unpinned   // Left to the kernel scheduler
+};
+
+/**
+ * How the miner tells the pool which share difficulty it wants
+ */
+enum class DifficultyHint {
+    Off,       // Take what the pool's vardiff sets
+    Suggest,   // mining.suggest_difficulty on connect and on hashrate changes
+    Password   // d=<difficulty> in the password, on connect only
+};
+
+/**
+ * What the power/thermal governor holds the miner to
+ */
+enum class GovernorMode {
+    Off,
+    Temperature,   // Max CPU temperature, C
+    Power,         // Max CPU package power, W
+    Efficiency     // Best KH/W; no target
+};
+
+/**
+ * One measured worker-pool configuration, as found by --autotune
+ */
+struct TunedProfile {
+    uint32_t threads = 0;      // 0 = not tuned
+    ThreadPlacement placement = ThreadPlacement::Pinned;
+    bool smt = true;
+    uint32_t chunk_target_ms = 50;
+    double hashrate = 0.0;     // H/s
+    double power = 0.0;        // W, 0 if RAPL is unavailable
 };
 
 struct MinerConfig {
@@ -24,6 +65,25 @@ struct MinerConfig {
     // Multiple pool support (failover)
     std::vector<PoolConfig> pools;
     
+    // Pool selection: list order, or the lowest-latency healthy pool by probe RTT
+    bool pool_latency_ranking = false;
+    uint32_t pool_probe_interval = 30;       // Seconds between probe rounds
+    double pool_switch_margin_ms = 10.0;     // A pool must beat the current one by this much
+    double pool_switch_margin = 0.2;         // and by this fraction of the current RTT,
+    uint32_t pool_switch_confirmations = 3;  // for this many probe rounds in a row
+    
+    // Share difficulty to ask for, sized from measured hashrate
+    DifficultyHint difficulty_hint = DifficultyHint::Off;
+    double share_interval = 10.0;     // Seconds per share the suggestion aims for
+    double difficulty_change = 0.25;  // Hashrate drift that warrants a new suggestion
+    
+    // Shares found while disconnected, replayed if the pool resumes the same session
+    uint32_t share_buffer_size = 64;      // 0 disables buffering
+    uint32_t share_buffer_max_age = 30;   // Seconds a buffered share stays worth submitting
+    
+    // Binary event journal for post-mortems, read with `bloxminer journal`
+    uint32_t journal_records = 65536;     // Ring size; 0 disables the journal
+    
     // Mining credentials
     std::string wallet_address = "";  // Required - set via -u flag
     std::string worker_name = "bloxminer";
@@ -31,12 +91,45 @@ struct MinerConfig {
     
     // Mining settings
     uint32_t num_threads = 0;  // 0 = auto-detect
-    uint32_t batch_size = 0x10000;  // Nonces per batch
+    uint32_t chunk_target_ms = 50;  // Wall time per scheduled nonce range
+    ThreadPlacement placement = ThreadPlacement::Pinned;
+    bool smt = true;  // Pinned threads may share a core; false pins one per physical core
+    bool perf_counters = false;  // Per-thread perf_event IPC, GHz and cycles/hash in the stats
+    
+    // Governor settings
+    GovernorMode governor_mode = GovernorMode::Off;
+    double governor_target = 0.0;        // C or W, depending on mode
+    uint32_t governor_interval = 2;      // Seconds between adjustments
+    uint32_t governor_min_threads = 1;   // Never retire below this many workers
+    
+    // Background mode: SCHED_IDLE, unpinned workers shed on CPU pressure (PSI)
+    bool background = false;
+    double background_pressure_high = 10.0;  // % of time a task waited for CPU; sheds workers
+    double background_pressure_low = 2.0;    // Restores workers after background_recover_ms below this
+    uint32_t background_recover_ms = 2000;
+    uint32_t background_poll_ms = 50;
+    
+    // Self-healing placement: pinned workers that stay slower than the rest
+    // are moved to a spare CPU, or retired if mostly starved
+    bool heal = false;
+    uint32_t heal_interval = 10;        // Seconds per measurement
+    double heal_threshold = 0.10;       // Fraction below the median hashrate that counts as slow
+    uint32_t heal_confirmations = 3;    // Slow intervals in a row before acting
+    double heal_retire_below = 0.5;     // Without a spare CPU, retire below this fraction of the median
+    
+    // Autotune results, kept in the config file for reference
+    TunedProfile tuned_hashrate;
+    TunedProfile tuned_efficiency;
     
     // Display settings
     uint32_t stats_interval = 10;  // Seconds between stats output
     bool show_shares = true;
     
+    // Log file, written by the logger thread alongside the terminal
+    std::string log_file = "";       // Empty: terminal only
+    uint32_t log_max_size_mb = 10;   // Rotate past this size
+    uint32_t log_keep = 3;           // Rotated files kept (log.1 ... log.N)
+    
     // Connection settings
     uint32_t reconnect_delay = 5;  // Seconds
     uint32_t timeout = 30;  // Seconds
@@ -45,6 +138,7 @@ struct MinerConfig {
     bool api_enabled = true;
     uint16_t api_port = 4068;  // Standard mining API port
     std::string api_bind_address = "127.0.0.1";  // Default to localhost for security
+    bool api_control = false;  // POST /api/control/* endpoints (resize, pause, placement)
 };
 
 // Version info
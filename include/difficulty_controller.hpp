@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace bloxminer {
+
+/**
+ * Picks the share difficulty to ask the pool for, and tracks share rate
+ *
+ * The ideal difficulty finds one share per target interval at the measured
+ * hashrate. Hashrate samples are smoothed; a new suggestion is made on
+ * every (re)connect and whenever the ideal drifts from the last suggestion
+ * by more than the change threshold, so short dips do not make the pool
+ * retarget.
+ */
+class DifficultyController {
+public:
+    struct Options {
+        double target_interval = 10.0;  // Seconds per share wanted
+        double change = 0.25;           // Relative drift that warrants a new suggestion
+        uint32_t warmup = 3;            // Hashrate samples before the first suggestion
+    };
+
+    explicit DifficultyController(const Options& options);
+
+    /**
+     * Expected hashes to find one share at a pool difficulty
+     * Difficulty 1 is the 0x00000000ffff... target, about 2^32 hashes.
+     */
+    static double hashes_per_share(double difficulty);
+
+    /**
+     * Difficulty that finds a share every target interval at a hashrate
+     */
+    double ideal(double hashrate) const;
+
+    /**
+     * Feed a hashrate sample (H/s over the last interval)
+     * @return Difficulty to suggest now, or 0 if the last one still fits
+     */
+    double update(double hashrate);
+
+    /**
+     * New pool session: the next suggestion goes out regardless of drift
+     * @return Difficulty to send with the handshake, or 0 before warmup
+     */
+    double on_connect();
+
+    /**
+     * Count a share the pool accepted or rejected
+     */
+    void record_share(std::chrono::steady_clock::time_point now);
+
+    /**
+     * Smoothed seconds between shares; 0 until two shares were seen
+     */
+    double observed_interval() const { return m_interval; }
+
+    /**
+     * Seconds per share the pool's difficulty gives at the smoothed hashrate
+     */
+    double expected_interval(double pool_difficulty) const;
+
+    double hashrate() const { return m_hashrate; }
+    double suggested() const { return m_suggested; }
+    uint64_t suggestions() const { return m_suggestions; }
+    const Options& options() const { return m_options; }
+
+private:
+    Options m_options;
+    double m_hashrate = 0.0;   // EWMA of samples
+    uint32_t m_samples = 0;
+    double m_suggested = 0.0;  // Last difficulty sent; 0 forces the next
+    uint64_t m_suggestions = 0;
+    double m_interval = 0.0;   // EWMA of seconds between shares
+    bool m_have_share = false;
+    std::chrono::steady_clock::time_point m_last_share;
+};
+
+}  // namespace bloxminer
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+namespace bloxminer {
+
+/**
+ * Pool-side view of the miner: what the accepted shares are worth
+ *
+ * Local hashrate counts hashes; a pool credits accepted share difficulty.
+ * This keeps both per pool in one-minute buckets for 24 hours: hashes
+ * mined and the shares they should have found at the difficulty of the
+ * time, shares found, and results with their difficulty. A window over
+ * the buckets gives
+ * - effective hashrate: accepted difficulty times the hashes per
+ *   difficulty-1 share, over the time covered, with a 95% interval from
+ *   the share count (shares arrive as a Poisson process);
+ * - luck: shares found over shares expected, with the same interval;
+ * - lost: the part of the found difficulty that was not credited
+ *   (rejected, stale, never answered);
+ * - gap: effective below local, which is luck and losses together.
+ * A gap well outside the luck interval points at rejects or stales.
+ */
+class EffectiveHashrate {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int64_t BUCKET_SECONDS = 60;
+    static constexpr int64_t HISTORY_SECONDS = 24 * 3600;
+
+    struct Window {
+        double seconds = 0.0;          // Time covered: less than asked for early in a run
+        double local = 0.0;            // H/s counted locally
+        double effective = 0.0;        // H/s credited by the pool
+        double effective_low = 0.0;    // 95% interval
+        double effective_high = 0.0;
+        double gap = 0.0;              // 1 - effective / local; NaN without local hashes
+        uint64_t found = 0;
+        uint64_t accepted = 0;
+        uint64_t rejected = 0;
+        double expected = 0.0;         // Shares the local hashes should have found
+        double luck = 0.0;             // found / expected; NaN before any expectation
+        double luck_low = 0.0;
+        double luck_high = 0.0;
+        double lost = 0.0;             // Fraction of found difficulty not accepted
+    };
+
+    explicit EffectiveHashrate(Clock::time_point start);
+
+    /**
+     * Hashes mined on a pool since the last call, at its share difficulty
+     */
+    void add_work(Clock::time_point now, size_t pool, double hashes, double difficulty);
+
+    /**
+     * A share met the target, whether or not it could be submitted
+     */
+    void add_found(Clock::time_point now, size_t pool, double difficulty);
+
+    /**
+     * The pool answered a submitted share
+     */
+    void add_result(Clock::time_point now, size_t pool, double difficulty, bool accepted);
+
+    /**
+     * Totals over the last `seconds`, rounded out to whole buckets
+     * @param pool  One pool's buckets, or all with -1
+     */
+    Window window(Clock::time_point now, double seconds, int pool = -1) const;
+
+    /**
+     * 95% interval for the mean of a Poisson count n (Wilson-Hilferty)
+     */
+    static void poisson_interval(double n, double& low, double& high);
+
+private:
+    struct Bucket {
+        int64_t index;          // Minutes since start
+        size_t pool;
+        double hashes = 0.0;
+        double expected = 0.0;
+        uint64_t found = 0;
+        double found_difficulty = 0.0;
+        uint64_t accepted = 0;
+        double accepted_difficulty = 0.0;
+        uint64_t rejected = 0;
+    };
+
+    Bucket& bucket(Clock::time_point now, size_t pool);
+
+    Clock::time_point m_start;
+    std::deque<Bucket> m_buckets;  // Oldest first
+};
+
+}  // namespace bloxminer
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "config.hpp"
+
+#include <cstdint>
+
+namespace bloxminer {
+
+/**
+ * Closed-loop power/thermal governor for the worker pool
+ *
+ * The output is a capacity in (0, 1]: the fraction of the configured pool
+ * to run. It maps to a worker count plus a duty cycle per worker, so the
+ * pool can be throttled more finely than whole threads.
+ *
+ * Temperature and power targets are limits: a PID controller in velocity
+ * form holds the reading at or below the target, and clamping its output
+ * is the anti-windup. Efficiency has no setpoint, so the governor instead
+ * hill-climbs capacity one worker at a time towards the best KH/W.
+ */
+class Governor {
+public:
+    static constexpr double KP = 0.5;          // Per unit of relative error
+    static constexpr double KI = 0.25;         // Per unit of relative error per second
+    static constexpr double KD = 0.05;         // Per unit of relative error change per interval
+    static constexpr double MIN_DUTY = 0.1;    // Floor for the slowest min_threads workers
+
+    struct Decision {
+        double capacity = 1.0;     // Fraction of max_threads
+        uint32_t threads = 0;      // Workers to run
+        double duty = 1.0;         // Fraction of wall time each worker mines
+        double measurement = 0.0;  // Reading the decision was based on (C, W or KH/W)
+    };
+
+    /**
+     * @param mode         What to control; Off always returns full capacity
+     * @param target       Max C or W; ignored for efficiency
+     * @param max_threads  Configured pool size
+     * @param min_threads  Workers that are never retired
+     */
+    Governor(GovernorMode mode, double target, uint32_t max_threads, uint32_t min_threads = 1);
+
+    /**
+     * Feed one reading taken dt seconds after the previous one
+     * Readings <= 0 (sensor unavailable) keep the current decision.
+     */
+    Decision update(double measurement, double dt);
+
+    /**
+     * Change the pool size capacity is relative to (e.g. resized via the API)
+     */
+    void set_max_threads(uint32_t max_threads);
+
+    Decision current() const { return m_decision; }
+    GovernorMode mode() const { return m_mode; }
+    double target() const { return m_target; }
+
+    static const char* mode_name(GovernorMode mode);
+
+private:
+    GovernorMode m_mode;
+    double m_target;
+    uint32_t m_max_threads;
+    uint32_t m_min_threads;
+
+    double m_capacity = 1.0;
+    double m_error1 = 0.0;         // Relative error one and two updates ago
+    double m_error2 = 0.0;
+    bool m_primed = false;         // Have m_error1/m_error2 been set
+
+    double m_last_efficiency = 0.0;
+    int m_direction = -1;          // Hill-climb direction; starts by shedding a worker
+
+    Decision m_decision;
+
+    double min_capacity() const;
+    void apply_capacity(double measurement);
+};
+
+}  // namespace bloxminer
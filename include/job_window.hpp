@@ -0,0 +1,70 @@
+#pragma once
+
+#include "nonce_scheduler.hpp"
+#include "stratum/stratum_client.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+
+namespace bloxminer {
+
+/**
+ * The pool's jobs that still accept shares, newest last
+ *
+ * A mining.notify without clean_jobs leaves earlier jobs valid, so a share
+ * found just after the switch still counts. clean_jobs drops them all, as
+ * does a change of pool, session (extranonce1) or block, whatever the
+ * pool's flag says. Each job keeps the nonces it had not handed out when
+ * it was left; if the pool sends identical work again, mining resumes from
+ * there instead of rehashing from nonce 0.
+ */
+class JobWindow {
+public:
+    struct Entry {
+        uint64_t generation = 0;
+        std::string pool;                    // host:port that sent it
+        stratum::Job job;
+        NonceScheduler::Progress progress;   // Saved by suspend(); empty while current
+        bool suspended = false;
+    };
+
+    explicit JobWindow(size_t capacity = 4);
+
+    /**
+     * Record the job about to be mined, dropping the ones it invalidates
+     * @param resume Set to the saved progress of an earlier job with the
+     *               same work (header, solution template, target)
+     * @return true if resume was set
+     */
+    bool add(uint64_t generation, const std::string& pool, const stratum::Job& job,
+             NonceScheduler::Progress& resume);
+
+    /**
+     * Save what is left of a job that is no longer being mined
+     */
+    void suspend(uint64_t generation, NonceScheduler::Progress progress);
+
+    /**
+     * Add the unscanned tail of a range a worker dropped on a job change
+     */
+    void give_back(uint64_t generation, const NonceScheduler::Range& range);
+
+    /**
+     * Job for a generation, if the pool still accepts shares for it
+     */
+    const stratum::Job* find(uint64_t generation) const;
+
+    void clear() { m_entries.clear(); }
+    size_t size() const { return m_entries.size(); }
+    uint64_t resumed() const { return m_resumed; }
+
+private:
+    size_t m_capacity;
+    std::deque<Entry> m_entries;
+    uint64_t m_resumed = 0;
+
+    static bool same_work(const stratum::Job& a, const stratum::Job& b);
+};
+
+}  // namespace bloxminer
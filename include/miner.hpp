@@ -1,9 +1,23 @@
 #pragma once
 
 #include "config.hpp"
+#include "difficulty_controller.hpp"
+#include "effective_hashrate.hpp"
+#include "governor.hpp"
+#include "job_window.hpp"
+#include "pool_ranker.hpp"
+#include "placement_healer.hpp"
+#include "pressure_controller.hpp"
+#include "share_buffer.hpp"
+#include "nonce_scheduler.hpp"
 #include "stratum/stratum_client.hpp"
 #include "verus_hash.h"
 #include "utils/api_server.hpp"
+#include "utils/event_bus.hpp"
+#include "utils/journal.hpp"
+#include "utils/perf_counters.hpp"
+#include "utils/shared_stats.hpp"
+#include "utils/metrics.hpp"
 
 #include <thread>
 #include <vector>
@@ -11,6 +25,10 @@
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
+#include <memory>
+#include <limits>
+#include <array>
+#include <deque>
 
 namespace bloxminer {
 
@@ -20,21 +38,32 @@ namespace bloxminer {
 struct MinerStats {
     static constexpr size_t MAX_THREADS = 256;
     
-    std::atomic<uint64_t> hashes{0};
     std::atomic<uint64_t> shares_accepted{0};
     std::atomic<uint64_t> shares_rejected{0};
     std::atomic<uint64_t> shares_submitted{0};
+    std::atomic<uint64_t> shares_late{0};    // Found on an earlier job the pool still accepts
+    std::atomic<uint64_t> shares_stale{0};   // Found on a job no longer valid: discarded
     std::chrono::steady_clock::time_point start_time;
     
     // Per-thread hash counts for individual hashrate calculation
     std::atomic<uint64_t> thread_hashes[MAX_THREADS] = {};
     std::chrono::steady_clock::time_point thread_start_time[MAX_THREADS];
-    uint32_t num_threads = 0;
+    std::atomic<uint32_t> num_threads{0};        // Active worker slots [0, num_threads)
+    std::atomic<uint64_t> retired_hashes{0};     // Hashes from slots that were retired or reused
+    
+    uint64_t total_hashes() const {
+        uint64_t total = retired_hashes.load(std::memory_order_relaxed);
+        uint32_t n = num_threads.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < n && i < MAX_THREADS; i++) {
+            total += thread_hashes[i].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
     
     double get_hashrate() const {
         auto now = std::chrono::steady_clock::now();
         auto elapsed = std::chrono::duration<double>(now - start_time).count();
-        return elapsed > 0 ? static_cast<double>(hashes.load()) / elapsed : 0.0;
+        return elapsed > 0 ? static_cast<double>(total_hashes()) / elapsed : 0.0;
     }
     
     double get_thread_hashrate(uint32_t thread_id) const {
@@ -46,10 +75,17 @@ struct MinerStats {
     
     void init_thread(uint32_t thread_id) {
         if (thread_id < MAX_THREADS) {
-            thread_hashes[thread_id] = 0;
+            // A reused slot keeps its earlier hashes in the total
+            retire_thread(thread_id);
             thread_start_time[thread_id] = std::chrono::steady_clock::now();
         }
     }
+    
+    void retire_thread(uint32_t thread_id) {
+        if (thread_id < MAX_THREADS) {
+            retired_hashes.fetch_add(thread_hashes[thread_id].exchange(0), std::memory_order_relaxed);
+        }
+    }
 };
 
 /**
@@ -85,6 +121,41 @@ public:
      * Get current hashrate
      */
     double get_hashrate() const { return m_stats.get_hashrate(); }
+    
+    /**
+     * Grow or shrink the worker pool while mining
+     * New workers reuse the stats slots of retired ones. Retiring workers
+     * finish their current nonce range first; this waits for them. With a
+     * governor running, count is the ceiling it throttles below.
+     * @return false if count is 0 or above MinerStats::MAX_THREADS
+     */
+    bool set_thread_count(uint32_t count);
+    
+    /**
+     * Park all workers at their next range boundary, or release them
+     */
+    void set_paused(bool paused);
+    bool is_paused() const { return m_paused; }
+    
+    /**
+     * Change core placement; workers apply it at their next range boundary
+     */
+    void set_placement(ThreadPlacement placement);
+    
+    /**
+     * Allow pinned threads on SMT siblings, or pin one per physical core
+     */
+    void set_smt(bool smt);
+    
+    /**
+     * Change the wall time each nonce range should take
+     */
+    void set_chunk_target_ms(uint32_t chunk_ms);
+    
+    /**
+     * Active worker count (below the configured count while governed)
+     */
+    uint32_t thread_count() const { return m_active_threads; }
 
 private:
     // Configuration
@@ -94,19 +165,82 @@ private:
     std::atomic<bool> m_running{false};
     std::atomic<bool> m_has_job{false};
 
-    // Pool failover state
-    size_t m_current_pool_index{0};
+    // Pool failover state; the index is written under m_job_mutex and atomic
+    // so metrics can read it without the lock
+    std::atomic<size_t> m_current_pool_index{0};
     std::chrono::steady_clock::time_point m_last_primary_retry;
     uint32_t m_current_backoff_seconds{5};  // Exponential backoff: 5 → 10 → 20 → 60
     
+    // Session start (or loss) to first job, including failed attempts
+    std::chrono::steady_clock::time_point m_session_start;
+    std::atomic<bool> m_awaiting_first_job{false};
+    std::atomic<double> m_first_job_ms{0.0};
+    stratum::ConnectTiming m_connect_timing;  // Of the session that delivered it; under m_job_mutex
+    
+    // Shares found between losing the pool and re-authorizing, replayed into
+    // the resumed session; null when disabled. Under m_job_mutex.
+    std::unique_ptr<ShareBuffer> m_share_buffer;
+    std::atomic<bool> m_session_ready{false};  // Authorized: submits go straight out
+    
+    // Share difficulty to suggest from measured hashrate, and share-rate stats
+    std::unique_ptr<DifficultyController> m_difficulty;
+    mutable std::mutex m_difficulty_mutex;
+    
+    // Accepted share difficulty against local hashes, per pool, for effective
+    // hashrate and luck; taken after m_job_mutex where both are held
+    EffectiveHashrate m_effective{std::chrono::steady_clock::now()};
+    mutable std::mutex m_effective_mutex;
+    
+    // Latency ranking of the pools; null when pools are tried in list order
+    std::unique_ptr<PoolRanker> m_ranker;
+    mutable std::mutex m_ranker_mutex;
+    std::thread m_probe_thread;
+    std::atomic<size_t> m_switch_to{SIZE_MAX};  // Pool the probe thread wants moved to
+    
     // Current job
     stratum::Job m_current_job;
+    JobWindow m_jobs;  // Recent jobs that still accept shares, current one last; under m_job_mutex
     std::mutex m_job_mutex;
     std::condition_variable m_job_cv;
+    std::atomic<uint64_t> m_job_generation{0};  // Bumped on every new job; lets threads detect changes without the lock
     std::atomic<uint32_t> m_extranonce2{0};
+
+    // Hands out nonce ranges for the current job; reset on every new job
+    NonceScheduler m_scheduler;
     
-    // Threads
+    // Threads: m_mining_threads[i] runs worker i; workers at or above
+    // m_active_threads retire at their next range boundary
     std::vector<std::thread> m_mining_threads;
+    std::mutex m_pool_mutex;  // Serializes start/stop/resize of the worker pool
+    std::atomic<uint32_t> m_active_threads{0};
+    std::atomic<uint32_t> m_requested_threads{0};  // Config/API size before governor and background limits
+    std::atomic<bool> m_paused{false};
+    std::atomic<ThreadPlacement> m_placement{ThreadPlacement::Pinned};
+    std::atomic<bool> m_smt{true};
+    std::vector<int> m_core_cpus;  // First SMT sibling of each physical core
+    std::atomic<uint64_t> m_placement_generation{0};  // Bumped when placement or pool size changes
+    std::atomic<double> m_duty{1.0};                  // Fraction of wall time each worker mines
+    
+    // Power/thermal governor; null when off
+    std::unique_ptr<Governor> m_governor;
+    mutable std::mutex m_governor_mutex;
+    std::thread m_governor_thread;
+    
+    // Background mode: sheds workers on foreground CPU pressure; null when off
+    std::unique_ptr<PressureController> m_pressure;
+    mutable std::mutex m_pressure_mutex;
+    std::thread m_background_thread;
+    
+    // Self-healing placement: CPU of each pinned worker, outliers moved off
+    // theirs; null when off
+    std::unique_ptr<PlacementHealer> m_healer;
+    mutable std::mutex m_healer_mutex;  // Guards the healer and the list below
+    struct HealRecord {
+        int64_t time;  // Unix seconds
+        PlacementHealer::Decision decision;
+    };
+    std::deque<HealRecord> m_heal_log;  // Latest decisions, for the API
+    std::thread m_heal_thread;
     std::thread m_stratum_thread;
     std::thread m_stats_thread;
     
@@ -116,6 +250,58 @@ private:
     // Statistics
     MinerStats m_stats;
     
+    // Prometheus metrics: lock-free counters and histograms, read by /metrics
+    struct PoolShares {
+        std::atomic<uint64_t> accepted{0};
+        std::atomic<uint64_t> rejected{0};
+    };
+    std::unique_ptr<PoolShares[]> m_pool_shares;  // One per configured pool
+    std::atomic<uint64_t> m_reconnects{0};        // Sessions established after the first
+    std::atomic<int64_t> m_job_received_ns{0};    // steady_clock time of the last new job
+    utils::Histogram m_job_switch_seconds{0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1.0};
+    utils::Histogram m_batch_seconds{0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5};
+    // Last SystemMonitor readings from the stats thread, NaN when unavailable;
+    // a scrape must not take its own RAPL sample
+    std::atomic<double> m_cpu_temp{std::numeric_limits<double>::quiet_NaN()};
+    std::atomic<double> m_cpu_power{std::numeric_limits<double>::quiet_NaN()};
+    std::atomic<double> m_gpu_power{std::numeric_limits<double>::quiet_NaN()};
+    
+    // Hardware counters (perf_counters): each worker adds its counts and
+    // hashes after every range; the stats thread turns them into rates
+    struct ThreadPerf {
+        std::atomic<uint64_t> cycles{0};
+        std::atomic<uint64_t> instructions{0};
+        std::atomic<uint64_t> branch_misses{0};
+        std::atomic<uint64_t> l1d_misses{0};
+        std::atomic<uint64_t> ref_cycles{0};
+        std::atomic<uint64_t> running_ns{0};
+        std::atomic<uint64_t> hashes{0};
+    };
+    struct PerfView {  // One thread over the last stats interval; NaN if not counted
+        double ipc;
+        double ghz;
+        double freq_ratio;            // Actual over nominal clock: below 1 is throttling
+        double cycles_per_hash;
+        double mispredicts_per_hash;
+        double l1d_misses_per_hash;
+    };
+    std::unique_ptr<ThreadPerf[]> m_thread_perf;  // MinerStats::MAX_THREADS slots, if enabled
+    std::atomic<uint32_t> m_perf_available{0};    // PerfCounters::available() bits seen
+    std::atomic<bool> m_perf_warned{false};
+    std::mutex m_perf_mutex;                      // Guards the two below
+    std::string m_perf_error;                     // Why counters could not be opened
+    std::vector<PerfView> m_perf_view;
+    std::vector<std::array<uint64_t, 7>> m_perf_last;  // Stats thread: totals at the last interval
+    
+    // Stats segment for bloxminer-stat, updated by the stats thread
+    utils::SharedStatsWriter m_shared_stats;
+    
+    // Binary post-mortem journal; recorded at event points, never per scan
+    utils::Journal m_journal;
+    
+    // Live events for /events; outlives the API server that streams it
+    utils::EventBus m_events{1024};
+    
     // API Server
     utils::ApiServer m_api_server;
     
@@ -123,15 +309,29 @@ private:
     void mining_thread(uint32_t thread_id);
     void stratum_thread();
     void stats_thread();
+    void update_perf_view();
+    void governor_thread();
+    void background_thread();
+    void heal_thread();
+    void probe_thread();
+    void probe_pools();
+    void update_pool();
+    
+    void apply_placement(uint32_t thread_id);
+    std::vector<int> placement_cpus() const;
     
     void on_new_job(const stratum::Job& job);
-    void on_share_result(bool accepted, const std::string& reason);
+    void on_share_result(bool accepted, const std::string& reason, double rtt_ms, double difficulty);
     void submit_share(const stratum::Job& job, uint32_t nonce, const std::string& solution);
-    
-    bool check_hash(const uint8_t* hash, const uint8_t* target);
+    void replay_buffered_shares();
+    std::string current_pool_key() const;
+    void log_suggestion(double difficulty);
+
     
     // API methods
     std::string get_api_stats_json();
+    std::string get_metrics_text();
+    int handle_control(const std::string& action, const std::string& body, std::string& response);
 };
 
 }  // namespace bloxminer
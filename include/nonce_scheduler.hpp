@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace bloxminer {
+
+/**
+ * Work-stealing scheduler for the 32-bit mining nonce space
+ *
+ * reset() splits the space into one contiguous range per worker. A worker
+ * takes chunks from the front of its own range; when that is empty it
+ * steals the back half of the largest remaining range and continues from
+ * there, so a slow or descheduled worker never leaves holes behind.
+ * Chunk length follows each worker's measured rate, so a chunk takes about
+ * the target wall time on any core.
+ *
+ * Every call carries the job epoch; a worker still holding an older job
+ * gets nothing and is not handed ranges that belong to the new one.
+ * A job left for another can be suspended and later resumed under a new
+ * epoch, continuing with the nonces it had not handed out yet.
+ */
+class NonceScheduler {
+public:
+    static constexpr uint32_t MAX_WORKERS = 256;
+    static constexpr uint64_t NONCE_SPACE = 1ULL << 32;
+    static constexpr uint64_t MIN_CHUNK = 1024;
+    static constexpr uint64_t MAX_CHUNK = 1ULL << 24;
+    static constexpr uint64_t INITIAL_CHUNK = 0x10000;
+
+    struct Range {
+        uint64_t begin = 0;
+        uint64_t end = 0;      // Exclusive
+        uint64_t pass = 0;     // Times the space has been restarted for this epoch
+        uint64_t size() const { return end - begin; }
+    };
+
+    /**
+     * What is left of a suspended epoch
+     */
+    struct Progress {
+        std::vector<Range> ranges;  // Not handed out yet
+        uint64_t pass = 0;
+    };
+
+    /**
+     * @param target_ms  Wall time each chunk should take
+     * @param space      Nonces per job (the full 32-bit space unless testing)
+     */
+    explicit NonceScheduler(uint32_t target_ms = 50, uint64_t space = NONCE_SPACE);
+
+    NonceScheduler(const NonceScheduler&) = delete;
+    NonceScheduler& operator=(const NonceScheduler&) = delete;
+
+    void set_target_ms(uint32_t target_ms);
+
+    /**
+     * Start a new job: split the space between num_workers workers
+     * Ranges still held for older epochs are abandoned.
+     */
+    void reset(uint64_t epoch, uint32_t num_workers);
+
+    /**
+     * Snapshot the ranges of an epoch that no worker has taken yet
+     * Ranges workers are scanning are not included; hand their unscanned
+     * tails back to the caller's copy instead. Empty if epoch is not current.
+     */
+    Progress suspend(uint64_t epoch);
+
+    /**
+     * Start a new epoch from saved progress instead of the full space
+     * The largest ranges seed the workers' slots; the rest are handed out
+     * as those drain, before the space is restarted.
+     */
+    void resume(uint64_t epoch, uint32_t num_workers, const Progress& progress);
+
+    /**
+     * Change the worker count without restarting the current job
+     * New workers start by stealing. Shrinking takes effect at the next
+     * reset(), so ranges left in retired workers' slots are still stolen.
+     */
+    void resize(uint32_t num_workers);
+
+    /**
+     * Next contiguous range for a worker, stealing if its own is empty
+     * Restarts the space (pass + 1) once every range has been handed out.
+     * @return false if epoch is no longer current
+     */
+    bool acquire(uint32_t worker, uint64_t epoch, Range& out);
+
+    /**
+     * Hand back the unscanned tail of an acquired range (worker retiring
+     * mid-range) so other workers can steal it
+     * @return false if it could not be rejoined and will be skipped this pass
+     */
+    bool release(uint32_t worker, uint64_t epoch, const Range& range);
+
+    /**
+     * Feed back how long the worker's last range took; sets its chunk size
+     */
+    void report(uint32_t worker, uint64_t nonces, double seconds);
+
+    /**
+     * Current chunk size for a worker
+     */
+    uint64_t chunk_size(uint32_t worker) const;
+
+    uint64_t steals() const { return m_steals.load(std::memory_order_relaxed); }
+    uint64_t wraps() const { return m_wraps.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Slot {
+        std::mutex lock;
+        uint64_t epoch = 0;                        // Guarded by lock
+        uint64_t pass = 0;                         // Guarded by lock
+        uint64_t begin = 0;                        // Guarded by lock
+        uint64_t end = 0;                          // Guarded by lock
+        std::atomic<uint64_t> remaining{0};        // end - begin, for lock-free victim selection
+        std::atomic<uint64_t> chunk{INITIAL_CHUNK};
+        double rate = 0.0;                         // Nonces/s, written only by the owner
+    };
+
+    Slot m_slots[MAX_WORKERS];
+    std::atomic<uint64_t> m_epoch{0};
+    std::atomic<uint32_t> m_num_workers{0};
+    std::atomic<uint64_t> m_pass{0};
+    std::atomic<uint64_t> m_steals{0};
+    std::atomic<uint64_t> m_wraps{0};
+    std::mutex m_seed_mutex;
+    std::vector<Range> m_backlog;                  // Resumed ranges beyond one per slot; under m_seed_mutex
+    std::atomic<double> m_target_seconds;
+    const uint64_t m_space;
+
+    void seed(uint64_t epoch, uint64_t pass, uint32_t num_workers);
+    bool steal(uint32_t worker, uint64_t epoch, Range& out);
+    bool take_front(Slot& slot, uint64_t epoch, uint64_t chunk, Range& out);
+};
+
+}  // namespace bloxminer
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace bloxminer {
+
+/**
+ * Finds pinned workers that stay slower than the rest and moves them
+ *
+ * Each interval the miner passes every worker's hashrate over that
+ * interval. A worker below the median by more than the threshold for
+ * `confirmations` intervals in a row is an outlier: its core is shared with
+ * an interrupt-heavy device, a busy SMT sibling or another process, or it
+ * runs hotter and clocks lower. The healer then moves the worker to a CPU
+ * no worker uses and stops using the old one. With no spare CPU, it retires
+ * the worker if it mines less than `retire_below` of the median (the
+ * highest-numbered worker's CPU goes to it, since the pool shrinks from
+ * the top). A worker that is only somewhat slow still adds hashes, so it
+ * is kept and reported once.
+ *
+ * One worker is acted on per interval, so the median it is measured
+ * against stays meaningful. A worker that is still slow after a move is
+ * kept where it is: the core was not the cause.
+ */
+class PlacementHealer {
+public:
+    struct Options {
+        double threshold = 0.10;       // Fraction below the median that counts as slow
+        uint32_t confirmations = 3;    // Slow intervals in a row before acting
+        double retire_below = 0.5;     // Without a spare CPU, retire only below this fraction of the median
+        uint32_t min_threads = 1;      // Never retire below this many workers
+    };
+
+    enum class Action { Move, Retire, Keep };
+
+    struct Decision {
+        Action action;
+        uint32_t thread;
+        int from_cpu;
+        int to_cpu;        // Move: the spare CPU; Retire: CPU taken over from the retired top worker, or -1
+        double hashrate;   // Worker's H/s over the last interval
+        double median;     // Median H/s of all workers over the same interval
+        bool was_moved;    // Keep: already moved once, so the CPU was not the cause
+    };
+
+    /**
+     * Smallest number of measured workers worth comparing
+     */
+    static constexpr uint32_t MIN_WORKERS = 4;
+
+    /**
+     * @param cpus  CPUs workers may be pinned to, worker i on cpus[i] to start
+     */
+    PlacementHealer(const std::vector<int>& cpus, const Options& options);
+
+    /**
+     * Start over on a new CPU list: nothing is excluded any more
+     */
+    void reset(const std::vector<int>& cpus);
+
+    /**
+     * Pool size changed: workers keep their CPUs, new ones take the first
+     * unused CPUs, and slow-interval counts start over
+     */
+    void resize(uint32_t workers);
+
+    /**
+     * Feed one interval's hashrates for workers [0, n); NaN for a worker
+     * that was not measured. Ignored unless n matches the pool size.
+     * @return At most one decision
+     */
+    std::vector<Decision> update(const std::vector<double>& hashrates);
+
+    /**
+     * CPU for a worker, or -1 if it has none (more workers than CPUs)
+     */
+    int cpu_for(uint32_t thread) const;
+
+    /**
+     * Usable CPUs: workers beyond this many would have no CPU of their own
+     */
+    uint32_t allowed() const { return static_cast<uint32_t>(m_cpus.size() - m_excluded.size()); }
+
+    uint32_t workers() const { return static_cast<uint32_t>(m_assigned.size()); }
+    const std::vector<int>& cpus() const { return m_cpus; }
+    const std::vector<int>& excluded() const { return m_excluded; }
+    uint64_t moves() const { return m_moves; }
+    uint64_t retired() const { return m_retired; }
+
+    static const char* action_name(Action action);
+
+private:
+    struct Worker {
+        uint32_t strikes = 0;     // Slow intervals in a row
+        uint32_t settle = 0;      // Intervals to skip after a move (mixed old and new CPU)
+        bool moved = false;       // Already moved once
+        bool reported = false;    // Keep decision already issued for this slow spell
+    };
+
+    bool in_use(int cpu) const;
+    bool is_excluded(int cpu) const;
+    int spare_cpu() const;
+
+    Options m_options;
+    std::vector<int> m_cpus;
+    std::vector<int> m_excluded;   // CPUs given up, in the order they were
+    std::vector<int> m_assigned;   // CPU of each worker, -1 if none
+    std::vector<Worker> m_workers;
+    uint64_t m_moves = 0;
+    uint64_t m_retired = 0;
+};
+
+}  // namespace bloxminer
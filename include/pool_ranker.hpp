@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bloxminer {
+
+/**
+ * Ranks the configured pools by measured latency and decides when to move
+ *
+ * Each probe round records, per pool, the TCP connect time and the stratum
+ * round trip (mining.subscribe to its reply) of a short-lived probe
+ * connection. Both are smoothed with an EWMA; the stratum round trip is
+ * the score, since that is what delays every job and share. A pool that
+ * fails max_failures probes in a row is unhealthy and drops below every
+ * healthy one.
+ *
+ * Moving costs a reconnect and the work in flight, so a challenger must
+ * beat the current pool by both margin_ms and margin (a fraction of the
+ * current score) on `confirmations` consecutive rounds before evaluate()
+ * returns it.
+ */
+class PoolRanker {
+public:
+    struct Options {
+        double margin_ms = 10.0;
+        double margin = 0.2;
+        uint32_t confirmations = 3;
+        uint32_t max_failures = 2;
+        double alpha = 0.3;   // EWMA weight of the newest sample
+    };
+
+    struct Entry {
+        double connect_ms = 0.0;   // EWMA of TCP connect time
+        double rtt_ms = 0.0;       // EWMA of stratum round trip; the score
+        double submit_ms = 0.0;    // Share submit round trip, as last seen while in use
+        uint64_t probes = 0;       // Successful probes
+        uint32_t failures = 0;     // Consecutive failed probes
+    };
+
+    PoolRanker(size_t num_pools, const Options& options);
+
+    /**
+     * Record one probe; connect_ms and rtt_ms are ignored when !ok
+     */
+    void record_probe(size_t pool, bool ok, double connect_ms, double rtt_ms);
+
+    /**
+     * Record the (already smoothed) submit round trip of the active connection
+     * Reported only: it includes the pool's share validation, which probes don't
+     */
+    void record_submit(size_t pool, double ms);
+
+    /**
+     * Pool indices best first: healthy by score, then pools that have failed or
+     * not been measured yet, each in config order
+     */
+    std::vector<size_t> ranking() const;
+
+    /**
+     * Call once per probe round with the pool in use
+     * @return The pool to move to, or current to stay
+     */
+    size_t evaluate(size_t current);
+
+    /**
+     * Best pool other than current, for failover
+     */
+    size_t next_after_failure(size_t current) const;
+
+    /**
+     * Measured, and fewer than max_failures failed probes in a row
+     */
+    bool healthy(size_t pool) const;
+
+    const Entry& entry(size_t pool) const { return m_entries[pool]; }
+    size_t size() const { return m_entries.size(); }
+
+private:
+    Options m_options;
+    std::vector<Entry> m_entries;
+    size_t m_challenger = SIZE_MAX;   // Pool that beat the current one last round
+    uint32_t m_challenger_rounds = 0;
+
+    bool beats(size_t candidate, size_t current) const;
+};
+
+}  // namespace bloxminer
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+
+namespace bloxminer {
+
+/**
+ * Sheds and restores background mining workers from CPU pressure (PSI)
+ *
+ * Each reading comes in two parts, both percentages of one poll:
+ * - foreground: time other tasks waited for a CPU (/proc/pressure/cpu
+ *   "some" less the miner's own share of it). At or above the high mark
+ *   the allowed worker count is halved on every reading, so a busy
+ *   foreground gets its cores back within a few polls.
+ * - own: time the miner's workers waited, on each other or on cores the
+ *   foreground holds. Above the low mark there are more workers than free
+ *   cores, so one worker is shed per reading until the wait is gone.
+ *
+ * Workers come back one at a time after both have stayed at or below the
+ * low mark for the recovery time. Going back above a count at which the
+ * workers last contended is a probe: it waits twice as long after each
+ * probe that failed, so a count that fits is held instead of being
+ * retried every recovery time.
+ *
+ * It also accounts for what shedding cost and bought: worker-seconds and
+ * hashes given up, and stall time avoided relative to the pressure that
+ * triggered the shed.
+ */
+class PressureController {
+public:
+    struct Stats {
+        double pressure = 0.0;             // Last foreground reading, %
+        double own_pressure = 0.0;         // Last reading of the workers' own wait, %
+        uint32_t allowed = 0;              // Workers allowed to run
+        uint32_t ceiling = 0;              // Count the workers last fitted at without contending
+        uint64_t shed_events = 0;          // Readings that reduced allowed
+        double worker_seconds_shed = 0.0;
+        double hashes_forgone = 0.0;       // Estimated from the per-worker hashrate
+        double stall_avoided = 0.0;        // Seconds, estimated
+    };
+
+    /**
+     * Longest wait before a probe, in recovery times
+     */
+    static constexpr uint32_t MAX_PROBE_BACKOFF = 64;
+
+    /**
+     * @param max_threads  Configured pool size
+     * @param high         Foreground pressure (%) that sheds workers
+     * @param low          Pressure (%) below which workers are restored
+     * @param recover_ms   Time below low before each worker is restored
+     * @param min_threads  Workers that are never shed
+     */
+    PressureController(uint32_t max_threads, double high, double low, uint32_t recover_ms,
+                       uint32_t min_threads = 1);
+
+    /**
+     * Feed one reading covering the last dt seconds
+     * @param pressure         Foreground pressure, %
+     * @param own_pressure     The workers' own run-queue wait, %
+     * @param thread_hashrate  Current H/s of one worker, for hashes_forgone
+     * @return Workers allowed to run
+     */
+    uint32_t update(double pressure, double own_pressure, double dt, double thread_hashrate);
+
+    /**
+     * Change the pool size (e.g. resized via the API); restores every worker
+     */
+    void set_max_threads(uint32_t max_threads);
+
+    uint32_t allowed() const { return m_stats.allowed; }
+    const Stats& stats() const { return m_stats; }
+
+private:
+    uint32_t m_max_threads;
+    uint32_t m_min_threads;
+    double m_high;
+    double m_low;
+    double m_recover_seconds;
+
+    double m_calm_seconds = 0.0;       // Time pressure has been at or below low
+    double m_trigger_pressure = 0.0;   // Highest reading since workers were last all running
+    uint32_t m_backoff = 1;            // Recovery times to wait before the next probe
+    bool m_probing = false;            // Last restore went above the ceiling
+    Stats m_stats;
+};
+
+}  // namespace bloxminer
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "stratum/stratum_client.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace bloxminer {
+
+/**
+ * Holds shares found while the pool connection is down, for replay
+ *
+ * A share stays valid across a reconnect only if the new session hashes
+ * the same header: same pool, same extranonce1 (the pool's nonce prefix is
+ * inside the hashed nonce), and the same block (prev_hash). Anything else
+ * is dropped at replay time, as are shares older than max_age and the
+ * oldest shares once the buffer is full.
+ */
+class ShareBuffer {
+public:
+    struct Pending {
+        stratum::Share share;
+        std::string pool;          // host:port it was mined for
+        std::string extranonce1;   // Session it was mined in
+        std::string prev_hash;     // Block it was mined on
+        std::chrono::steady_clock::time_point found;
+    };
+
+    struct Stats {
+        uint64_t buffered = 0;         // Shares queued while disconnected
+        uint64_t replayed = 0;
+        uint64_t dropped_full = 0;     // Evicted by newer shares
+        uint64_t dropped_stale = 0;    // Older than max_age, or the block moved on
+        uint64_t dropped_session = 0;  // Different pool or extranonce1 after reconnect
+    };
+
+    ShareBuffer(size_t capacity, uint32_t max_age_seconds);
+
+    /**
+     * Queue a share; evicts the oldest when full
+     */
+    void push(Pending pending);
+
+    /**
+     * Empty the buffer after re-subscribing
+     * @return Shares still valid for this session and block, oldest first;
+     *         the rest are counted as dropped
+     */
+    std::vector<stratum::Share> take(const std::string& pool, const std::string& extranonce1,
+                                     const std::string& prev_hash,
+                                     std::chrono::steady_clock::time_point now);
+
+    size_t size() const { return m_pending.size(); }
+    const Stats& stats() const { return m_stats; }
+
+private:
+    size_t m_capacity;
+    std::chrono::seconds m_max_age;
+    std::deque<Pending> m_pending;
+    Stats m_stats;
+};
+
+}  // namespace bloxminer
@@ -8,6 +8,13 @@
 #include <functional>
 #include <cstdint>
 #include <thread>
+#include <chrono>
+#include <unordered_map>
+#include <sys/types.h>
+
+#include "../utils/metrics.hpp"
+
+struct ssl_st;  // OpenSSL SSL
 
 namespace bloxminer {
 namespace stratum {
@@ -31,6 +38,7 @@ struct Job {
     std::string solution;            // Solution template from pool
     
     // Parsed/computed fields
+    std::string extranonce1;    // Session prefix hashed into header's nNonce
     uint8_t header[256];        // Constructed block header (up to 140 bytes for Verus)
     size_t header_len;          // Actual header length
     uint8_t target[32];         // Target hash for share validation
@@ -48,6 +56,20 @@ struct Share {
     std::string ntime;
     uint32_t nonce;
     std::string solution;       // Verus: full solution with nonce embedded
+    double difficulty = 0.0;    // Of the job it was found on; handed back with the result
+};
+
+/**
+ * Where the time of the last connect() + handshake() went, ms
+ */
+struct ConnectTiming {
+    double dns_ms = 0.0;
+    bool dns_cached = false;
+    double connect_ms = 0.0;     // TCP, first address to answer
+    bool tls = false;
+    bool tls_resumed = false;    // Session ticket accepted: abbreviated handshake
+    double tls_ms = 0.0;
+    double handshake_ms = 0.0;   // Pipelined subscribe + authorize
 };
 
 /**
@@ -56,7 +78,10 @@ struct Share {
 class StratumClient {
 public:
     using JobCallback = std::function<void(const Job&)>;
-    using ShareCallback = std::function<void(bool accepted, const std::string& reason)>;
+    // rtt_ms is submit to response and difficulty the share's; both 0 for a response to a
+    // submit not seen on this connection
+    using ShareCallback = std::function<void(bool accepted, const std::string& reason, double rtt_ms,
+                                             double difficulty)>;
     using ErrorCallback = std::function<void(const std::string& error)>;
     
     StratumClient();
@@ -64,11 +89,17 @@ public:
     
     /**
      * Connect to mining pool
+     * Addresses are cached for a few minutes; all of them are tried, IPv6 and
+     * IPv4 interleaved and staggered by 250 ms, and the first to connect wins.
+     * With tls, the session ticket from the last connection to the same
+     * host:port is offered, so a reconnect skips the full handshake.
      * @param host Pool hostname
      * @param port Pool port
+     * @param tls Speak stratum+ssl
+     * @param tls_verify Check the certificate chain and hostname
      * @return true if connected
      */
-    bool connect(const std::string& host, uint16_t port);
+    bool connect(const std::string& host, uint16_t port, bool tls = false, bool tls_verify = true);
     
     /**
      * Disconnect from pool
@@ -76,24 +107,49 @@ public:
     void disconnect();
     
     /**
-     * Authorize with pool
+     * Make a blocked run() return without reporting a lost connection
+     * Safe from any thread; call disconnect() from the run() thread afterwards.
+     */
+    void interrupt();
+    
+    /**
+     * Measure a pool's latency over a short-lived connection of its own
+     * Times the TCP connect, then mining.subscribe to its reply, and closes.
+     * TLS pools get a full handshake first, which is not counted in either.
+     * @param timeout_ms Limit for each step
+     * @return true if all completed in time
+     */
+    static bool probe(const std::string& host, uint16_t port, uint32_t timeout_ms,
+                      double& connect_ms, double& rtt_ms, bool tls = false, bool tls_verify = true);
+    
+    /**
+     * Subscribe to mining notifications and authorize, in one round trip
+     * Both requests are sent back-to-back and the replies matched by id.
      * @param username Wallet address or username
      * @param password Worker password (usually "x")
-     * @return true if authorized
+     * @param suggest  Share difficulty to request in the same write; 0 for none
+     * @return true if subscribed and authorized
+     */
+    bool handshake(const std::string& username, const std::string& password, double suggest = 0.0);
+    
+    /**
+     * Ask the pool for a share difficulty (mining.suggest_difficulty)
+     * The pool may ignore it; its reply is not counted as a share result.
+     * @return false if not connected or the send failed
      */
-    bool authorize(const std::string& username, const std::string& password);
+    bool suggest_difficulty(double difficulty);
     
     /**
-     * Subscribe to mining notifications
-     * @return true if subscribed
+     * Phase timings of the last connect() and handshake()
      */
-    bool subscribe();
+    const ConnectTiming& last_connect_timing() const { return m_timing; }
     
     /**
      * Submit a share to the pool
      * @param share Share to submit
+     * @return false if it never left: not connected, or the send failed
      */
-    void submit_share(const Share& share);
+    bool submit_share(const Share& share);
     
     /**
      * Set callback for new jobs
@@ -140,6 +196,22 @@ public:
      */
     const uint8_t* get_pool_target() const { return m_pool_target; }
     
+    /**
+     * TLS handshakes completed, and how many of them resumed a session
+     */
+    uint64_t tls_handshakes() const { return m_tls_handshakes; }
+    uint64_t tls_resumptions() const { return m_tls_resumptions; }
+    
+    /**
+     * Smoothed round trip of mining.submit on this connection, ms (0 until a reply)
+     */
+    double get_submit_rtt_ms() const { return m_submit_rtt_ms; }
+    
+    /**
+     * Distribution of mining.submit round trips, seconds, since start
+     */
+    const utils::Histogram& submit_rtt_histogram() const { return m_submit_rtt_hist; }
+    
     /**
      * Run the receive loop (blocks)
      */
@@ -154,6 +226,14 @@ private:
     // Socket
     int m_socket;
     std::atomic<bool> m_connected;
+    
+    // TLS: null for plaintext. The socket stays non-blocking and every
+    // SSL call holds m_ssl_mutex, so run() and submitting threads can share it.
+    ssl_st* m_ssl = nullptr;
+    std::mutex m_ssl_mutex;
+    std::string m_tls_key;  // host:port the session tickets are stored under
+    std::atomic<uint64_t> m_tls_handshakes{0};
+    std::atomic<uint64_t> m_tls_resumptions{0};
     std::atomic<bool> m_running;
     
     // Pool info
@@ -164,14 +244,29 @@ private:
     // Stratum state
     std::string m_extranonce1;
     size_t m_extranonce2_size;
+    std::string m_session_id;    // mining.notify subscription id, offered back on reconnect
+    std::string m_session_pool;  // host:port it was issued by
     std::string m_recv_buffer;
+    ConnectTiming m_timing;
     std::atomic<double> m_difficulty;
     std::atomic<uint64_t> m_message_id;
+    std::atomic<uint64_t> m_suggest_id{0};  // Last mining.suggest_difficulty request
     
     // Pool-provided target (from mining.set_target)
     uint8_t m_pool_target[32];
     std::atomic<bool> m_has_pool_target;
     
+    // Share submits awaiting an answer, by request id: send time for the
+    // round trip, difficulty for the result
+    struct PendingSubmit {
+        std::chrono::steady_clock::time_point sent;
+        double difficulty;
+    };
+    std::unordered_map<uint64_t, PendingSubmit> m_pending_submits;
+    std::mutex m_pending_mutex;
+    std::atomic<double> m_submit_rtt_ms;
+    utils::Histogram m_submit_rtt_hist{0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0};
+    
     // Thread safety
     std::mutex m_send_mutex;
     std::mutex m_job_mutex;
@@ -183,8 +278,13 @@ private:
     
     // Internal methods
     bool send_message(const std::string& message);
+    bool start_tls(const std::string& host, bool verify);
+    ssize_t read_some(char* buf, size_t len);
     std::string receive_line();
     void process_message(const std::string& message);
+    void parse_subscribe_result(const std::string& response);
+    std::string suggest_message(double difficulty);
+    static bool authorize_succeeded(const std::string& response);
     void handle_notification(const std::string& method, const std::string& params);
     void handle_response(uint64_t id, bool success, const std::string& result, const std::string& error);
     void parse_job(const std::string& params);
@@ -3,177 +3,192 @@
 #include <string>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <functional>
-#include <sstream>
-#include <cstring>
-#include <unistd.h>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "event_bus.hpp"
 
 namespace bloxminer {
 namespace utils {
 
 /**
- * Simple HTTP API server for miner stats
- * Provides JSON endpoint at /api/stats
+ * HTTP API server for miner stats
+ * Provides JSON endpoint at /api/stats, Prometheus text at /metrics when a
+ * metrics callback is installed, and POST /api/control/<action> when a
+ * control callback is installed, and a Server-Sent Events stream at /events
+ * when an event bus is attached
+ *
+ * One thread multiplexes every client with epoll: sockets are non-blocking,
+ * connections are kept alive (requests may be pipelined) and each one is
+ * closed when it idles or stalls past its deadline, so a slow client cannot
+ * hold up the others. Stats are served from a snapshot the miner publishes
+ * once per stats interval; a request sends that buffer as it is, without
+ * rendering or copying it. Control requests run one at a time on a thread
+ * of their own, since resizing the pool waits for workers; the connection
+ * is answered when the action finishes and everyone else is served
+ * meanwhile.
  */
 class ApiServer {
 public:
     using StatsCallback = std::function<std::string()>;
-    
+    // (action, request body, response JSON) -> HTTP status code
+    using ControlCallback = std::function<int(const std::string&, const std::string&, std::string&)>;
+
+    static constexpr size_t MAX_CONNECTIONS = 64;
+    static constexpr size_t MAX_REQUEST_BYTES = 8192;     // Headers plus body
+    static constexpr int REQUEST_TIMEOUT_MS = 5000;       // First byte to complete request
+    static constexpr int WRITE_TIMEOUT_MS = 5000;         // Response start to last byte sent
+    static constexpr int IDLE_TIMEOUT_MS = 15000;         // Keep-alive between requests; stream heartbeat
+    static constexpr int CONTROL_TIMEOUT_MS = 30000;      // Control request to its action finishing
+    static constexpr size_t STREAM_BATCH = 256;           // Events per write to one stream
+
     ApiServer() = default;
     ~ApiServer() { stop(); }
-    
+
+    ApiServer(const ApiServer&) = delete;
+    ApiServer& operator=(const ApiServer&) = delete;
+
+    /**
+     * Enable the control endpoints; call before start()
+     */
+    void set_control_callback(ControlCallback control_callback) {
+        m_control_callback = control_callback;
+    }
+
+    /**
+     * Serve /metrics from this callback; call before start()
+     */
+    void set_metrics_callback(StatsCallback metrics_callback) {
+        m_metrics_callback = metrics_callback;
+    }
+
+    /**
+     * Stream this bus's events at /events; call before start()
+     */
+    void set_event_bus(EventBus* bus) {
+        m_event_bus = bus;
+    }
+
+    /**
+     * Replace the stats snapshot; safe from any thread
+     * Responses already being sent keep the buffer they started with.
+     */
+    void publish(std::string stats_json);
+
     /**
      * Start the API server
-     * @param port Port to listen on (default 4068)
-     * @param stats_callback Function that returns JSON stats string
+     * @param port Port to listen on (default 4068; 0 picks a free port)
+     * @param stats_callback Renders stats until the first publish()
      * @param bind_address Address to bind to (default 127.0.0.1 for security)
      * @return true if started successfully
      */
-    bool start(uint16_t port, StatsCallback stats_callback, const std::string& bind_address = "127.0.0.1") {
-        if (m_running) return true;
-
-        m_port = port;
-        m_stats_callback = stats_callback;
-        m_bind_address = bind_address;
-
-        // Create socket
-        m_socket = socket(AF_INET, SOCK_STREAM, 0);
-        if (m_socket < 0) {
-            return false;
-        }
-
-        // Allow address reuse
-        int opt = 1;
-        setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-
-        // Bind to specified address (default localhost for security)
-        struct sockaddr_in addr;
-        memset(&addr, 0, sizeof(addr));
-        addr.sin_family = AF_INET;
-        if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) <= 0) {
-            // Fallback to localhost if parse fails
-            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
-        }
-        addr.sin_port = htons(port);
-        
-        if (bind(m_socket, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-            close(m_socket);
-            m_socket = -1;
-            return false;
-        }
-        
-        // Listen
-        if (listen(m_socket, 5) < 0) {
-            close(m_socket);
-            m_socket = -1;
-            return false;
-        }
-        
-        m_running = true;
-        m_thread = std::thread(&ApiServer::server_thread, this);
-        
-        return true;
-    }
-    
-    void stop() {
-        if (!m_running) return;
-        
-        m_running = false;
-        
-        // Close socket to unblock accept()
-        if (m_socket >= 0) {
-            shutdown(m_socket, SHUT_RDWR);
-            close(m_socket);
-            m_socket = -1;
-        }
-        
-        if (m_thread.joinable()) {
-            m_thread.join();
-        }
-    }
-    
+    bool start(uint16_t port, StatsCallback stats_callback, const std::string& bind_address = "127.0.0.1");
+
+    void stop();
+
     uint16_t port() const { return m_port; }
     bool is_running() const { return m_running; }
-    
+    size_t connections() const { return m_connection_count; }
+
 private:
-    void server_thread() {
-        while (m_running) {
-            struct sockaddr_in client_addr;
-            socklen_t client_len = sizeof(client_addr);
-            
-            int client = accept(m_socket, (struct sockaddr*)&client_addr, &client_len);
-            if (client < 0) {
-                if (m_running) {
-                    // Error, but keep trying
-                    continue;
-                }
-                break;  // Shutdown
-            }
-            
-            handle_client(client);
-            close(client);
-        }
-    }
-    
-    void handle_client(int client) {
-        char buffer[4096];
-        ssize_t n = recv(client, buffer, sizeof(buffer) - 1, 0);
-        if (n <= 0) return;
-        
-        buffer[n] = '\0';
-        
-        // Parse request (very simple)
-        std::string request(buffer);
-        
+    using Clock = std::chrono::steady_clock;
+
+    struct Connection {
+        std::string in;                            // Bytes received, not yet answered
+        std::string head;                          // Status line and headers being sent
+        std::shared_ptr<const std::string> body;   // Snapshot or rendered body being sent
+        size_t sent = 0;                           // Of head + body
+        bool writing = false;
+        uint32_t events = 0;                       // Registered epoll events
+        bool close_after = false;                  // Client asked to close, or HTTP/1.0
+        bool eof = false;                          // Client shut down its side
+        bool stream = false;                       // Subscribed to /events
+        uint64_t cursor = 0;                       // Next event id for a stream
+        uint64_t serial = 0;                       // Tells a reused fd from the client it had
+        bool controlling = false;                  // Waiting for a control action to finish
+        Clock::time_point deadline;
+    };
+
+    // A control request handed to the control thread, and its answer
+    struct ControlCall {
+        int fd;
+        uint64_t serial;
+        std::string action;
+        std::string body;
+        int status = 0;
         std::string response;
-        std::string content_type = "application/json";
-        
-        if (request.find("GET /api/stats") != std::string::npos ||
-            request.find("GET /summary") != std::string::npos ||
-            request.find("GET / ") != std::string::npos) {
-            // Return stats JSON
-            response = m_stats_callback ? m_stats_callback() : "{}";
-        } else if (request.find("GET /health") != std::string::npos) {
-            response = R"({"status":"ok"})";
-        } else {
-            // 404
-            std::string body = R"({"error":"not found","endpoints":["/api/stats","/health"]})";
-            std::stringstream ss;
-            ss << "HTTP/1.1 404 Not Found\r\n"
-               << "Content-Type: application/json\r\n"
-               << "Content-Length: " << body.length() << "\r\n"
-               << "Connection: close\r\n"
-               << "Access-Control-Allow-Origin: *\r\n"
-               << "\r\n"
-               << body;
-            std::string http_response = ss.str();
-            send(client, http_response.c_str(), http_response.length(), 0);
-            return;
-        }
-        
-        // Build HTTP response
-        std::stringstream ss;
-        ss << "HTTP/1.1 200 OK\r\n"
-           << "Content-Type: " << content_type << "\r\n"
-           << "Content-Length: " << response.length() << "\r\n"
-           << "Connection: close\r\n"
-           << "Access-Control-Allow-Origin: *\r\n"
-           << "\r\n"
-           << response;
-        
-        std::string http_response = ss.str();
-        send(client, http_response.c_str(), http_response.length(), 0);
-    }
-    
+    };
+
+    // Parsed request; path has its query string removed
+    struct Request {
+        std::string method;
+        std::string path;
+        std::string body;
+        std::string last_event_id;                 // EventSource reconnect
+        bool keep_alive = true;
+    };
+
+    void server_thread();
+    void accept_clients();
+    bool on_readable(Connection& conn, int fd);
+
+    /**
+     * Send what is queued, then answer buffered requests in order until the
+     * socket would block or the input runs out
+     * @return false if the connection should be closed
+     */
+    bool serve(Connection& conn, int fd);
+    void respond(Connection& conn, int fd, const Request& request);
+    void open_stream(Connection& conn, const Request& request);
+
+    /**
+     * Queue the stream's next batch of events, if any
+     * @return true if something was queued
+     */
+    bool pump(Connection& conn);
+    void on_events();
+    void control_thread();
+    void on_control_done();
+    void queue_chunk(Connection& conn, std::string data);
+    void queue(Connection& conn, int status, const char* content_type,
+               std::shared_ptr<const std::string> body, bool cors);
+    void watch(Connection& conn, int fd, bool writing);
+    void close_connection(int fd);
+
+    // 1 parsed, 0 incomplete, -1 malformed or too large
+    static int parse_request(std::string& in, Request& request);
+    static std::string status_text(int status);
+
     std::atomic<bool> m_running{false};
     std::thread m_thread;
     int m_socket = -1;
+    int m_epoll = -1;
+    int m_wake = -1;                               // eventfd that interrupts epoll_wait for stop()
     uint16_t m_port = 0;
     std::string m_bind_address = "127.0.0.1";
     StatsCallback m_stats_callback;
+    StatsCallback m_metrics_callback;
+    ControlCallback m_control_callback;
+    EventBus* m_event_bus = nullptr;
+    std::shared_ptr<const std::string> m_not_found;  // Lists the endpoints this server has
+    std::shared_ptr<const std::string> m_snapshot; // Accessed with std::atomic_load/store
+    std::unordered_map<int, Connection> m_connections;  // Server thread only
+    std::atomic<size_t> m_connection_count{0};
+    uint64_t m_next_serial = 0;                    // Server thread only
+
+    std::thread m_control_thread;
+    std::mutex m_control_mutex;
+    std::condition_variable m_control_cv;
+    std::deque<ControlCall> m_control_queue;       // Waiting to run
+    std::vector<ControlCall> m_control_done;       // Answered, not yet queued for sending
+    int m_control_fd = -1;                         // eventfd: an answer is in m_control_done
 };
 
 }  // namespace utils
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+
+namespace bloxminer {
+namespace utils {
+
+/**
+ * Logical CPU layout from /sys/devices/system/cpu
+ * Used to place one mining thread per physical core when SMT siblings
+ * are not wanted.
+ */
+class CpuTopology {
+public:
+    /**
+     * Logical CPUs that are the first SMT sibling of their core, in order
+     * Without sysfs topology every logical CPU counts as its own core.
+     */
+    static std::vector<int> one_per_core() {
+        std::vector<int> cpus;
+        unsigned hw = std::thread::hardware_concurrency();
+        for (unsigned cpu = 0; cpu < hw; cpu++) {
+            int first = first_sibling(static_cast<int>(cpu));
+            if (first < 0 || first == static_cast<int>(cpu)) {
+                cpus.push_back(static_cast<int>(cpu));
+            }
+        }
+        return cpus;
+    }
+
+    /**
+     * Number of physical cores (logical CPUs if SMT layout is unknown)
+     */
+    static unsigned physical_cores() {
+        return static_cast<unsigned>(one_per_core().size());
+    }
+
+private:
+    // First CPU in thread_siblings_list ("0,32" or "0-1"), or -1 if unreadable
+    static int first_sibling(int cpu) {
+        std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                           "/topology/thread_siblings_list");
+        if (!file.is_open()) return -1;
+        int first = -1;
+        file >> first;
+        return file.fail() ? -1 : first;
+    }
+};
+
+}  // namespace utils
+}  // namespace bloxminer
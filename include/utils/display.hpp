@@ -8,6 +8,7 @@
 #include <chrono>
 #include <mutex>
 #include <cstdio>
+#include <cmath>
 
 namespace bloxminer {
 namespace utils {
@@ -42,36 +43,17 @@ public:
         // Pool failover info
         size_t current_pool_index = 0;
         size_t total_pools = 1;
+        // Pool-side view over the last hour; effective_hashrate < 0 until measured
+        double effective_hashrate = -1;
+        double effective_margin = 0;    // Half the 95% interval, relative
+        double effective_gap = 0;       // Effective below local, relative
+        double luck = -1;               // Shares found over expected; < 0 until expected
     };
 
     // Initialize terminal for sticky header mode
     void init(int num_threads) {
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_num_threads = num_threads;
-
-        // Calculate header lines: 7 base lines + thread lines (6 threads per line)
-        int thread_lines = (num_threads + 5) / 6;  // Ceiling division
-        m_header_lines = 7 + thread_lines;
-
-        // Clear entire screen
-        std::cout << "\033[2J";
-
-        // Move to top
-        std::cout << "\033[H";
-
-        // Reserve space for header by printing empty lines
-        for (int i = 0; i < m_header_lines; i++) {
-            std::cout << "\033[K\n";  // Clear line and newline
-        }
-
-        // SET SCROLL REGION: from (header_lines+1) to bottom of screen (999 = large number)
-        // This is the critical part - all subsequent output stays in this region
-        std::cout << "\033[" << (m_header_lines + 1) << ";999r";
-
-        // Move cursor to first line of scroll region
-        std::cout << "\033[" << (m_header_lines + 1) << ";1H";
-
-        std::cout << std::flush;
+        layout(num_threads);
         m_initialized = true;
     }
 
@@ -81,6 +63,11 @@ public:
 
         std::lock_guard<std::mutex> lock(m_mutex);
 
+        // Worker pool was resized: redraw with room for the new thread rows
+        if (static_cast<int>(stats.thread_hashrates.size()) != m_num_threads) {
+            layout(static_cast<int>(stats.thread_hashrates.size()));
+        }
+
         // Save cursor position
         std::cout << "\033[s";
 
@@ -122,6 +109,35 @@ private:
 
     static constexpr int BOX_WIDTH = 68;  // Inner width for the box
 
+    // Clear the screen and reserve the header rows; caller holds m_mutex
+    void layout(int num_threads) {
+        m_num_threads = num_threads;
+
+        // Calculate header lines: 8 base lines + thread lines (6 threads per line)
+        int thread_lines = (num_threads + 5) / 6;  // Ceiling division
+        m_header_lines = 8 + thread_lines;
+
+        // Clear entire screen
+        std::cout << "\033[2J";
+
+        // Move to top
+        std::cout << "\033[H";
+
+        // Reserve space for header by printing empty lines
+        for (int i = 0; i < m_header_lines; i++) {
+            std::cout << "\033[K\n";  // Clear line and newline
+        }
+
+        // SET SCROLL REGION: from (header_lines+1) to bottom of screen (999 = large number)
+        // This is the critical part - all subsequent output stays in this region
+        std::cout << "\033[" << (m_header_lines + 1) << ";999r";
+
+        // Move cursor to first line of scroll region
+        std::cout << "\033[" << (m_header_lines + 1) << ";1H";
+
+        std::cout << std::flush;
+    }
+
     void draw_header_absolute(const Stats& stats) {
         // ANSI color codes
         const char* CYAN = "\033[36m";
@@ -248,7 +264,34 @@ private:
                   << std::string(BOX_WIDTH - 53 > 0 ? BOX_WIDTH - 53 : 0, ' ')
                   << CYAN << V << RESET;
 
-        // Line 7: Separator before thread hashrates
+        // Line 7: Pool-side (effective) hashrate over the last hour, luck
+        std::stringstream eff_hr_ss;
+        std::stringstream gap_ss;
+        if (stats.effective_hashrate >= 0) {
+            eff_hr_ss << format_hashrate(stats.effective_hashrate) << " +-" << std::fixed << std::setprecision(0)
+                      << stats.effective_margin * 100.0 << "%";
+            gap_ss << std::fixed << std::setprecision(1) << (stats.effective_gap > 0 ? "-" : "+")
+                   << std::fabs(stats.effective_gap) * 100.0 << "%";
+        } else {
+            eff_hr_ss << "--";
+            gap_ss << "--";
+        }
+        std::stringstream luck_ss;
+        if (stats.luck >= 0) {
+            luck_ss << std::fixed << std::setprecision(0) << stats.luck * 100.0 << "%";
+        } else {
+            luck_ss << "--";
+        }
+
+        goto_row();
+        std::cout << CYAN << V << RESET
+                  << "  Pool-side 1h: " << GREEN << std::setw(20) << std::left << eff_hr_ss.str() << RESET
+                  << "  Gap: " << YELLOW << std::setw(7) << std::left << gap_ss.str() << RESET
+                  << "  Luck: " << std::setw(6) << std::left << luck_ss.str()
+                  << std::string(BOX_WIDTH - 64 > 0 ? BOX_WIDTH - 64 : 0, ' ')
+                  << CYAN << V << RESET;
+
+        // Line 8: Separator before thread hashrates
         print_hline(LT, RT);
 
         // Thread hashrate lines (6 threads per line in compact format: T00: 870K)
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bloxminer {
+namespace utils {
+
+/**
+ * Lock-free broadcast ring of miner events
+ *
+ * publish() claims a slot with one fetch_add and copies the event in under
+ * a per-slot sequence number; it never waits on a reader or another writer,
+ * so mining and stratum threads call it directly. Each subscriber reads at
+ * its own cursor, which bounds its backlog to the ring: one that falls a
+ * full ring behind loses its oldest events, never anyone else's.
+ */
+class EventBus {
+public:
+    static constexpr size_t TYPE_SIZE = 16;
+    static constexpr size_t DATA_SIZE = 232;   // JSON object; longer payloads are dropped
+
+    struct Event {
+        uint64_t id = 0;                      // Position in the stream, from 0
+        int64_t time_ms = 0;                  // Unix time
+        char type[TYPE_SIZE] = {};
+        char data[DATA_SIZE] = {};
+        uint32_t data_len = 0;
+    };
+
+    /**
+     * @param capacity Events kept for readers, rounded up to a power of two
+     */
+    explicit EventBus(size_t capacity = 1024);
+    ~EventBus();
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    /**
+     * Append an event; data is a JSON object
+     * @return false if the payload does not fit a slot
+     */
+    bool publish(const char* type, const std::string& data);
+
+    /**
+     * Copy up to max events from cursor on and advance it
+     * @param dropped Incremented by events overwritten before they were read
+     * @return Events copied; stops early at a slot still being written
+     */
+    size_t read(uint64_t& cursor, std::vector<Event>& out, size_t max, uint64_t& dropped) const;
+
+    /**
+     * Id the next event will get; a new subscriber starts here
+     */
+    uint64_t head() const { return m_head.load(std::memory_order_acquire); }
+
+    /**
+     * Oldest id still in the ring
+     */
+    uint64_t tail() const;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    /**
+     * eventfd that becomes readable after a publish while anyone subscribes
+     * Writers pay that syscall only while a stream is open.
+     */
+    int notify_fd() const { return m_notify_fd; }
+
+    /**
+     * Reset notify_fd() once woken
+     */
+    void clear_notify();
+
+    void subscribe() { m_subscribers.fetch_add(1, std::memory_order_relaxed); }
+    void unsubscribe() { m_subscribers.fetch_sub(1, std::memory_order_relaxed); }
+    uint32_t subscribers() const { return m_subscribers.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};   // 2*id+1 while writing, 2*id+2 once readable
+        Event event;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask;
+    std::atomic<uint64_t> m_head{0};
+    int m_notify_fd = -1;
+    std::atomic<uint32_t> m_subscribers{0};
+};
+
+}  // namespace utils
+}  // namespace bloxminer
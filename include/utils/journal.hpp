@@ -0,0 +1,188 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+namespace bloxminer {
+namespace utils {
+
+/**
+ * What a journal record describes; the meaning of a and b depends on it
+ */
+enum class JournalEvent : uint16_t {
+    JobReceived = 1,     // a = job generation, b = 1 if clean_jobs, +2 if resumed
+    JobPrepared = 2,     // a = job generation, b = ns since the pool's notify arrived
+    ShareFound = 3,      // a = nonce, b = job generation
+    ShareSubmitted = 4,  // a = nonce, b = 0 sent, 1 buffered, 2 replayed
+    ShareResult = 5,     // a = 1 if accepted, b = round trip in us
+    PoolConnected = 6,   // a = pool index, b = 1 if a reconnect
+    PoolLost = 7,        // a = pool index
+    PoolSwitch = 8,      // a = from, b = to
+    ThreadStall = 9,     // a = ms without a hash
+    Governor = 10,       // a = threads, b = duty in permille
+    Throttle = 11,       // a = threads, b = previous
+    Pause = 12,          // a = 1 if paused
+    Stats = 13,          // a = interval H/s, b = active threads
+    Heal = 14,           // a = 0 moved, 1 retired, 2 kept; b = from CPU << 32 | to CPU (0xffffffff: none)
+};
+
+/**
+ * One fixed-size record. The writer clears seq, fills the fields, then
+ * stores seq = index + 1 (low 32 bits), so a reader can tell a finished
+ * record from one in progress or already overwritten.
+ */
+struct JournalRecord {
+    uint64_t tsc;                // Timestamp counter when the event happened
+    std::atomic<uint32_t> seq;
+    uint16_t type;               // JournalEvent
+    uint16_t thread;             // Mining thread, or NO_THREAD
+    uint64_t a;
+    uint64_t b;
+
+    static constexpr uint16_t NO_THREAD = 0xffff;
+};
+
+static_assert(sizeof(JournalRecord) == 32, "records are a fixed 32 bytes");
+
+/**
+ * File layout: this header, then `capacity` records
+ *
+ * Two (tsc, wall clock) anchors convert timestamps: the first taken at
+ * open, the second refreshed by calibrate() as the run goes on.
+ */
+struct JournalHeader {
+    static constexpr uint32_t MAGIC = 0x4a584c42;  // "BLXJ"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_size;        // sizeof(JournalHeader)
+    uint32_t record_size;        // sizeof(JournalRecord)
+    uint64_t capacity;           // Records, a power of two
+    uint32_t pid;
+    uint32_t reserved;
+    uint64_t start_tsc;
+    int64_t start_unix_ns;
+    uint64_t anchor_tsc;
+    int64_t anchor_unix_ns;
+    alignas(64) std::atomic<uint64_t> head;  // Next index to reserve
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "journal counters are shared between processes and must not need a lock");
+
+/**
+ * A decoded record
+ */
+struct JournalEntry {
+    uint64_t index;
+    int64_t unix_ns;
+    JournalEvent type;
+    uint16_t thread;
+    uint64_t a;
+    uint64_t b;
+};
+
+/**
+ * /tmp/bloxminer-<uid>/journal.bin, next to the stats segment
+ */
+std::string journal_path();
+
+/**
+ * Timestamp counter, or monotonic ns where there is none
+ */
+inline uint64_t journal_clock() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+}
+
+/**
+ * Fixed-size binary event ring in a memory-mapped file
+ *
+ * Any thread records with one fetch_add on the head and a handful of
+ * stores into its own slot: no lock, no syscall, no allocation. The
+ * mapping is shared, so the kernel keeps what was written even if the
+ * process dies, and the last run's journal is kept as PATH.1.
+ */
+class Journal {
+public:
+    Journal() = default;
+    ~Journal() { close(); }
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    /**
+     * Create the file (never through a symlink) and map it
+     * @param records Rounded up to a power of two
+     */
+    bool open(const std::string& path, size_t records);
+    void close();
+    bool is_open() const { return m_header != nullptr; }
+
+    /**
+     * Record an event of a mining thread
+     */
+    void record_thread(JournalEvent type, uint16_t thread, uint64_t a, uint64_t b = 0) {
+        if (!m_header) return;
+        uint64_t index = m_header->head.fetch_add(1, std::memory_order_relaxed);
+        JournalRecord& r = m_records[index & m_mask];
+        r.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        r.tsc = journal_clock();
+        r.type = static_cast<uint16_t>(type);
+        r.thread = thread;
+        r.a = a;
+        r.b = b;
+        r.seq.store(static_cast<uint32_t>(index + 1), std::memory_order_release);
+    }
+
+    void record(JournalEvent type, uint64_t a, uint64_t b = 0) {
+        record_thread(type, JournalRecord::NO_THREAD, a, b);
+    }
+
+    /**
+     * Move the second clock anchor to now; the longer the span between
+     * anchors, the better timestamps convert to wall time
+     */
+    void calibrate();
+
+private:
+    JournalHeader* m_header = nullptr;
+    JournalRecord* m_records = nullptr;
+    uint64_t m_mask = 0;
+    size_t m_map_size = 0;
+};
+
+/**
+ * Copy out the finished records still in the ring, oldest first
+ * @param error Set when false is returned
+ */
+bool read_journal(const std::string& path, std::vector<JournalEntry>& out, std::string& error);
+
+/**
+ * "job_received", "share_found", ...; "unknown" for other values
+ */
+const char* journal_event_name(JournalEvent type);
+
+/**
+ * One line, without the newline: text for people, or a JSON object
+ */
+std::string format_journal_entry(const JournalEntry& entry, bool json);
+
+}  // namespace utils
+}  // namespace bloxminer
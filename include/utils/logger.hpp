@@ -6,6 +6,15 @@
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
 #include "display.hpp"
 
 namespace bloxminer {
@@ -18,32 +27,105 @@ enum class LogLevel {
     ERROR
 };
 
+/**
+ * Asynchronous logger
+ *
+ * A log call copies its format pointer and arguments into a fixed-size
+ * record on the calling thread's own ring and returns: no formatting, no
+ * lock, no I/O. A background thread drains every ring, formats the
+ * records in time order and writes them to the terminal (through Display)
+ * and optionally to a rotating file. A ring that is full drops the record
+ * and counts it; the writer thread reports the count.
+ *
+ * Format strings must be literals (they are kept by pointer). %s, %d, %u,
+ * %f, %x, %p, %i with l/h/z modifiers are substituted in order, without
+ * width or precision, exactly as the synchronous logger did.
+ */
 class Logger {
 public:
+    static constexpr size_t MAX_ARGS = 8;
+    static constexpr size_t TEXT_SIZE = 384;    // Copied string arguments, per record
+    static constexpr size_t RING_SIZE = 128;    // Records per thread
+    static constexpr int FLUSH_INTERVAL_MS = 20;
+
+    struct Record;
+    using Render = void (*)(std::ostream&, const Record&);
+
+    struct Arg {
+        enum Kind : uint8_t { Int, UInt, Double, Bool, Char, String, Pointer };
+        Kind kind;
+        union {
+            int64_t i;
+            uint64_t u;
+            double d;
+            const void* p;
+            struct {
+                uint16_t offset;
+                uint16_t length;
+            } s;
+        };
+    };
+
+    /**
+     * One pre-parsed log line; formatted only on the writer thread
+     */
+    struct Record {
+        int64_t time_ns;
+        uint64_t seq;            // Order across threads
+        const char* fmt;         // LOG_*: the literal format
+        Render render;           // Tagged lines ([FOUND], [CONN], ...): renders the args itself
+        LogLevel level;
+        uint8_t nargs;
+        uint16_t text_used;
+        Arg args[MAX_ARGS];
+        char text[TEXT_SIZE];
+
+        const char* str(size_t i) const { return text + args[i].s.offset; }
+        size_t len(size_t i) const { return args[i].s.length; }
+    };
+
     static Logger& instance() {
         static Logger logger;
         return logger;
     }
 
+    ~Logger();
+
     void set_level(LogLevel level) { m_level = level; }
 
+    /**
+     * Also append the log, without colors, to path; it is rotated to
+     * path.1 ... path.<keep> when it grows past max_bytes
+     */
+    bool set_file(const std::string& path, uint64_t max_bytes, uint32_t keep);
+
+    /**
+     * Write out everything logged so far before returning
+     */
+    void flush();
+
+    /**
+     * Records lost to full rings since start
+     */
+    uint64_t dropped() const { return m_dropped_total.load(std::memory_order_relaxed); }
+
     template<typename... Args>
-    void debug(const char* fmt, Args... args) {
+    void debug(const char* fmt, const Args&... args) {
         log(LogLevel::DEBUG, fmt, args...);
     }
 
     template<typename... Args>
-    void info(const char* fmt, Args... args) {
+    void info(const char* fmt, const Args&... args) {
         log(LogLevel::INFO, fmt, args...);
     }
 
     template<typename... Args>
-    void warn(const char* fmt, Args... args) {
+    void warn(const char* fmt, const Args&... args) {
         log(LogLevel::WARN, fmt, args...);
     }
 
     template<typename... Args>
-    void error(const char* fmt, Args... args) {
+    void error(const char* fmt, const Args&... args) {
         log(LogLevel::ERROR, fmt, args...);
     }
 
@@ -58,87 +140,123 @@ public:
     void system_stats(double cpu_temp, double cpu_power);
 
 private:
-    Logger() : m_level(LogLevel::INFO) {}
+    /**
+     * Single-producer (the owning thread), single-consumer (whoever holds
+     * m_drain_mutex) ring
+     */
+    struct Ring {
+        alignas(64) std::atomic<uint64_t> head{0};
+        alignas(64) std::atomic<uint64_t> tail{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<bool> retired{false};   // Owning thread exited; freed once drained
+        uint64_t dropped_reported = 0;      // Consumer side
+        Record slots[RING_SIZE];
+    };
+
+    Logger();
+
+    Ring* local_ring();
 
     template<typename... Args>
-    void log(LogLevel level, const char* fmt, Args... args) {
+    void log(LogLevel level, const char* fmt, const Args&... args) {
         if (level < m_level) return;
+        push(level, fmt, nullptr, args...);
+    }
 
-        // Build the complete log message
-        std::stringstream ss;
-
-        // Timestamp
-        auto now = std::chrono::system_clock::now();
-        auto time = std::chrono::system_clock::to_time_t(now);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now.time_since_epoch()) % 1000;
-
-        ss << "\033[90m";  // Gray for timestamp
-        ss << std::put_time(std::localtime(&time), "%H:%M:%S");
-        ss << "." << std::setfill('0') << std::setw(3) << ms.count();
-        ss << "\033[0m ";
-
-        // Level color and prefix
-        const char* color = "";
-        const char* prefix = "";
-        switch (level) {
-            case LogLevel::DEBUG: color = "\033[36m"; prefix = "DBG"; break;
-            case LogLevel::INFO:  color = "\033[32m"; prefix = "INF"; break;
-            case LogLevel::WARN:  color = "\033[33m"; prefix = "WRN"; break;
-            case LogLevel::ERROR: color = "\033[31m"; prefix = "ERR"; break;
+    template<typename... Args>
+    void push(LogLevel level, const char* fmt, Render render, const Args&... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "too many log arguments");
+        Ring* ring = local_ring();
+        uint64_t head = ring->head.load(std::memory_order_relaxed);
+        if (head - ring->tail.load(std::memory_order_acquire) >= RING_SIZE) {
+            ring->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
         }
-
-        ss << color << "[" << prefix << "]\033[0m ";
-
-        // Format message into the stringstream
-        format_into(ss, fmt, args...);
-
-        // Route through Display class for proper scroll region handling
-        Display::instance().log(ss.str());
+        Record& r = ring->slots[head % RING_SIZE];
+        r.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        r.seq = m_seq.fetch_add(1, std::memory_order_relaxed);
+        r.fmt = fmt;
+        r.render = render;
+        r.level = level;
+        r.nargs = 0;
+        r.text_used = 0;
+        (put(r, args), ...);
+        ring->head.store(head + 1, std::memory_order_release);
     }
 
-    // Base case for format_into
-    void format_into(std::stringstream& ss, const char* fmt) {
-        ss << fmt;
+    static void put_text(Record& r, Arg& arg, const char* s, size_t n) {
+        arg.kind = Arg::String;
+        size_t room = TEXT_SIZE - r.text_used;
+        if (n > room) n = room;  // Truncated rather than blocking or allocating
+        memcpy(r.text + r.text_used, s, n);
+        arg.s.offset = r.text_used;
+        arg.s.length = static_cast<uint16_t>(n);
+        r.text_used = static_cast<uint16_t>(r.text_used + n);
     }
 
-    // Recursive case for format_into
-    template<typename T, typename... Args>
-    void format_into(std::stringstream& ss, const char* fmt, T value, Args... args) {
-        while (*fmt) {
-            if (*fmt == '%' && *(fmt + 1)) {
-                fmt++;
-                // Skip length modifiers (l, ll, h, hh, z)
-                while (*fmt == 'l' || *fmt == 'h' || *fmt == 'z') {
-                    fmt++;
-                }
-                switch (*fmt) {
-                    case 's':
-                    case 'd':
-                    case 'u':
-                    case 'f':
-                    case 'x':
-                    case 'X':
-                    case 'p':
-                    case 'i':
-                        ss << value;
-                        format_into(ss, fmt + 1, args...);
-                        return;
-                    case '%':
-                        ss << '%';
-                        break;
-                    default:
-                        ss << '%' << *fmt;
-                        break;
-                }
-            } else {
-                ss << *fmt;
-            }
-            fmt++;
+    // Same rendering as streaming the value, decided at compile time
+    template<typename T>
+    static void put(Record& r, const T& value) {
+        Arg& arg = r.args[r.nargs++];
+        if constexpr (std::is_same_v<T, bool>) {
+            arg.kind = Arg::Bool;
+            arg.u = value;
+        } else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+                             std::is_same_v<T, unsigned char>) {
+            arg.kind = Arg::Char;
+            arg.u = static_cast<unsigned char>(value);
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            arg.kind = Arg::Int;
+            arg.i = value;
+        } else if constexpr (std::is_integral_v<T>) {
+            arg.kind = Arg::UInt;
+            arg.u = value;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            arg.kind = Arg::Double;
+            arg.d = value;
+        } else if constexpr (std::is_convertible_v<const T&, const char*>) {
+            const char* s = value;
+            if (!s) s = "(null)";
+            put_text(r, arg, s, strlen(s));
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            put_text(r, arg, value.data(), value.size());
+        } else if constexpr (std::is_pointer_v<T>) {
+            arg.kind = Arg::Pointer;
+            arg.p = static_cast<const void*>(value);
+        } else {
+            // Anything else streamable: render it here, off the fast path
+            std::ostringstream ss;
+            ss << value;
+            std::string s = ss.str();
+            put_text(r, arg, s.data(), s.size());
         }
     }
 
-    LogLevel m_level;
+    void writer_loop();
+    void drain();
+    void write_line(const std::string& line);
+    void rotate();
+
+    std::atomic<LogLevel> m_level{LogLevel::INFO};
+    std::atomic<uint64_t> m_seq{0};
+    std::atomic<uint64_t> m_dropped_total{0};
+
+    std::mutex m_rings_mutex;                     // Registration and retirement only
+    std::vector<std::shared_ptr<Ring>> m_rings;
+
+    std::mutex m_drain_mutex;                     // The consumer side of every ring
+    std::vector<Record> m_batch;
+    std::ofstream m_file;
+    std::string m_file_path;
+    uint64_t m_file_size = 0;
+    uint64_t m_file_max = 0;
+    uint32_t m_file_keep = 0;
+
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake;
+    bool m_stop = false;
+    std::thread m_writer;
 };
 
 // Global logger access
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace bloxminer {
+namespace utils {
+
+/**
+ * Lock-free histogram with fixed bucket upper bounds
+ * observe() is a few relaxed atomic adds, safe from any thread including
+ * the mining hot path; snapshots taken while it runs may be off by the
+ * observations in flight, which Prometheus tolerates.
+ */
+class Histogram {
+public:
+    explicit Histogram(std::initializer_list<double> bounds);
+
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    void observe(double value);
+
+    const std::vector<double>& bounds() const { return m_bounds; }
+    uint64_t bucket(size_t i) const { return m_buckets[i].load(std::memory_order_relaxed); }  // Not cumulative
+    uint64_t count() const;
+    double sum() const { return m_sum.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<double> m_bounds;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_buckets;  // bounds.size() + 1, last is +Inf
+    std::atomic<double> m_sum{0.0};
+};
+
+/**
+ * Prometheus text exposition format (version 0.0.4) builder
+ * Call family() once per metric name, then sample() for each label set.
+ */
+class MetricsWriter {
+public:
+    void family(const std::string& name, const char* type, const char* help);
+    void sample(const std::string& name, const std::string& labels, double value);
+    void sample(const std::string& name, const std::string& labels, uint64_t value);
+
+    /**
+     * Whole histogram family: cumulative _bucket lines, _sum and _count
+     */
+    void histogram(const std::string& name, const char* help, const Histogram& h);
+
+    /**
+     * Label value with backslash, quote and newline escaped
+     */
+    static std::string escape(const std::string& value);
+
+    std::string str() const { return m_out.str(); }
+
+private:
+    std::ostringstream m_out;
+
+    void name_and_labels(const std::string& name, const std::string& labels);
+};
+
+}  // namespace utils
+}  // namespace bloxminer
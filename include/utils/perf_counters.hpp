@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace bloxminer {
+namespace utils {
+
+/**
+ * Cumulative hardware counts for one thread, scaled if the kernel had to
+ * multiplex the counters
+ */
+struct PerfSample {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t branch_misses = 0;
+    uint64_t l1d_misses = 0;       // L1 data cache read misses
+    uint64_t ref_cycles = 0;       // Cycles at the nominal (TSC) frequency
+    uint64_t running_ns = 0;       // Time the thread ran with the counters on
+};
+
+/**
+ * perf_event counters for the calling thread, user space only
+ *
+ * One group led by cycles, so all counts cover the same time and come back
+ * in a single read(). Counters the CPU or hypervisor does not offer are
+ * left out and read as zero; without cycles there is nothing to report and
+ * open() fails (no PMU in a container or VM, perf_event_paranoid > 2).
+ */
+class PerfCounters {
+public:
+    enum Counter { Cycles, Instructions, BranchMisses, L1dMisses, RefCycles, COUNT };
+
+    PerfCounters() = default;
+    ~PerfCounters() { close(); }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * Open and start the group on the calling thread
+     * @param error Why not, when false is returned
+     */
+    bool open(std::string& error);
+    void close();
+    bool is_open() const { return m_fd[Cycles] >= 0; }
+
+    /**
+     * Bit (1 << Counter) for each counter that opened
+     */
+    uint32_t available() const { return m_available; }
+
+    /**
+     * Counts since open(); one system call
+     */
+    bool read(PerfSample& out) const;
+
+private:
+    int m_fd[COUNT] = {-1, -1, -1, -1, -1};
+    int m_slot[COUNT] = {-1, -1, -1, -1, -1};  // Position in the group read
+    int m_members = 0;
+    uint32_t m_available = 0;
+};
+
+}  // namespace utils
+}  // namespace bloxminer
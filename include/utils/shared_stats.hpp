@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace bloxminer {
+namespace utils {
+
+/**
+ * Stats the miner shares with local agents through a memory-mapped file
+ *
+ * Plain data, copied whole under the segment's sequence number. Add fields
+ * at the end and bump SharedStatsSegment::VERSION when the layout changes.
+ */
+struct SharedStats {
+    static constexpr size_t MAX_THREADS = 256;
+
+    char version[16];          // Miner version, NUL-terminated
+    char algo[16];
+    int64_t updated_ms;        // Unix time of this update
+    uint32_t pid;
+    uint32_t num_threads;      // Valid entries in thread_hashrate
+    double uptime;             // Seconds
+    double hashrate;           // H/s, average since start
+    uint64_t accepted;
+    uint64_t rejected;
+    uint64_t stale;            // Found on a job no longer valid
+    double cpu_temp;           // Celsius, 0 when unavailable
+    double cpu_power;          // Watts, 0 when unavailable
+    double gpu_power;
+    double difficulty;         // Pool share difficulty
+    uint32_t pool_index;
+    uint32_t connected;        // 1 while a pool session is up
+    double thread_hashrate[MAX_THREADS];  // H/s per mining thread
+};
+
+/**
+ * File layout: fixed header, then the stats under a seqlock
+ */
+struct SharedStatsSegment {
+    static constexpr uint32_t MAGIC = 0x53584c42;  // "BLXS"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;                   // sizeof(SharedStatsSegment)
+    uint32_t reserved;
+    std::atomic<uint64_t> sequence;  // Odd while the miner writes
+    SharedStats stats;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "the sequence is shared between processes and must not need a lock");
+
+/**
+ * /tmp/bloxminer-<uid>/stats.shm, in the per-user directory (SEC-001)
+ */
+std::string shared_stats_path();
+
+/**
+ * Miner side: owns the mapping and updates it in place
+ */
+class SharedStatsWriter {
+public:
+    SharedStatsWriter() = default;
+    ~SharedStatsWriter() { close(); }
+
+    SharedStatsWriter(const SharedStatsWriter&) = delete;
+    SharedStatsWriter& operator=(const SharedStatsWriter&) = delete;
+
+    /**
+     * Create or reuse the file (never through a symlink) and map it
+     */
+    bool open(const std::string& path);
+    void close();
+    bool is_open() const { return m_segment != nullptr; }
+
+    /**
+     * Copy stats into the segment; readers never see half an update
+     */
+    void publish(const SharedStats& stats);
+
+private:
+    SharedStatsSegment* m_segment = nullptr;
+};
+
+/**
+ * Agent side: map the file read-only and copy a consistent snapshot
+ * @param error Set when false is returned
+ */
+bool read_shared_stats(const std::string& path, SharedStats& out, std::string& error);
+
+}  // namespace utils
+}  // namespace bloxminer
@@ -9,6 +9,7 @@
 #include <climits>
 #include <dirent.h>
 #include <cstring>
+#include <mutex>
 
 namespace bloxminer {
 namespace utils {
@@ -58,10 +59,21 @@ public:
     }
     
     // Get CPU power in Watts (from RAPL only)
+    // Stats, API and governor threads all sample this; the energy delta is shared
     double get_cpu_power() {
+        std::lock_guard<std::mutex> lock(m_power_mutex);
         return read_rapl_power();
     }
 
+    // Raw RAPL package energy counter in microjoules, for callers that
+    // measure their own interval. false without RAPL (hwmon power only).
+    bool get_cpu_energy_uj(uint64_t& energy_uj) {
+        std::lock_guard<std::mutex> lock(m_power_mutex);
+        if (m_rapl_path.empty()) return false;
+        energy_uj = read_energy_uj();
+        return energy_uj > 0;
+    }
+
     // Get GPU power in Watts (sum of all GPU power sensors)
     double get_gpu_power() {
         double total = 0.0;
@@ -395,6 +407,7 @@ private:
     uint64_t m_last_energy = 0;
     std::chrono::steady_clock::time_point m_last_energy_time;
     double m_last_power = 0.0;
+    std::mutex m_power_mutex;
 };
 
 }  // namespace utils
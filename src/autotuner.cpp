@@ -0,0 +1,255 @@
+#include "../include/autotuner.hpp"
+#include "../include/miner.hpp"
+#include "../include/utils/cpu_topology.hpp"
+#include "../include/utils/logger.hpp"
+#include "../include/utils/system_monitor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace bloxminer {
+
+namespace {
+
+// Two-sided 95% Student t for 1..10 degrees of freedom; 1.96 beyond
+double t95(size_t dof) {
+    static const double table[] = {12.71, 4.30, 3.18, 2.78, 2.57, 2.45, 2.36, 2.31, 2.26, 2.23};
+    return dof >= 1 && dof <= 10 ? table[dof - 1] : 1.96;
+}
+
+double mean(const std::vector<double>& v) {
+    double sum = 0.0;
+    for (double x : v) sum += x;
+    return v.empty() ? 0.0 : sum / v.size();
+}
+
+// 95% confidence half-width of the mean, relative to the mean
+double relative_ci(const std::vector<double>& v) {
+    if (v.size() < 2) return 1.0;
+    double m = mean(v);
+    double var = 0.0;
+    for (double x : v) var += (x - m) * (x - m);
+    var /= v.size() - 1;
+    return m > 0 ? t95(v.size() - 1) * std::sqrt(var / v.size()) / m : 1.0;
+}
+
+double efficiency(const TunedProfile& p) {
+    return p.power > 0 ? p.hashrate / 1000.0 / p.power : 0.0;  // KH/W
+}
+
+bool same_settings(const TunedProfile& a, const TunedProfile& b) {
+    return a.threads == b.threads && a.placement == b.placement &&
+           a.smt == b.smt && a.chunk_target_ms == b.chunk_target_ms;
+}
+
+}  // namespace
+
+Autotuner::Autotuner(Miner& miner, const MinerConfig& config, const Options& options)
+    : m_miner(miner), m_config(config), m_options(options) {
+    uint64_t energy = 0;
+    m_have_rapl = utils::SystemMonitor::instance().get_cpu_energy_uj(energy);
+
+    m_applied.threads = miner.thread_count();
+    m_applied.placement = config.placement;
+    m_applied.smt = config.smt;
+    m_applied.chunk_target_ms = config.chunk_target_ms;
+}
+
+std::string Autotuner::describe(const TunedProfile& profile) {
+    std::stringstream ss;
+    ss << profile.threads << " threads, "
+       << (profile.placement == ThreadPlacement::Pinned ? "pinned" : "unpinned")
+       << (profile.smt ? "" : " one per core") << ", "
+       << profile.chunk_target_ms << " ms chunks: "
+       << std::fixed << std::setprecision(2) << profile.hashrate / 1e6 << " MH/s";
+    if (profile.power > 0) {
+        ss << ", " << std::setprecision(1) << profile.power << " W, "
+           << efficiency(profile) << " KH/W";
+    }
+    return ss.str();
+}
+
+void Autotuner::apply(const TunedProfile& profile) {
+    if (profile.placement != m_applied.placement) {
+        m_miner.set_placement(profile.placement);
+    }
+    if (profile.smt != m_applied.smt) {
+        m_miner.set_smt(profile.smt);
+    }
+    if (profile.chunk_target_ms != m_applied.chunk_target_ms) {
+        m_miner.set_chunk_target_ms(profile.chunk_target_ms);
+    }
+    if (profile.threads != m_applied.threads) {
+        m_miner.set_thread_count(profile.threads);
+    }
+    m_applied = profile;
+}
+
+bool Autotuner::sleep_seconds(uint32_t seconds) {
+    for (uint32_t i = 0; i < seconds * 10; i++) {
+        if (m_stop || !m_miner.is_running()) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    return !m_stop && m_miner.is_running();
+}
+
+bool Autotuner::wait_for_hashes() {
+    const MinerStats& stats = m_miner.get_stats();
+    uint64_t start = stats.total_hashes();
+    while (stats.total_hashes() == start) {
+        if (!sleep_seconds(1)) return false;
+    }
+    return true;
+}
+
+bool Autotuner::measure(TunedProfile& profile) {
+    apply(profile);
+    if (!sleep_seconds(m_options.warmup_seconds)) return false;
+
+    const MinerStats& stats = m_miner.get_stats();
+    auto& monitor = utils::SystemMonitor::instance();
+    std::vector<double> rates;
+    std::vector<double> powers;
+    uint32_t stalled = 0;
+
+    while (rates.size() < m_options.max_windows) {
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t hashes0 = stats.total_hashes();
+        uint64_t energy0 = 0;
+        bool have_energy = m_have_rapl && monitor.get_cpu_energy_uj(energy0);
+
+        if (!sleep_seconds(m_options.window_seconds)) return false;
+
+        double dt = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        uint64_t hashes1 = stats.total_hashes();
+        uint64_t energy1 = 0;
+        if (have_energy && !monitor.get_cpu_energy_uj(energy1)) {
+            have_energy = false;
+        }
+
+        // No job (pool reconnecting): the window says nothing about this configuration
+        if (hashes1 <= hashes0) {
+            if (++stalled > m_options.max_windows) return false;
+            continue;
+        }
+        rates.push_back((hashes1 - hashes0) / dt);
+
+        // A wrapped energy counter loses the window's power sample only
+        if (have_energy && energy1 > energy0) {
+            powers.push_back((energy1 - energy0) / 1e6 / dt);
+        } else if (!m_have_rapl) {
+            double watts = monitor.get_cpu_power();  // hwmon: instantaneous
+            if (watts > 0) powers.push_back(watts);
+        }
+
+        if (rates.size() >= m_options.min_windows &&
+            relative_ci(rates) <= m_options.confidence &&
+            (powers.size() < 2 || relative_ci(powers) <= m_options.confidence)) {
+            break;
+        }
+    }
+
+    profile.hashrate = mean(rates);
+    profile.power = mean(powers);
+
+    std::stringstream ss;
+    ss << "Autotune: " << describe(profile) << " (+-" << std::fixed << std::setprecision(1)
+       << relative_ci(rates) * 100.0 << "% over " << rates.size() << " windows)";
+    LOG_INFO("%s", ss.str().c_str());
+    return true;
+}
+
+bool Autotuner::run(Goal goal, TunedProfile& best_hashrate, TunedProfile& best_efficiency) {
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw == 0) hw = m_miner.thread_count();
+    hw = std::min<unsigned>(hw, MinerStats::MAX_THREADS);
+    unsigned cores = std::min(hw, utils::CpuTopology::physical_cores());
+
+    LOG_INFO("Autotune: %u logical CPUs, %u cores, power from %s", hw, cores,
+             m_have_rapl ? "RAPL" : "hwmon");
+    if (!wait_for_hashes()) return false;
+
+    std::vector<TunedProfile> trials;
+    auto run_trial = [&](const TunedProfile& candidate) -> bool {
+        for (const auto& t : trials) {
+            if (same_settings(t, candidate)) return true;
+        }
+        TunedProfile p = candidate;
+        if (!measure(p)) return false;
+        trials.push_back(p);
+        return true;
+    };
+    auto best_by = [&](bool by_efficiency) -> size_t {
+        size_t best = 0;
+        for (size_t i = 1; i < trials.size(); i++) {
+            double a = by_efficiency ? efficiency(trials[i]) : trials[i].hashrate;
+            double b = by_efficiency ? efficiency(trials[best]) : trials[best].hashrate;
+            if (a > b) best = i;
+        }
+        return best;
+    };
+    auto leaders = [&]() {
+        std::vector<TunedProfile> out = {trials[best_by(false)]};
+        TunedProfile e = trials[best_by(true)];
+        if (efficiency(e) > 0 && !same_settings(e, out[0])) out.push_back(e);
+        return out;
+    };
+
+    // Stage 1: worker count, pinned with SMT, at the configured chunk length.
+    // The optimum is usually just below the logical CPU count or at the core count.
+    std::vector<unsigned> counts = {hw, hw - 1, hw - 2, hw - 3, hw * 3 / 4, hw / 2, cores, cores - 1};
+    std::sort(counts.begin(), counts.end(), std::greater<unsigned>());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+
+    TunedProfile base;
+    base.placement = ThreadPlacement::Pinned;
+    base.smt = true;
+    base.chunk_target_ms = m_config.chunk_target_ms;
+    for (unsigned n : counts) {
+        if (n == 0 || n > hw) continue;
+        base.threads = n;
+        if (!run_trial(base)) return false;
+    }
+
+    // Stage 2: placement and SMT variants of the leaders
+    for (TunedProfile p : leaders()) {
+        TunedProfile unpinned = p;
+        unpinned.placement = ThreadPlacement::Unpinned;
+        if (!run_trial(unpinned)) return false;
+        if (cores < hw && p.threads <= cores && p.placement == ThreadPlacement::Pinned) {
+            TunedProfile one_per_core = p;
+            one_per_core.smt = false;
+            if (!run_trial(one_per_core)) return false;
+        }
+    }
+
+    // Stage 3: chunk length for the leaders
+    for (TunedProfile p : leaders()) {
+        for (uint32_t ms : {std::max<uint32_t>(10, p.chunk_target_ms / 2), p.chunk_target_ms * 2}) {
+            TunedProfile chunked = p;
+            chunked.chunk_target_ms = ms;
+            if (!run_trial(chunked)) return false;
+        }
+    }
+
+    best_hashrate = trials[best_by(false)];
+    bool have_power = efficiency(trials[best_by(true)]) > 0;
+    best_efficiency = have_power ? trials[best_by(true)] : TunedProfile();
+
+    LOG_INFO("Autotune: best hashrate: %s", describe(best_hashrate).c_str());
+    if (have_power) {
+        LOG_INFO("Autotune: best efficiency: %s", describe(best_efficiency).c_str());
+    } else {
+        LOG_WARN("Autotune: no power readings; efficiency could not be ranked");
+    }
+
+    apply(goal == Goal::Efficiency && have_power ? best_efficiency : best_hashrate);
+    return true;
+}
+
+}  // namespace bloxminer
@@ -12,6 +12,33 @@ using json = nlohmann::json;
 
 namespace bloxminer {
 
+namespace {
+
+json profile_to_json(const TunedProfile& profile) {
+    json j;
+    j["threads"] = profile.threads;
+    j["placement"] = profile.placement == ThreadPlacement::Unpinned ? "unpinned" : "pinned";
+    j["smt"] = profile.smt;
+    j["chunk_ms"] = profile.chunk_target_ms;
+    j["hashrate"] = profile.hashrate;
+    j["power"] = profile.power;
+    return j;
+}
+
+TunedProfile profile_from_json(const json& j) {
+    TunedProfile profile;
+    profile.threads = j.value("threads", 0);
+    profile.placement = j.value("placement", "pinned") == "unpinned"
+                            ? ThreadPlacement::Unpinned : ThreadPlacement::Pinned;
+    profile.smt = j.value("smt", true);
+    profile.chunk_target_ms = j.value("chunk_ms", 50);
+    profile.hashrate = j.value("hashrate", 0.0);
+    profile.power = j.value("power", 0.0);
+    return profile;
+}
+
+}  // namespace
+
 std::string ConfigManager::expand_home_path(const std::string& path) {
     if (path.empty() || path[0] != '~') {
         return path;
@@ -99,6 +126,8 @@ std::optional<MinerConfig> ConfigManager::load_config(const std::string& custom_
                 PoolConfig pool;
                 pool.host = pool_json.value("host", "pool.verus.io");
                 pool.port = pool_json.value("port", 9999);
+                pool.tls = pool_json.value("tls", false);
+                pool.tls_verify = pool_json.value("tls_verify", true);
                 pool.priority = config.pools.size();
                 config.pools.push_back(pool);
             }
@@ -126,12 +155,108 @@ std::optional<MinerConfig> ConfigManager::load_config(const std::string& custom_
         // Parse threads (0 = auto)
         config.num_threads = j.value("threads", 0);
 
+        // Target wall time per nonce range handed to a thread
+        config.chunk_target_ms = j.value("chunk_ms", 50);
+
+        // Thread placement: "pinned" (default) or "unpinned"
+        config.placement = j.value("placement", "pinned") == "unpinned"
+                               ? ThreadPlacement::Unpinned : ThreadPlacement::Pinned;
+        config.smt = j.value("smt", true);
+        config.perf_counters = j.value("perf_counters", false);
+
+        // Results of the last --autotune run
+        if (j.contains("autotune")) {
+            const auto& autotune = j["autotune"];
+            if (autotune.contains("hashrate")) {
+                config.tuned_hashrate = profile_from_json(autotune["hashrate"]);
+            }
+            if (autotune.contains("efficiency")) {
+                config.tuned_efficiency = profile_from_json(autotune["efficiency"]);
+            }
+        }
+
+        // Parse pool selection settings
+        if (j.contains("pool_selection")) {
+            const auto& selection = j["pool_selection"];
+            config.pool_latency_ranking = selection.value("mode", "order") == "latency";
+            config.pool_probe_interval = selection.value("probe_interval", 30);
+            config.pool_switch_margin_ms = selection.value("margin_ms", 10.0);
+            config.pool_switch_margin = selection.value("margin", 0.2);
+            config.pool_switch_confirmations = selection.value("confirmations", 3);
+        }
+        
+        // Parse difficulty suggestion settings
+        if (j.contains("difficulty")) {
+            const auto& difficulty = j["difficulty"];
+            std::string mode = difficulty.value("mode", "off");
+            if (mode == "suggest") {
+                config.difficulty_hint = DifficultyHint::Suggest;
+            } else if (mode == "password") {
+                config.difficulty_hint = DifficultyHint::Password;
+            } else {
+                config.difficulty_hint = DifficultyHint::Off;
+            }
+            config.share_interval = difficulty.value("share_interval", 10.0);
+            config.difficulty_change = difficulty.value("change", 0.25);
+        }
+        
+        // Parse share buffer settings
+        if (j.contains("share_buffer")) {
+            const auto& buffer = j["share_buffer"];
+            config.share_buffer_size = buffer.value("size", 64);
+            config.share_buffer_max_age = buffer.value("max_age", 30);
+        }
+        
+        // Parse event journal settings
+        if (j.contains("journal")) {
+            config.journal_records = j["journal"].value("records", 65536);
+        }
+        
+        // Parse governor settings
+        if (j.contains("governor")) {
+            const auto& governor = j["governor"];
+            std::string mode = governor.value("mode", "off");
+            if (mode == "temp") {
+                config.governor_mode = GovernorMode::Temperature;
+            } else if (mode == "power") {
+                config.governor_mode = GovernorMode::Power;
+            } else if (mode == "efficiency") {
+                config.governor_mode = GovernorMode::Efficiency;
+            } else {
+                config.governor_mode = GovernorMode::Off;
+            }
+            config.governor_target = governor.value("target", 0.0);
+            config.governor_interval = governor.value("interval", 2);
+            config.governor_min_threads = governor.value("min_threads", 1);
+        }
+
+        // Parse background mode settings
+        if (j.contains("background")) {
+            const auto& background = j["background"];
+            config.background = background.value("enabled", false);
+            config.background_pressure_high = background.value("pressure_high", 10.0);
+            config.background_pressure_low = background.value("pressure_low", 2.0);
+            config.background_recover_ms = background.value("recover_ms", 2000);
+            config.background_poll_ms = background.value("poll_ms", 50);
+        }
+        
+        // Parse self-healing placement settings
+        if (j.contains("heal")) {
+            const auto& heal = j["heal"];
+            config.heal = heal.value("enabled", false);
+            config.heal_interval = heal.value("interval", 10);
+            config.heal_threshold = heal.value("threshold", 0.10);
+            config.heal_confirmations = heal.value("confirmations", 3);
+            config.heal_retire_below = heal.value("retire_below", 0.5);
+        }
+
         // Parse API settings
         if (j.contains("api")) {
             const auto& api = j["api"];
             config.api_enabled = api.value("enabled", true);
             config.api_port = api.value("port", 4068);
             config.api_bind_address = api.value("bind", "127.0.0.1");
+            config.api_control = api.value("control", false);
         }
 
         // Parse display settings
@@ -141,6 +266,14 @@ std::optional<MinerConfig> ConfigManager::load_config(const std::string& custom_
             config.show_shares = display.value("show_shares", true);
         }
 
+        // Parse log file settings
+        if (j.contains("log")) {
+            const auto& log = j["log"];
+            config.log_file = log.value("file", "");
+            config.log_max_size_mb = log.value("max_size_mb", 10);
+            config.log_keep = log.value("keep", 3);
+        }
+
         std::cout << "Loaded config from: " << config_path << std::endl;
         return config;
 
@@ -169,21 +302,126 @@ bool ConfigManager::save_config(const MinerConfig& config, const std::string& pa
         json pool_json;
         pool_json["host"] = pool.host;
         pool_json["port"] = pool.port;
+        if (pool.tls) {
+            pool_json["tls"] = true;
+            if (!pool.tls_verify) {
+                pool_json["tls_verify"] = false;
+            }
+        }
         pools_array.push_back(pool_json);
     }
     j["pools"] = pools_array;
 
+    if (config.pool_latency_ranking) {
+        json selection;
+        selection["mode"] = "latency";
+        selection["probe_interval"] = config.pool_probe_interval;
+        selection["margin_ms"] = config.pool_switch_margin_ms;
+        selection["margin"] = config.pool_switch_margin;
+        selection["confirmations"] = config.pool_switch_confirmations;
+        j["pool_selection"] = selection;
+    }
+
+    if (config.difficulty_hint != DifficultyHint::Off) {
+        json difficulty;
+        difficulty["mode"] = config.difficulty_hint == DifficultyHint::Password ? "password" : "suggest";
+        difficulty["share_interval"] = config.share_interval;
+        difficulty["change"] = config.difficulty_change;
+        j["difficulty"] = difficulty;
+    }
+
+    if (config.share_buffer_size != 64 || config.share_buffer_max_age != 30) {
+        json buffer;
+        buffer["size"] = config.share_buffer_size;
+        buffer["max_age"] = config.share_buffer_max_age;
+        j["share_buffer"] = buffer;
+    }
+
+    if (config.journal_records != 65536) {
+        json journal;
+        journal["records"] = config.journal_records;
+        j["journal"] = journal;
+    }
+
     j["worker"] = config.worker_name;
     j["password"] = config.worker_password;
     j["threads"] = config.num_threads;
+    j["chunk_ms"] = config.chunk_target_ms;
+    j["placement"] = config.placement == ThreadPlacement::Unpinned ? "unpinned" : "pinned";
+    j["smt"] = config.smt;
+    if (config.perf_counters) {
+        j["perf_counters"] = true;
+    }
+
+    if (config.tuned_hashrate.threads > 0 || config.tuned_efficiency.threads > 0) {
+        json autotune;
+        if (config.tuned_hashrate.threads > 0) {
+            autotune["hashrate"] = profile_to_json(config.tuned_hashrate);
+        }
+        if (config.tuned_efficiency.threads > 0) {
+            autotune["efficiency"] = profile_to_json(config.tuned_efficiency);
+        }
+        j["autotune"] = autotune;
+    }
+
+    // Governor settings
+    if (config.governor_mode != GovernorMode::Off) {
+        json governor;
+        switch (config.governor_mode) {
+            case GovernorMode::Temperature: governor["mode"] = "temp"; break;
+            case GovernorMode::Power:       governor["mode"] = "power"; break;
+            default:                        governor["mode"] = "efficiency"; break;
+        }
+        governor["target"] = config.governor_target;
+        governor["interval"] = config.governor_interval;
+        governor["min_threads"] = config.governor_min_threads;
+        j["governor"] = governor;
+    }
+
+    // Background mode settings
+    if (config.background) {
+        json background;
+        background["enabled"] = config.background;
+        background["pressure_high"] = config.background_pressure_high;
+        background["pressure_low"] = config.background_pressure_low;
+        background["recover_ms"] = config.background_recover_ms;
+        background["poll_ms"] = config.background_poll_ms;
+        j["background"] = background;
+    }
+
+    // Self-healing placement settings
+    if (config.heal) {
+        json heal;
+        heal["enabled"] = config.heal;
+        heal["interval"] = config.heal_interval;
+        heal["threshold"] = config.heal_threshold;
+        heal["confirmations"] = config.heal_confirmations;
+        heal["retire_below"] = config.heal_retire_below;
+        j["heal"] = heal;
+    }
 
     // API settings
     json api;
     api["enabled"] = config.api_enabled;
     api["port"] = config.api_port;
     api["bind"] = config.api_bind_address;
+    api["control"] = config.api_control;
     j["api"] = api;
 
+    // Display settings
+    json display;
+    display["stats_interval"] = config.stats_interval;
+    display["show_shares"] = config.show_shares;
+    j["display"] = display;
+
+    if (!config.log_file.empty()) {
+        json log;
+        log["file"] = config.log_file;
+        log["max_size_mb"] = config.log_max_size_mb;
+        log["keep"] = config.log_keep;
+        j["log"] = log;
+    }
+
     // Write to file
     std::ofstream file(save_path);
     if (!file.is_open()) {
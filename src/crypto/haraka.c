@@ -193,72 +193,5 @@ void haraka512_zero(unsigned char *out, const unsigned char *in) {
 void haraka512_keyed(unsigned char *out, const unsigned char *in, const u128 *rc) {
   // This is the CORRECT keyed haraka512 that uses the passed rc (key) parameter.
   // The key comes from the CLHash-generated key array at a computed offset.
-  u128 s[4], tmp;
-
-  s[0] = LOAD(in);
-  s[1] = LOAD(in + 16);
-  s[2] = LOAD(in + 32);
-  s[3] = LOAD(in + 48);
-
-  // Round 1
-  s[0] = _mm_aesenc_si128(s[0], rc[0]);
-  s[1] = _mm_aesenc_si128(s[1], rc[1]);
-  s[2] = _mm_aesenc_si128(s[2], rc[2]);
-  s[3] = _mm_aesenc_si128(s[3], rc[3]);
-  s[0] = _mm_aesenc_si128(s[0], rc[4]);
-  s[1] = _mm_aesenc_si128(s[1], rc[5]);
-  s[2] = _mm_aesenc_si128(s[2], rc[6]);
-  s[3] = _mm_aesenc_si128(s[3], rc[7]);
-  MIX4(s[0], s[1], s[2], s[3]);
-
-  // Round 2
-  s[0] = _mm_aesenc_si128(s[0], rc[8]);
-  s[1] = _mm_aesenc_si128(s[1], rc[9]);
-  s[2] = _mm_aesenc_si128(s[2], rc[10]);
-  s[3] = _mm_aesenc_si128(s[3], rc[11]);
-  s[0] = _mm_aesenc_si128(s[0], rc[12]);
-  s[1] = _mm_aesenc_si128(s[1], rc[13]);
-  s[2] = _mm_aesenc_si128(s[2], rc[14]);
-  s[3] = _mm_aesenc_si128(s[3], rc[15]);
-  MIX4(s[0], s[1], s[2], s[3]);
-
-  // Round 3
-  s[0] = _mm_aesenc_si128(s[0], rc[16]);
-  s[1] = _mm_aesenc_si128(s[1], rc[17]);
-  s[2] = _mm_aesenc_si128(s[2], rc[18]);
-  s[3] = _mm_aesenc_si128(s[3], rc[19]);
-  s[0] = _mm_aesenc_si128(s[0], rc[20]);
-  s[1] = _mm_aesenc_si128(s[1], rc[21]);
-  s[2] = _mm_aesenc_si128(s[2], rc[22]);
-  s[3] = _mm_aesenc_si128(s[3], rc[23]);
-  MIX4(s[0], s[1], s[2], s[3]);
-
-  // Round 4
-  s[0] = _mm_aesenc_si128(s[0], rc[24]);
-  s[1] = _mm_aesenc_si128(s[1], rc[25]);
-  s[2] = _mm_aesenc_si128(s[2], rc[26]);
-  s[3] = _mm_aesenc_si128(s[3], rc[27]);
-  s[0] = _mm_aesenc_si128(s[0], rc[28]);
-  s[1] = _mm_aesenc_si128(s[1], rc[29]);
-  s[2] = _mm_aesenc_si128(s[2], rc[30]);
-  s[3] = _mm_aesenc_si128(s[3], rc[31]);
-  MIX4(s[0], s[1], s[2], s[3]);
-
-  // Round 5
-  s[0] = _mm_aesenc_si128(s[0], rc[32]);
-  s[1] = _mm_aesenc_si128(s[1], rc[33]);
-  s[2] = _mm_aesenc_si128(s[2], rc[34]);
-  s[3] = _mm_aesenc_si128(s[3], rc[35]);
-  s[0] = _mm_aesenc_si128(s[0], rc[36]);
-  s[1] = _mm_aesenc_si128(s[1], rc[37]);
-  s[2] = _mm_aesenc_si128(s[2], rc[38]);
-  s[3] = _mm_aesenc_si128(s[3], rc[39]);
-  MIX4(s[0], s[1], s[2], s[3]);
-
-  s[0] = _mm_xor_si128(s[0], LOAD(in));
-  s[1] = _mm_xor_si128(s[1], LOAD(in + 16));
-  s[2] = _mm_xor_si128(s[2], LOAD(in + 32));
-  s[3] = _mm_xor_si128(s[3], LOAD(in + 48));
-
-  TRUNCSTORE(out, s[0], s[1], s[2], s[3]);
+  haraka512_keyed_rows(out, LOAD(in), LOAD(in + 16), LOAD(in + 32), LOAD(in + 48), rc);
 }
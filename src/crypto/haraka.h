@@ -78,6 +78,42 @@ extern u128 rc0[40];
   *(u64*)(out + 16) = *(((u64*)&s2 + 0)); \
   *(u64*)(out + 24) = *(((u64*)&s3 + 0));
 
+// Keyed Haraka512 on four in-register rows, writing the 32-byte truncated result.
+// Inlinable form of haraka512_keyed() for the fused mining loop.
+static inline __attribute__((always_inline)) void haraka512_keyed_rows(unsigned char *out,
+    u128 in0, u128 in1, u128 in2, u128 in3, const u128 *rc) {
+  u128 s[4], tmp;
+
+  s[0] = in0;
+  s[1] = in1;
+  s[2] = in2;
+  s[3] = in3;
+
+  AES4(s[0], s[1], s[2], s[3], 0);
+  MIX4(s[0], s[1], s[2], s[3]);
+
+  AES4(s[0], s[1], s[2], s[3], 8);
+  MIX4(s[0], s[1], s[2], s[3]);
+
+  AES4(s[0], s[1], s[2], s[3], 16);
+  MIX4(s[0], s[1], s[2], s[3]);
+
+  AES4(s[0], s[1], s[2], s[3], 24);
+  MIX4(s[0], s[1], s[2], s[3]);
+
+  AES4(s[0], s[1], s[2], s[3], 32);
+  MIX4(s[0], s[1], s[2], s[3]);
+
+  s[0] = _mm_xor_si128(s[0], in0);
+  s[1] = _mm_xor_si128(s[1], in1);
+  s[2] = _mm_xor_si128(s[2], in2);
+  s[3] = _mm_xor_si128(s[3], in3);
+
+  // TRUNCSTORE without the type-punned loads
+  STORE(out, _mm_unpackhi_epi64(s[0], s[1]));
+  STORE(out + 16, _mm_unpacklo_epi64(s[2], s[3]));
+}
+
 // Initialize round constants
 void load_constants(void);
 
@@ -0,0 +1,178 @@
+/*
+ * VerusHash batch verification for libverushash
+ *
+ * Each worker owns a deque of contiguous chunks of the batch. Workers pop
+ * from the front of their own deque and, once it runs dry, steal from the
+ * back of the other workers' deques, so uneven per-item cost or a
+ * descheduled thread does not leave cores idle at the end of a batch.
+ */
+
+#include "verus_batch.h"
+#include "verus_hash.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Items per chunk - small enough to balance, large enough to keep lock traffic negligible
+constexpr size_t CHUNK_SIZE = 16;
+
+using Range = std::pair<size_t, size_t>;  // [begin, end)
+
+struct alignas(64) WorkerQueue {
+    std::mutex mutex;
+    std::deque<Range> chunks;
+};
+
+bool pop_local(WorkerQueue& queue, Range& out) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.chunks.empty()) return false;
+    out = queue.chunks.front();
+    queue.chunks.pop_front();
+    return true;
+}
+
+bool steal(std::vector<WorkerQueue>& queues, size_t self, Range& out) {
+    for (size_t offset = 1; offset < queues.size(); offset++) {
+        WorkerQueue& victim = queues[(self + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.chunks.empty()) {
+            out = victim.chunks.back();
+            victim.chunks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+// hash <= target, both 256-bit little-endian (same rule as the miner)
+bool hash_meets_target(const uint8_t* hash, const uint8_t* target) {
+    for (int i = 31; i >= 0; i--) {
+        if (hash[i] < target[i]) return true;
+        if (hash[i] > target[i]) return false;
+    }
+    return true;
+}
+
+void hash_block(verus::Hasher& hasher, const uint8_t* block, uint8_t* hash32) {
+    alignas(32) uint8_t work[1536];
+    alignas(32) uint8_t intermediate[64];
+
+    memcpy(work, block, VERUS_BLOCK_SIZE);
+    memset(work + VERUS_BLOCK_SIZE, 0, sizeof(work) - VERUS_BLOCK_SIZE);
+    verus_block_canonicalize(work);
+
+    // Same two-stage path as Miner::mining_thread: the trailing 15 bytes of the
+    // solution are the nonceSpace that hash_with_nonce() folds in last
+    hasher.hash_half(work, VERUS_BLOCK_SIZE, intermediate);
+    hasher.prepare_key(intermediate);
+    hasher.hash_with_nonce(intermediate, block + VERUS_NONCESPACE_OFFSET, hash32);
+}
+
+struct BatchJob {
+    const uint8_t* blocks;
+    const uint8_t* targets;
+    uint8_t* hashes;
+    uint8_t* pass;
+    std::atomic<int64_t> passed{0};
+};
+
+void process_range(verus::Hasher& hasher, BatchJob& job, const Range& range) {
+    int64_t passed = 0;
+    for (size_t i = range.first; i < range.second; i++) {
+        alignas(32) uint8_t hash[32];
+        hash_block(hasher, job.blocks + i * VERUS_BLOCK_SIZE, hash);
+
+        bool ok = job.targets ? hash_meets_target(hash, job.targets + i * 32) : true;
+        if (ok) passed++;
+        if (job.hashes) memcpy(job.hashes + i * 32, hash, 32);
+        if (job.pass) job.pass[i] = ok ? 1 : 0;
+    }
+    job.passed.fetch_add(passed, std::memory_order_relaxed);
+}
+
+void worker(std::vector<WorkerQueue>& queues, size_t self, BatchJob& job) {
+    {
+        verus::Hasher hasher;
+        Range range;
+        while (pop_local(queues[self], range) || steal(queues, self, range)) {
+            process_range(hasher, job, range);
+        }
+    }
+    // Pool threads are short-lived: release the thread-local CLHash key
+    verus_clhash_cleanup();
+}
+
+}  // namespace
+
+extern "C" {
+
+void verus_block_canonicalize(uint8_t *block) {
+    const uint8_t* solution = block + VERUS_BLOCK_HEADER_SIZE + 3;
+
+    // For version >= 7 with merged mining (solution[5] > 0), clear non-canonical data
+    if (solution[0] >= 7 && solution[5] > 0) {
+        // hashPrevBlock, hashMerkleRoot, hashFinalSaplingRoot (96 bytes at offset 4)
+        memset(block + 4, 0, 96);
+        // nBits (4 bytes at offset 104)
+        memset(block + 104, 0, 4);
+        // nNonce (32 bytes at offset 108)
+        memset(block + 108, 0, 32);
+        // hashPrevMMRRoot and hashBlockMMRRoot (64 bytes starting at solution byte 8)
+        memset(block + VERUS_BLOCK_HEADER_SIZE + 3 + 8, 0, 64);
+    }
+}
+
+void verus_block_hash(const uint8_t *block, uint8_t *hash32) {
+    verus::Hasher hasher;
+    hash_block(hasher, block, hash32);
+}
+
+int64_t verus_verify_batch(const uint8_t *blocks, const uint8_t *targets, size_t count,
+                           unsigned int num_threads, uint8_t *hashes, uint8_t *pass) {
+    if (!blocks && count > 0) return -1;
+    if (count == 0) return 0;
+    if (!verus_hash_supported()) return -1;
+
+    if (num_threads == 0) {
+        num_threads = std::thread::hardware_concurrency();
+        if (num_threads == 0) num_threads = 1;
+    }
+
+    size_t num_chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    size_t workers = std::min<size_t>(num_threads, num_chunks);
+
+    BatchJob job;
+    job.blocks = blocks;
+    job.targets = targets;
+    job.hashes = hashes;
+    job.pass = pass;
+
+    // Seed each worker with a contiguous run of chunks
+    std::vector<WorkerQueue> queues(workers);
+    for (size_t c = 0; c < num_chunks; c++) {
+        size_t begin = c * CHUNK_SIZE;
+        size_t end = std::min(begin + CHUNK_SIZE, count);
+        queues[c * workers / num_chunks].chunks.emplace_back(begin, end);
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (size_t i = 0; i < workers; i++) {
+        threads.emplace_back(worker, std::ref(queues), i, std::ref(job));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    return job.passed.load();
+}
+
+}  // extern "C"
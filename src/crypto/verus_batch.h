@@ -0,0 +1,62 @@
+/*
+ * VerusHash batch verification - C API for libverushash
+ *
+ * Verifies full Verus block headers (140-byte header + 1347-byte solution)
+ * with the same two-stage kernels the miner uses, spread across a
+ * work-stealing thread pool. Has no dependency on the miner or stratum code,
+ * so it can be linked into pool software or chain re-validation tools.
+ */
+
+#ifndef BLOXMINER_VERUS_BATCH_H
+#define BLOXMINER_VERUS_BATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Full block size: 140-byte header + 3-byte compact size (fd4005) + 1344-byte solution
+#define VERUS_BLOCK_HEADER_SIZE     140
+#define VERUS_BLOCK_SIZE            1487
+
+// Offset of the 15-byte nonceSpace at the end of the solution
+#define VERUS_NONCESPACE_OFFSET     (VERUS_BLOCK_SIZE - 15)
+
+/**
+ * Clear non-canonical fields of a merged-mining block in place
+ * (solution version >= 7 with solution[5] > 0). No-op otherwise.
+ *
+ * @param block Full 1487-byte block
+ */
+void verus_block_canonicalize(uint8_t *block);
+
+/**
+ * Compute the VerusHash v2.2 of a single full block
+ *
+ * @param block  Full 1487-byte block (not modified)
+ * @param hash32 32-byte hash output (little-endian)
+ */
+void verus_block_hash(const uint8_t *block, uint8_t *hash32);
+
+/**
+ * Verify a batch of full blocks in parallel
+ *
+ * @param blocks      count * VERUS_BLOCK_SIZE bytes of contiguous blocks
+ * @param targets     count * 32 bytes of little-endian targets, or NULL to skip
+ *                    the target check (every item then passes)
+ * @param count       Number of blocks
+ * @param num_threads Worker threads (0 = hardware concurrency)
+ * @param hashes      Optional count * 32 byte output for the computed hashes
+ * @param pass        Optional count byte output: 1 if hash <= target, else 0
+ * @return Number of blocks that met their target, or -1 on invalid arguments
+ */
+int64_t verus_verify_batch(const uint8_t *blocks, const uint8_t *targets, size_t count,
+                           unsigned int num_threads, uint8_t *hashes, uint8_t *pass);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLOXMINER_VERUS_BATCH_H
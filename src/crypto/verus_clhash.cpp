@@ -0,0 +1,139 @@
+/*
+ * VerusCLHash Implementation for BloxMiner
+ * 
+ * Based on the official VerusCoin implementation by Michael Toutonghi.
+ * Original CLHash by Daniel Lemire.
+ *
+ * Every CLHash entry point below is an instantiation of the templated
+ * kernel in verus_kernel.h.
+ * 
+ * Copyright (c) 2018 Michael Toutonghi
+ * Ported to BloxMiner by Bokiko, 2026.
+ * 
+ * Licensed under Apache 2.0
+ */
+
+#include "verus_kernel.h"
+#include <string.h>
+#include <stdlib.h>
+
+// Global CPU optimization flag
+int __cpuverusoptimized = 0x80;
+
+// Thread-local key storage
+__thread void *verusclhasher_key = NULL;
+__thread verusclhash_descr *verusclhasher_descr_ptr = NULL;
+
+// Allocate aligned buffer
+void *alloc_aligned_buffer(uint64_t bufSize) {
+    void *answer = NULL;
+    if (posix_memalign(&answer, sizeof(__m128i) * 2, bufSize)) {
+        return NULL;
+    }
+    return answer;
+}
+
+// Cleanup thread-local resources
+void verus_clhash_cleanup(void) {
+    if (verusclhasher_key) {
+        free(verusclhasher_key);
+        verusclhasher_key = NULL;
+    }
+    if (verusclhasher_descr_ptr) {
+        free(verusclhasher_descr_ptr);
+        verusclhasher_descr_ptr = NULL;
+    }
+}
+
+using verus::ClhashKeyLog;
+using verus::ClhashVersion;
+
+// Legacy entry points take the key mask in bytes and record mutated pointers
+template <ClhashVersion V>
+static __m128i clhash_move_scratch(__m128i *randomsource, const __m128i buf[4], uint64_t keyMask,
+                                   __m128i **pMoveScratch) {
+    const ClhashKeyLog log = {NULL, NULL, NULL, NULL, pMoveScratch};
+
+    // Divide key mask by 16 from bytes to __m128i
+    keyMask >>= 4;
+    if (keyMask == verus::CLHASH_KEY_MASK128) {
+        return verus::CLHASH_KERNELS<false>[static_cast<int>(V)](randomsource, buf, keyMask, log);
+    }
+    return verus::verus_clhash_kernel<V, false, 0>(randomsource, buf, keyMask, log);
+}
+
+// VerusCLHash v2.0 internal implementation
+__m128i __verusclmulwithoutreduction64alignedrepeat(__m128i *randomsource, const __m128i buf[4], uint64_t keyMask, __m128i **pMoveScratch) {
+    return clhash_move_scratch<ClhashVersion::V2_0>(randomsource, buf, keyMask, pMoveScratch);
+}
+
+// VerusCLHash v2.1 internal implementation
+__m128i __verusclmulwithoutreduction64alignedrepeat_sv2_1(__m128i *randomsource, const __m128i buf[4], uint64_t keyMask, __m128i **pMoveScratch) {
+    return clhash_move_scratch<ClhashVersion::V2_1>(randomsource, buf, keyMask, pMoveScratch);
+}
+
+// VerusCLHash v2.2 internal implementation
+__m128i __verusclmulwithoutreduction64alignedrepeat_sv2_2(__m128i *randomsource, const __m128i buf[4], uint64_t keyMask, __m128i **pMoveScratch) {
+    return clhash_move_scratch<ClhashVersion::V2_2>(randomsource, buf, keyMask, pMoveScratch);
+}
+
+// Public API - VerusCLHash v2.0
+uint64_t verusclhash(void *random, const unsigned char buf[64], uint64_t keyMask, __m128i **pMoveScratch) {
+    return verus_clhash_finish(__verusclmulwithoutreduction64alignedrepeat((__m128i *)random, (const __m128i *)buf, keyMask, pMoveScratch));
+}
+
+// Public API - VerusCLHash v2.1
+uint64_t verusclhash_sv2_1(void *random, const unsigned char buf[64], uint64_t keyMask, __m128i **pMoveScratch) {
+    return verus_clhash_finish(__verusclmulwithoutreduction64alignedrepeat_sv2_1((__m128i *)random, (const __m128i *)buf, keyMask, pMoveScratch));
+}
+
+// Public API - VerusCLHash v2.2
+uint64_t verusclhash_sv2_2(void *random, const unsigned char buf[64], uint64_t keyMask, __m128i **pMoveScratch) {
+    return verus_clhash_finish(__verusclmulwithoutreduction64alignedrepeat_sv2_2((__m128i *)random, (const __m128i *)buf, keyMask, pMoveScratch));
+}
+
+// FixKey - restore modified key entries
+// This MUST be called after each CLHash to restore the key for the next hash
+void verus_fixkey(uint32_t *fixrand, uint32_t *fixrandex, u128 *keyback,
+                  u128 *g_prand, u128 *g_prandex) {
+    for (int i = 31; i >= 0; i--) {
+        keyback[fixrandex[i]] = g_prandex[i];
+        keyback[fixrand[i]] = g_prand[i];
+    }
+}
+
+// CLHash v2.2 internal implementation with FixKey capture
+// Note: keyMask should be 511 (already divided by 16)
+__m128i __verusclmulwithoutreduction64alignedrepeat_v2_2_full(
+    __m128i *randomsource,
+    const __m128i buf[4],
+    uint64_t keyMask,
+    uint32_t *fixrand,
+    uint32_t *fixrandex,
+    u128 *g_prand,
+    u128 *g_prandex)
+{
+    const ClhashKeyLog log = {fixrand, fixrandex, g_prand, g_prandex, NULL};
+    if (keyMask == verus::CLHASH_KEY_MASK128) {
+        return verus::verus_clhash_kernel<ClhashVersion::V2_2, true, verus::CLHASH_KEY_MASK128>(
+            randomsource, buf, keyMask, log);
+    }
+    return verus::verus_clhash_kernel<ClhashVersion::V2_2, true, 0>(randomsource, buf, keyMask, log);
+}
+
+// Full verusclhash v2.2 with FixKey support
+uint64_t verusclhashv2_2_full(
+    void *random,
+    const unsigned char buf[64],
+    uint64_t keyMask,
+    uint32_t *fixrand,
+    uint32_t *fixrandex,
+    u128 *g_prand,
+    u128 *g_prandex)
+{
+    // Note: ccminer passes 511 directly (keyMask already divided by 16)
+    (void)keyMask;
+    const ClhashKeyLog log = {fixrand, fixrandex, g_prand, g_prandex, NULL};
+    return verus_clhash_finish(verus::verus_clhash_kernel<ClhashVersion::V2_2, true, verus::CLHASH_KEY_MASK128>(
+        (__m128i *)random, (const __m128i *)buf, verus::CLHASH_KEY_MASK128, log));
+}
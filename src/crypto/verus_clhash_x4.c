@@ -0,0 +1,499 @@
+/*
+ * VerusCLHash v2.2 - experimental 4-lane AVX-512 kernel for BloxMiner
+ *
+ * Lane j of every ZMM register carries the 128-bit state of nonce j. The
+ * per-nonce selector decides which key entries are read and mutated, so
+ * each lane owns a full key copy and the two key entries touched per
+ * iteration are fetched with a 64-bit gather and written back with a
+ * scatter. All eight selector cases are evaluated only for the lanes that
+ * took them and merged back with masked moves. The two integer divisions
+ * (cases 0xc and 0x18) have no vector form and are done per lane.
+ *
+ * Must produce bit-identical results to verusclhashv2_2_full().
+ */
+
+#include "verus_clhash_x4.h"
+#include <string.h>
+
+#ifndef VERUS_NO_AVX512
+
+#define X4_TARGET   __attribute__((target("avx512f,avx512bw,vaes,vpclmulqdq")))
+#define X4_INLINE   static inline __attribute__((always_inline)) X4_TARGET
+
+int verus_x4_supported(void) {
+    static int supported = -1;
+    if (supported >= 0) return supported;
+
+    unsigned int eax, ebx, ecx, edx;
+    supported = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE)) {
+        return supported;
+    }
+
+    // OS must save XMM/YMM (bits 1-2) and opmask/ZMM state (bits 5-7)
+    uint32_t xcr0_lo, xcr0_hi;
+    __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    if ((xcr0_lo & 0xe6) != 0xe6) {
+        return supported;
+    }
+
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        supported = (ebx & bit_AVX512F) && (ebx & bit_AVX512BW) &&
+                    (ecx & bit_VAES) && (ecx & bit_VPCLMULQDQ) &&
+                    IsCPUVerusOptimized();
+    }
+    return supported;
+}
+
+// Lane bitmask (bit j = lane j) to qword mask (two qwords per lane)
+X4_INLINE __mmask8 x4_qmask(unsigned lanes) {
+    return (__mmask8)((lanes & 1) * 0x03 | (lanes & 2) * 0x06 |
+                      (lanes & 4) * 0x0c | (lanes & 8) * 0x18);
+}
+
+// Take lanes of b where set in lanes, a elsewhere
+X4_INLINE __m512i x4_blend(__m512i a, __m512i b, unsigned lanes) {
+    return _mm512_mask_mov_epi64(a, x4_qmask(lanes), b);
+}
+
+// Qword indices of entry idx[j] in lane j's key copy
+X4_INLINE __m512i x4_index(const uint32_t idx[VERUS_X4_LANES]) {
+    const __m512i lane_base = _mm512_set_epi64(
+        3 * VERUS_KEY_SIZE128 * 2 + 1, 3 * VERUS_KEY_SIZE128 * 2,
+        2 * VERUS_KEY_SIZE128 * 2 + 1, 2 * VERUS_KEY_SIZE128 * 2,
+        1 * VERUS_KEY_SIZE128 * 2 + 1, 1 * VERUS_KEY_SIZE128 * 2,
+        1, 0);
+    const __m512i entry = _mm512_set_epi64(idx[3], idx[3], idx[2], idx[2],
+                                           idx[1], idx[1], idx[0], idx[0]);
+    return _mm512_add_epi64(_mm512_slli_epi64(entry, 1), lane_base);
+}
+
+// Advance every lane's index by n key entries
+X4_INLINE __m512i x4_index_add(__m512i index, int n) {
+    return _mm512_add_epi64(index, _mm512_set1_epi64(2 * n));
+}
+
+X4_INLINE __m512i x4_gather(const u128 *key4, __m512i index) {
+    return _mm512_i64gather_epi64(index, (const void *)key4, 8);
+}
+
+X4_INLINE __m512i x4_gather_lanes(const u128 *key4, __m512i index, unsigned lanes) {
+    return _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), x4_qmask(lanes), index,
+                                       (const void *)key4, 8);
+}
+
+X4_INLINE __m512i x4_clmul(__m512i a) {
+    return _mm512_clmulepi64_epi128(a, a, 0x10);
+}
+
+// Per-lane (int64 low qword) % (int32)selector, zero-extended like _mm_cvtsi32_si128
+X4_INLINE __m512i x4_modulo(__m512i v, const uint64_t selector[VERUS_X4_LANES], unsigned lanes,
+                            unsigned *odd_lanes) {
+    int64_t dividend[8] __attribute__((aligned(64)));
+    uint64_t modulo[8] __attribute__((aligned(64))) = {0};
+    _mm512_store_si512((__m512i *)dividend, v);
+
+    unsigned odd = 0;
+    for (int j = 0; j < VERUS_X4_LANES; j++) {
+        if (!(lanes & (1u << j))) continue;
+        const int32_t divisor = (uint32_t)selector[j];
+        modulo[2 * j] = (uint32_t)(dividend[2 * j] % divisor);
+        if (dividend[2 * j] & 1) odd |= 1u << j;
+    }
+    if (odd_lanes) *odd_lanes = odd;
+    return _mm512_load_si512((const __m512i *)modulo);
+}
+
+#define X4_MIX2(s0, s1) \
+    tmp = _mm512_unpacklo_epi32(s0, s1); \
+    s1 = _mm512_unpackhi_epi32(s0, s1); \
+    s0 = tmp;
+
+#define X4_MIX4(s0, s1, s2, s3) \
+    tmp = _mm512_unpacklo_epi32(s0, s1); \
+    s0 = _mm512_unpackhi_epi32(s0, s1); \
+    s1 = _mm512_unpacklo_epi32(s2, s3); \
+    s2 = _mm512_unpackhi_epi32(s2, s3); \
+    s3 = _mm512_unpacklo_epi32(s0, s2); \
+    s0 = _mm512_unpackhi_epi32(s0, s2); \
+    s2 = _mm512_unpackhi_epi32(s1, tmp); \
+    s1 = _mm512_unpacklo_epi32(s1, tmp);
+
+// Two AES rounds on s0/s1 keyed from four consecutive key entries per lane
+#define X4_AES2(s0, s1, key4, index, lanes) \
+    s0 = _mm512_aesenc_epi128(s0, x4_gather_lanes(key4, index, lanes)); \
+    s1 = _mm512_aesenc_epi128(s1, x4_gather_lanes(key4, x4_index_add(index, 1), lanes)); \
+    s0 = _mm512_aesenc_epi128(s0, x4_gather_lanes(key4, x4_index_add(index, 2), lanes)); \
+    s1 = _mm512_aesenc_epi128(s1, x4_gather_lanes(key4, x4_index_add(index, 3), lanes));
+
+// 4x4 transpose of 128-bit blocks: out[k] lane j = block k of in[j]
+X4_INLINE void x4_transpose(const unsigned char *in, __m512i out[4]) {
+    const __m512i r0 = _mm512_loadu_si512((const void *)(in));
+    const __m512i r1 = _mm512_loadu_si512((const void *)(in + 64));
+    const __m512i r2 = _mm512_loadu_si512((const void *)(in + 128));
+    const __m512i r3 = _mm512_loadu_si512((const void *)(in + 192));
+    const __m512i t0 = _mm512_shuffle_i64x2(r0, r1, 0x44);
+    const __m512i t1 = _mm512_shuffle_i64x2(r0, r1, 0xee);
+    const __m512i t2 = _mm512_shuffle_i64x2(r2, r3, 0x44);
+    const __m512i t3 = _mm512_shuffle_i64x2(r2, r3, 0xee);
+    out[0] = _mm512_shuffle_i64x2(t0, t2, 0x88);
+    out[1] = _mm512_shuffle_i64x2(t0, t2, 0xdd);
+    out[2] = _mm512_shuffle_i64x2(t1, t3, 0x88);
+    out[3] = _mm512_shuffle_i64x2(t1, t3, 0xdd);
+}
+
+void verus_fixkey_x4_restore(u128 *key4, const verus_fixkey_x4 *fix) {
+    for (int i = 31; i >= 0; i--) {
+        for (int j = 0; j < VERUS_X4_LANES; j++) {
+            u128 *key = key4 + j * VERUS_KEY_SIZE128;
+            key[fix->fixrandex[i][j]] = fix->prandex[i][j];
+            key[fix->fixrand[i][j]] = fix->prand[i][j];
+        }
+    }
+}
+
+X4_TARGET
+void verusclhashv2_2_x4(u128 *key4, const unsigned char *bufs, uint64_t out[VERUS_X4_LANES],
+                        verus_fixkey_x4 *fix)
+{
+    const uint64_t keyMask = 511;
+
+    // pbuf_copy[e] of every lane
+    __m512i pbuf[4];
+    x4_transpose(bufs, pbuf);
+    pbuf[0] = _mm512_xor_si512(pbuf[0], pbuf[2]);
+    pbuf[1] = _mm512_xor_si512(pbuf[1], pbuf[3]);
+
+    const uint32_t start[VERUS_X4_LANES] = {keyMask + 2, keyMask + 2, keyMask + 2, keyMask + 2};
+    __m512i acc = x4_gather(key4, x4_index(start));
+
+    for (int i = 0; i < 32; i++) {
+        uint64_t lanes_lo[8] __attribute__((aligned(64)));
+        _mm512_store_si512((__m512i *)lanes_lo, acc);
+
+        uint64_t selector[VERUS_X4_LANES];
+        uint32_t prand_idx[VERUS_X4_LANES], prandex_idx[VERUS_X4_LANES];
+        unsigned case_lanes[8] = {0};
+        unsigned e1 = 0, e2 = 0, e3 = 0;
+
+        for (int j = 0; j < VERUS_X4_LANES; j++) {
+            const uint64_t s = lanes_lo[2 * j];
+            selector[j] = s;
+            prand_idx[j] = (s >> 5) & keyMask;
+            prandex_idx[j] = (s >> 32) & keyMask;
+            case_lanes[(s & 0x1c) >> 2] |= 1u << j;
+            if ((s & 3) == 1) e1 |= 1u << j;
+            if ((s & 3) == 2) e2 |= 1u << j;
+            if ((s & 3) == 3) e3 |= 1u << j;
+
+            fix->fixrand[i][j] = prand_idx[j];
+            fix->fixrandex[i][j] = prandex_idx[j];
+        }
+
+        // pbuf[0] and pbuf[(selector & 1) ? -1 : 1] of the scalar kernel are
+        // pbuf_copy[selector & 3] and pbuf_copy[(selector & 3) ^ 1]
+        const __m512i bp = x4_blend(x4_blend(x4_blend(pbuf[0], pbuf[1], e1), pbuf[2], e2), pbuf[3], e3);
+        const __m512i bo = x4_blend(x4_blend(x4_blend(pbuf[1], pbuf[0], e1), pbuf[3], e2), pbuf[2], e3);
+
+        // Every case reads both entries before writing either
+        const __m512i prand_index = x4_index(prand_idx);
+        const __m512i prandex_index = x4_index(prandex_idx);
+        const __m512i p = x4_gather(key4, prand_index);
+        const __m512i x = x4_gather(key4, prandex_index);
+        _mm512_store_si512((__m512i *)fix->prand[i], p);
+        _mm512_store_si512((__m512i *)fix->prandex[i], x);
+
+        __m512i next_acc = acc;
+        __m512i new_p = p;
+        __m512i new_x = x;
+        unsigned prand_first = 0;  // Lanes whose case stores prand before prandex
+
+        if (case_lanes[0]) {
+            const unsigned l = case_lanes[0];
+            __m512i a = _mm512_xor_si512(x4_clmul(_mm512_xor_si512(x, bo)), acc);
+            const __m512i np = _mm512_xor_si512(_mm512_mulhrs_epi16(a, x), x);
+            a = _mm512_xor_si512(x4_clmul(_mm512_xor_si512(p, bp)), a);
+            const __m512i nx = _mm512_xor_si512(_mm512_mulhrs_epi16(a, p), p);
+            next_acc = x4_blend(next_acc, a, l);
+            new_p = x4_blend(new_p, np, l);
+            new_x = x4_blend(new_x, nx, l);
+            prand_first |= l;
+        }
+        if (case_lanes[1]) {
+            const unsigned l = case_lanes[1];
+            __m512i a = _mm512_xor_si512(x4_clmul(_mm512_xor_si512(p, bp)), acc);
+            a = _mm512_xor_si512(x4_clmul(bp), a);
+            const __m512i nx = _mm512_xor_si512(_mm512_mulhrs_epi16(a, p), p);
+            a = _mm512_xor_si512(_mm512_xor_si512(x, bo), a);
+            const __m512i np = _mm512_xor_si512(_mm512_mulhrs_epi16(a, x), x);
+            next_acc = x4_blend(next_acc, a, l);
+            new_p = x4_blend(new_p, np, l);
+            new_x = x4_blend(new_x, nx, l);
+        }
+        if (case_lanes[2]) {
+            const unsigned l = case_lanes[2];
+            __m512i a = _mm512_xor_si512(_mm512_xor_si512(x, bp), acc);
+            const __m512i np = _mm512_xor_si512(_mm512_mulhrs_epi16(a, x), x);
+            a = _mm512_xor_si512(x4_clmul(_mm512_xor_si512(p, bo)), a);
+            a = _mm512_xor_si512(x4_clmul(bo), a);
+            const __m512i nx = _mm512_xor_si512(_mm512_mulhrs_epi16(a, p), p);
+            next_acc = x4_blend(next_acc, a, l);
+            new_p = x4_blend(new_p, np, l);
+            new_x = x4_blend(new_x, nx, l);
+            prand_first |= l;
+        }
+        if (case_lanes[3]) {
+            const unsigned l = case_lanes[3];
+            unsigned odd;
+            __m512i a = _mm512_xor_si512(_mm512_xor_si512(p, bo), acc);
+            a = _mm512_xor_si512(x4_modulo(a, selector, l, &odd), a);
+            const __m512i tempa2 = _mm512_xor_si512(_mm512_mulhrs_epi16(a, p), p);
+
+            // Odd dividend: prandex first, then prand from the mixed acc
+            __m512i a_odd = _mm512_xor_si512(x4_clmul(_mm512_xor_si512(x, bp)), a);
+            a_odd = _mm512_xor_si512(x4_clmul(bp), a_odd);
+            const __m512i np_odd = _mm512_xor_si512(_mm512_mulhrs_epi16(a_odd, x), x);
+
+            // Even dividend: prand takes the old prandex value
+            const __m512i a_even = _mm512_xor_si512(bp, a);
+
+            next_acc = x4_blend(next_acc, x4_blend(a_even, a_odd, odd), l);
+            new_p = x4_blend(new_p, x4_blend(x, np_odd, odd), l);
+            new_x = x4_blend(new_x, tempa2, l);
+            prand_first |= l & ~odd;
+        }
+        if (case_lanes[4]) {
+            const unsigned l = case_lanes[4];
+            __m512i tmp;
+            __m512i t1 = bo;
+            __m512i t2 = bp;
+            X4_AES2(t1, t2, key4, prand_index, l);
+            X4_MIX2(t1, t2);
+            X4_AES2(t1, t2, key4, x4_index_add(prand_index, 4), l);
+            X4_MIX2(t1, t2);
+            X4_AES2(t1, t2, key4, x4_index_add(prand_index, 8), l);
+            X4_MIX2(t1, t2);
+
+            const __m512i a = _mm512_xor_si512(t2, _mm512_xor_si512(t1, acc));
+            const __m512i nx = _mm512_xor_si512(p, _mm512_mulhrs_epi16(a, p));
+            next_acc = x4_blend(next_acc, a, l);
+            new_p = x4_blend(new_p, x, l);
+            new_x = x4_blend(new_x, nx, l);
+            prand_first |= l;
+        }
+        if (case_lanes[5]) {
+            // The monkins loop: 1-8 rounds per lane, run until the longest finishes
+            const unsigned l = case_lanes[5];
+            uint32_t rounds[VERUS_X4_LANES] = {0};
+            uint32_t max_rounds = 0;
+            uint32_t aes_offset[VERUS_X4_LANES] = {0};
+            __m512i tmp;
+            __m512i a = acc;
+
+            for (int j = 0; j < VERUS_X4_LANES; j++) {
+                if (!(l & (1u << j))) continue;
+                rounds[j] = selector[j] >> 61;
+                if (rounds[j] > max_rounds) max_rounds = rounds[j];
+            }
+
+            for (uint32_t t = 0; t <= max_rounds; t++) {
+                unsigned active = 0, clmul_lanes = 0, aes_lanes = 0, odd = 0;
+                uint32_t rc_idx[VERUS_X4_LANES], aes_idx[VERUS_X4_LANES];
+                for (int j = 0; j < VERUS_X4_LANES; j++) {
+                    rc_idx[j] = prand_idx[j] + t;
+                    aes_idx[j] = prand_idx[j] + t + 1 + aes_offset[j];
+                    if (!(l & (1u << j)) || t > rounds[j]) continue;
+                    const uint32_t r = rounds[j] - t;
+                    active |= 1u << j;
+                    if (r & 1) odd |= 1u << j;
+                    if (selector[j] & (((uint64_t)0x10000000) << r)) {
+                        clmul_lanes |= 1u << j;
+                    } else {
+                        aes_lanes |= 1u << j;
+                        aes_offset[j] += 4;
+                    }
+                }
+
+                const __m512i rc0 = x4_gather_lanes(key4, x4_index(rc_idx), active);
+                if (clmul_lanes) {
+                    const __m512i temp2 = x4_blend(bo, bp, odd);
+                    const __m512i add1 = _mm512_xor_si512(rc0, temp2);
+                    a = x4_blend(a, _mm512_xor_si512(x4_clmul(add1), a), clmul_lanes);
+                }
+                if (aes_lanes) {
+                    __m512i onekey = rc0;
+                    __m512i temp2 = x4_blend(bp, bo, odd);
+                    const __m512i aes_index = x4_index(aes_idx);
+                    X4_AES2(onekey, temp2, key4, aes_index, aes_lanes);
+                    X4_MIX2(onekey, temp2);
+                    a = x4_blend(a, _mm512_xor_si512(temp2, _mm512_xor_si512(onekey, a)), aes_lanes);
+                }
+            }
+
+            const __m512i nx = _mm512_xor_si512(p, _mm512_mulhrs_epi16(a, p));
+            next_acc = x4_blend(next_acc, a, l);
+            new_p = x4_blend(new_p, x, l);
+            new_x = x4_blend(new_x, nx, l);
+        }
+        if (case_lanes[6]) {
+            const unsigned l = case_lanes[6];
+            uint32_t rounds[VERUS_X4_LANES] = {0};
+            uint32_t max_rounds = 0;
+            __m512i a = acc;
+            __m512i onekey = _mm512_setzero_si512();
+
+            for (int j = 0; j < VERUS_X4_LANES; j++) {
+                if (!(l & (1u << j))) continue;
+                rounds[j] = selector[j] >> 61;
+                if (rounds[j] > max_rounds) max_rounds = rounds[j];
+            }
+
+            for (uint32_t t = 0; t <= max_rounds; t++) {
+                unsigned active = 0, div_lanes = 0, mul_lanes = 0, odd = 0;
+                uint32_t rc_idx[VERUS_X4_LANES];
+                for (int j = 0; j < VERUS_X4_LANES; j++) {
+                    rc_idx[j] = prand_idx[j] + t;
+                    if (!(l & (1u << j)) || t > rounds[j]) continue;
+                    const uint32_t r = rounds[j] - t;
+                    active |= 1u << j;
+                    if (r & 1) odd |= 1u << j;
+                    if (selector[j] & (((uint64_t)0x10000000) << r)) {
+                        div_lanes |= 1u << j;
+                    } else {
+                        mul_lanes |= 1u << j;
+                    }
+                }
+
+                const __m512i rc0 = x4_gather_lanes(key4, x4_index(rc_idx), active);
+                if (div_lanes) {
+                    const __m512i key = _mm512_xor_si512(rc0, x4_blend(bo, bp, odd));
+                    onekey = x4_blend(onekey, key, div_lanes);
+                    a = _mm512_xor_si512(x4_modulo(key, selector, div_lanes, NULL), a);
+                }
+                if (mul_lanes) {
+                    const __m512i add1 = _mm512_xor_si512(rc0, x4_blend(bp, bo, odd));
+                    const __m512i key = x4_clmul(add1);
+                    onekey = x4_blend(onekey, key, mul_lanes);
+                    a = x4_blend(a, _mm512_xor_si512(_mm512_mulhrs_epi16(a, key), a), mul_lanes);
+                }
+            }
+
+            next_acc = x4_blend(next_acc, a, l);
+            new_p = x4_blend(new_p, _mm512_xor_si512(x, a), l);
+            new_x = x4_blend(new_x, onekey, l);
+        }
+        if (case_lanes[7]) {
+            const unsigned l = case_lanes[7];
+            __m512i a = _mm512_xor_si512(x4_clmul(_mm512_xor_si512(bp, x)), acc);
+            const __m512i np = _mm512_xor_si512(_mm512_mulhrs_epi16(a, x), x);
+            a = _mm512_xor_si512(p, a);
+            a = _mm512_xor_si512(bo, a);
+            const __m512i nx = _mm512_xor_si512(_mm512_mulhrs_epi16(a, p), p);
+            next_acc = x4_blend(next_acc, a, l);
+            new_p = x4_blend(new_p, np, l);
+            new_x = x4_blend(new_x, nx, l);
+            prand_first |= l;
+        }
+
+        // Write back in each lane's scalar store order so prand == prandex
+        // resolves to the same value
+        const __m512i first_index = x4_blend(prandex_index, prand_index, prand_first);
+        const __m512i second_index = x4_blend(prand_index, prandex_index, prand_first);
+        _mm512_i64scatter_epi64((void *)key4, first_index, x4_blend(new_x, new_p, prand_first), 8);
+        _mm512_i64scatter_epi64((void *)key4, second_index, x4_blend(new_p, new_x, prand_first), 8);
+
+        acc = next_acc;
+    }
+
+    // Length hash and modular reduction, per lane
+    const __m128i lengthvector = _mm_set_epi64x(1024, 64);
+    acc = _mm512_xor_si512(acc, _mm512_broadcast_i32x4(_mm_clmulepi64_si128(lengthvector, lengthvector, 0x10)));
+
+    const __m512i c = _mm512_broadcast_i32x4(_mm_cvtsi64_si128((1U << 4) + (1U << 3) + (1U << 1) + (1U << 0)));
+    const __m512i q2 = _mm512_clmulepi64_epi128(acc, c, 0x01);
+    const __m512i q3 = _mm512_shuffle_epi8(
+        _mm512_broadcast_i32x4(_mm_setr_epi8(0, 27, 54, 45, 108, 119, 90, 65,
+                                             (char)216, (char)195, (char)238, (char)245,
+                                             (char)180, (char)175, (char)130, (char)153)),
+        _mm512_bsrli_epi128(q2, 8));
+    const __m512i final = _mm512_xor_si512(q3, _mm512_xor_si512(q2, acc));
+
+    uint64_t result[8] __attribute__((aligned(64)));
+    _mm512_store_si512((__m512i *)result, final);
+    for (int j = 0; j < VERUS_X4_LANES; j++) {
+        out[j] = result[2 * j];
+    }
+}
+
+X4_TARGET
+void haraka512_keyed_x4(unsigned char *out, const unsigned char *in, const u128 *key4,
+                        const uint64_t offsets[VERUS_X4_LANES])
+{
+    __m512i s[4], tmp;
+    x4_transpose(in, s);
+
+    // Round key r of lane j is key4[j * VERUS_KEY_SIZE128 + offsets[j] + r]
+    const uint32_t start[VERUS_X4_LANES] = {
+        (uint32_t)offsets[0], (uint32_t)offsets[1], (uint32_t)offsets[2], (uint32_t)offsets[3]
+    };
+    const __m512i index = x4_index(start);
+
+    for (int round = 0; round < 5; round++) {
+        const int r = round * 8;
+        s[0] = _mm512_aesenc_epi128(s[0], x4_gather(key4, x4_index_add(index, r + 0)));
+        s[1] = _mm512_aesenc_epi128(s[1], x4_gather(key4, x4_index_add(index, r + 1)));
+        s[2] = _mm512_aesenc_epi128(s[2], x4_gather(key4, x4_index_add(index, r + 2)));
+        s[3] = _mm512_aesenc_epi128(s[3], x4_gather(key4, x4_index_add(index, r + 3)));
+        s[0] = _mm512_aesenc_epi128(s[0], x4_gather(key4, x4_index_add(index, r + 4)));
+        s[1] = _mm512_aesenc_epi128(s[1], x4_gather(key4, x4_index_add(index, r + 5)));
+        s[2] = _mm512_aesenc_epi128(s[2], x4_gather(key4, x4_index_add(index, r + 6)));
+        s[3] = _mm512_aesenc_epi128(s[3], x4_gather(key4, x4_index_add(index, r + 7)));
+        X4_MIX4(s[0], s[1], s[2], s[3]);
+    }
+
+    __m512i feed[4];
+    x4_transpose(in, feed);
+
+    uint64_t lanes[4][8] __attribute__((aligned(64)));
+    for (int k = 0; k < 4; k++) {
+        _mm512_store_si512((__m512i *)lanes[k], _mm512_xor_si512(s[k], feed[k]));
+    }
+
+    // TRUNCSTORE per lane
+    for (int j = 0; j < VERUS_X4_LANES; j++) {
+        uint64_t *o = (uint64_t *)(out + 32 * j);
+        o[0] = lanes[0][2 * j + 1];
+        o[1] = lanes[1][2 * j + 1];
+        o[2] = lanes[2][2 * j];
+        o[3] = lanes[3][2 * j];
+    }
+}
+
+#else // VERUS_NO_AVX512
+
+int verus_x4_supported(void) {
+    return 0;
+}
+
+void verus_fixkey_x4_restore(u128 *key4, const verus_fixkey_x4 *fix) {
+    (void)key4;
+    (void)fix;
+}
+
+void verusclhashv2_2_x4(u128 *key4, const unsigned char *bufs, uint64_t out[VERUS_X4_LANES],
+                        verus_fixkey_x4 *fix) {
+    (void)key4;
+    (void)bufs;
+    (void)fix;
+    memset(out, 0, sizeof(uint64_t) * VERUS_X4_LANES);
+}
+
+void haraka512_keyed_x4(unsigned char *out, const unsigned char *in, const u128 *key4,
+                        const uint64_t offsets[VERUS_X4_LANES]) {
+    (void)in;
+    (void)key4;
+    (void)offsets;
+    memset(out, 0, 32 * VERUS_X4_LANES);
+}
+
+#endif // VERUS_NO_AVX512
@@ -0,0 +1,68 @@
+/*
+ * VerusCLHash v2.2 - experimental 4-lane AVX-512 kernel for BloxMiner
+ *
+ * Hashes four nonces at once, one per 128-bit lane of a ZMM register.
+ * Each lane has its own copy of the CLHash key; key reads and writes are
+ * AVX-512 gathers/scatters and the eight selector cases are applied as
+ * masked blends. Requires AVX512F/BW, VAES and VPCLMULQDQ at runtime.
+ */
+
+#ifndef BLOXMINER_VERUS_CLHASH_X4_H
+#define BLOXMINER_VERUS_CLHASH_X4_H
+
+#include <stdint.h>
+#include "verus_clhash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VERUS_X4_LANES      4
+
+// Four lane-major key copies: lane j owns entries [j * VERUS_KEY_SIZE128, (j + 1) * VERUS_KEY_SIZE128)
+#define VERUS_X4_KEY_SIZE   (VERUSKEYSIZE * VERUS_X4_LANES)
+
+// Per-lane FixKey state for restoring the four key copies after each x4 hash
+typedef struct {
+    uint32_t fixrand[32][VERUS_X4_LANES];
+    uint32_t fixrandex[32][VERUS_X4_LANES];
+    u128 prand[32][VERUS_X4_LANES] __attribute__((aligned(64)));
+    u128 prandex[32][VERUS_X4_LANES] __attribute__((aligned(64)));
+} verus_fixkey_x4;
+
+/**
+ * Check for AVX512F/BW, VAES, VPCLMULQDQ and OS support for ZMM state
+ * @return 1 if the x4 kernels can run on this CPU
+ */
+int verus_x4_supported(void);
+
+/**
+ * Undo the key mutations recorded by the last verusclhashv2_2_x4() call
+ */
+void verus_fixkey_x4_restore(u128 *key4, const verus_fixkey_x4 *fix);
+
+/**
+ * CLHash v2.2 over four 64-byte buffers, each against its own key copy
+ *
+ * @param key4   VERUS_X4_KEY_SIZE bytes, 64-byte aligned
+ * @param bufs   4 * 64 bytes, lane j at bufs + 64 * j
+ * @param out    Four 64-bit reduced CLHash results
+ * @param fix    FixKey state, filled for verus_fixkey_x4_restore()
+ */
+void verusclhashv2_2_x4(u128 *key4, const unsigned char *bufs, uint64_t out[VERUS_X4_LANES],
+                        verus_fixkey_x4 *fix);
+
+/**
+ * Keyed Haraka512 over four inputs, lane j keyed from key4 lane j at offsets[j]
+ *
+ * @param out     4 * 32 bytes, lane j at out + 32 * j
+ * @param in      4 * 64 bytes, lane j at in + 64 * j
+ */
+void haraka512_keyed_x4(unsigned char *out, const unsigned char *in, const u128 *key4,
+                        const uint64_t offsets[VERUS_X4_LANES]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLOXMINER_VERUS_CLHASH_X4_H
@@ -7,9 +7,12 @@
  */
 
 #include "verus_hash.h"
+#include "verus_kernel.h"
+#include "verus_batch.h"
 #include <cstring>
 #include <algorithm>
 #include <cstdio>
+#include <cstdlib>
 
 // Global initialization flag
 static int g_verus_initialized = 0;
@@ -76,11 +79,15 @@ Hasher::Hasher(int solutionVersion) :
     m_curPos(0),
     m_headerLen(0),
     m_solutionVersion(solutionVersion),
+    m_clhashKernel(clhash_kernel_for<false>(solutionVersion)),
     m_cachedKey(nullptr),
     m_cachedKeySize(0),
     m_keyPrepared(false),
     m_pristineKey(nullptr),
-    m_firstHashAfterPrepare(true)
+    m_firstHashAfterPrepare(true),
+    m_keyX4(nullptr),
+    m_fixX4(nullptr),
+    m_firstX4AfterPrepare(true)
 {
     verus_hash_init();
     
@@ -110,12 +117,17 @@ Hasher::Hasher(int solutionVersion) :
     memset(m_fixRandEx, 0, sizeof(m_fixRandEx));
     memset(m_pRand, 0, sizeof(m_pRand));
     memset(m_pRandEx, 0, sizeof(m_pRandEx));
+    memset(m_keyIntermediate, 0, sizeof(m_keyIntermediate));
     
     reset();
 }
 
 Hasher::~Hasher() {
-    // Thread-local resources are cleaned up when thread exits
+    // Thread-local key is shared by every Hasher on this thread and released
+    // with verus_clhash_cleanup(); the pristine backup is per-instance
+    free(m_pristineKey);
+    free(m_keyX4);
+    free(m_fixX4);
 }
 
 void Hasher::reset() {
@@ -236,29 +248,10 @@ void Hasher::finalize2b(uint8_t* hash) {
     
     uint64_t keyrefreshsize = m_keyMask + 1;
     __m128i** pMoveScratch = (__m128i**)((uint8_t*)m_cachedKey + verusclhasher_descr_ptr->keySizeInBytes + keyrefreshsize);
-    
-    __m128i acc;
-    if (m_solutionVersion >= SOLUTION_VERUSHHASH_V2_2) {
-        acc = __verusclmulwithoutreduction64alignedrepeat_sv2_2(m_cachedKey, (const __m128i*)m_curBuf, m_keyMask, pMoveScratch);
-    } else if (m_solutionVersion >= SOLUTION_VERUSHHASH_V2_1) {
-        acc = __verusclmulwithoutreduction64alignedrepeat_sv2_1(m_cachedKey, (const __m128i*)m_curBuf, m_keyMask, pMoveScratch);
-    } else {
-        acc = __verusclmulwithoutreduction64alignedrepeat(m_cachedKey, (const __m128i*)m_curBuf, m_keyMask, pMoveScratch);
-    }
-    
-    const __m128i lengthvector = _mm_set_epi64x(1024, 64);
-    const __m128i clprod1 = _mm_clmulepi64_si128(lengthvector, lengthvector, 0x10);
-    acc = _mm_xor_si128(acc, clprod1);
-    
-    const __m128i C = _mm_cvtsi64_si128((1U<<4)+(1U<<3)+(1U<<1)+(1U<<0));
-    __m128i Q2 = _mm_clmulepi64_si128(acc, C, 0x01);
-    __m128i Q3 = _mm_shuffle_epi8(_mm_setr_epi8(0, 27, 54, 45, 108, 119, 90, 65, 
-                                                (char)216, (char)195, (char)238, (char)245, 
-                                                (char)180, (char)175, (char)130, (char)153),
-                                  _mm_srli_si128(Q2, 8));
-    __m128i Q4 = _mm_xor_si128(Q2, acc);
-    acc = _mm_xor_si128(Q3, Q4);
-    uint64_t intermediate = _mm_cvtsi128_si64(acc);
+    const ClhashKeyLog log = {nullptr, nullptr, nullptr, nullptr, pMoveScratch};
+
+    // Variant was fixed by the solution version at construction
+    uint64_t intermediate = verus_clhash_finish(m_clhashKernel(m_cachedKey, (const __m128i*)m_curBuf, m_keyMask >> 4, log));
     
     fillExtra64(intermediate);
     haraka512_keyed(hash, m_curBuf, m_cachedKey + intermediateTo128Offset(intermediate));
@@ -330,6 +323,7 @@ void Hasher::prepare_key(const uint8_t* intermediate64) {
     // This must be called once per job after hash_half
     genNewCLKey(intermediate64);
     m_keyPrepared = (m_cachedKey != nullptr);
+    memcpy(m_keyIntermediate, intermediate64, 64);
 
     // Save pristine copy of key for restoration before each hash
     // This is more reliable than the FixKey mechanism
@@ -339,6 +333,7 @@ void Hasher::prepare_key(const uint8_t* intermediate64) {
 
     // First hash after prepare_key needs full pristine key copy
     m_firstHashAfterPrepare = true;
+    m_firstX4AfterPrepare = true;
 }
 
 void Hasher::hash_with_nonce(const uint8_t* intermediate64, const uint8_t* nonceSpace15, uint8_t* output) {
@@ -418,10 +413,167 @@ void Hasher::hash_with_nonce(const uint8_t* intermediate64, const uint8_t* nonce
     // Key restoration happens at the start of next hash_with_nonce call
 }
 
-void Hasher::hash_batch(const uint32_t* nonces, uint8_t* outputs, size_t count) {
-    for (size_t i = 0; i < count; i++) {
-        hash(nonces[i], outputs + i * 32);
+void Hasher::prepare_job(const uint8_t* block, const uint8_t* nonceSpace15, const uint8_t* target32,
+                         JobContext& job) {
+    alignas(32) uint8_t work[1536];
+    memcpy(work, block, VERUS_BLOCK_SIZE);
+    memset(work + VERUS_BLOCK_SIZE, 0, sizeof(work) - VERUS_BLOCK_SIZE);
+    verus_block_canonicalize(work);
+
+    hash_half(work, VERUS_BLOCK_SIZE, job.intermediate);
+    prepare_key(job.intermediate);
+
+    memset(job.nonceSpace, 0, sizeof(job.nonceSpace));
+    memcpy(job.nonceSpace, nonceSpace15, 15);
+    memcpy(job.target, target32, 32);
+}
+
+uint32_t Hasher::scan(const JobContext& job, uint32_t first, uint32_t count, uint32_t stride,
+                      CandidateSink& sink) {
+    const uint8_t* intermediate64 = job.intermediate;
+    const uint8_t* target = job.target;
+
+    if (sink.full()) {
+        return 0;
+    }
+
+    if (!m_keyPrepared || !m_cachedKey || !m_pristineKey ||
+        memcmp(m_keyIntermediate, intermediate64, 64) != 0) {
+        prepare_key(intermediate64);
+        if (!m_cachedKey || !m_pristineKey) {
+            return count;
+        }
     }
+
+    // Rows of curBuf that do not depend on the nonce, computed once per scan
+    // (same FillExtra as hash_with_nonce): row 2 is nonceSpace with the mining
+    // nonce cleared, followed by intermediate[0]; row 3 is fill1
+    const __m128i row0 = _mm_loadu_si128((const __m128i*)intermediate64);
+    const __m128i row1 = _mm_loadu_si128((const __m128i*)(intermediate64 + 16));
+    const __m128i shuf1 = _mm_setr_epi8(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0);
+    const __m128i fill1 = _mm_shuffle_epi8(row0, shuf1);
+    alignas(16) uint8_t noncerow[16] = {0};
+    memcpy(noncerow, job.nonceSpace, 11);
+    noncerow[15] = intermediate64[0];
+    const __m128i row2 = _mm_load_si128((const __m128i*)noncerow);
+    const __m128i shuf2 = _mm_setr_epi8(1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7, 0);
+
+    // Most significant target qword: rejects almost every hash with one compare
+    uint64_t target_hi;
+    memcpy(&target_hi, target + 24, 8);
+
+    const ClhashKeyLog keylog = {m_fixRand, m_fixRandEx, m_pRand, m_pRandEx, nullptr};
+
+    uint32_t nonce = first;
+    uint32_t done = 0;
+    while (done < count) {
+        if (m_firstHashAfterPrepare) {
+            memcpy(m_cachedKey, m_pristineKey, VERUSKEYSIZE);
+            m_firstHashAfterPrepare = false;
+        } else {
+            for (int i = 31; i >= 0; i--) {
+                m_cachedKey[m_fixRandEx[i]] = m_pRandEx[i];
+                m_cachedKey[m_fixRand[i]] = m_pRand[i];
+            }
+        }
+
+        // Mining nonce into bytes 11-14 of row 2
+        const __m128i noncevec = _mm_or_si128(row2, _mm_slli_si128(_mm_cvtsi32_si128((int)nonce), 11));
+        const __m128i buf[4] = {row0, row1, noncevec, fill1};
+
+        const uint64_t clhash_result = verus_clhash_finish(
+            verus_clhash_kernel<ClhashVersion::V2_2, true, CLHASH_KEY_MASK128>(
+                m_cachedKey, buf, CLHASH_KEY_MASK128, keylog));
+
+        // FillExtra with the CLHash result: byte 47 and row 3
+        const __m128i fill2 = _mm_shuffle_epi8(_mm_cvtsi64_si128((long long)clhash_result), shuf2);
+        const __m128i row2b = _mm_insert_epi8(noncevec, (int)(clhash_result & 0xff), 15);
+
+        // Keyed Haraka512: round keys come from the per-nonce key offset, so they
+        // are loaded from the (L1-resident) key rather than held in registers
+        alignas(32) uint8_t hash[32];
+        haraka512_keyed_rows(hash, row0, row1, row2b, fill2, m_cachedKey + (clhash_result & 511));
+
+        done++;
+
+        uint64_t hash_hi;
+        memcpy(&hash_hi, hash + 24, 8);
+        if (hash_hi <= target_hi && verus_hash_meets_target(hash, target)) {
+            sink.nonces[sink.count++] = nonce;
+            if (sink.full()) break;
+        }
+
+        nonce += stride;
+    }
+
+    return done;
+}
+
+void Hasher::hash_with_nonce_x4(const uint8_t* intermediate64, const uint8_t* nonceSpaces15, uint8_t* output) {
+    if (!m_keyX4 && verus_x4_supported()) {
+        void* key = nullptr;
+        void* fix = nullptr;
+        if (posix_memalign(&key, 64, VERUS_X4_KEY_SIZE) == 0 &&
+            posix_memalign(&fix, 64, sizeof(verus_fixkey_x4)) == 0) {
+            m_keyX4 = (u128*)key;
+            m_fixX4 = (verus_fixkey_x4*)fix;
+            m_firstX4AfterPrepare = true;
+        } else {
+            free(key);
+        }
+    }
+
+    if (!m_keyX4) {
+        for (int j = 0; j < VERUS_X4_LANES; j++) {
+            hash_with_nonce(intermediate64, nonceSpaces15 + 15 * j, output + 32 * j);
+        }
+        return;
+    }
+
+    if (!m_keyPrepared || !m_cachedKey || !m_pristineKey) {
+        prepare_key(intermediate64);
+        if (!m_cachedKey || !m_pristineKey) {
+            memset(output, 0, 32 * VERUS_X4_LANES);
+            return;
+        }
+    }
+
+    // Same restore scheme as hash_with_nonce(), once per lane copy
+    if (m_firstX4AfterPrepare) {
+        for (int j = 0; j < VERUS_X4_LANES; j++) {
+            memcpy(m_keyX4 + j * VERUS_KEY_SIZE128, m_pristineKey, VERUSKEYSIZE);
+        }
+        m_firstX4AfterPrepare = false;
+    } else {
+        verus_fixkey_x4_restore(m_keyX4, m_fixX4);
+    }
+
+    // FillExtra and nonceSpace per lane, as in hash_with_nonce()
+    alignas(64) uint8_t curBufs[64 * VERUS_X4_LANES];
+    const __m128i shuf1 = _mm_setr_epi8(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0);
+    const __m128i fill1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)intermediate64), shuf1);
+    for (int j = 0; j < VERUS_X4_LANES; j++) {
+        uint8_t* curBuf = curBufs + 64 * j;
+        memcpy(curBuf, intermediate64, 64);
+        _mm_store_si128((__m128i*)(curBuf + 48), fill1);
+        curBuf[47] = intermediate64[0];
+        memcpy(curBuf + 32, nonceSpaces15 + 15 * j, 15);
+    }
+
+    uint64_t clhash_results[VERUS_X4_LANES];
+    verusclhashv2_2_x4(m_keyX4, curBufs, clhash_results, m_fixX4);
+
+    const __m128i shuf2 = _mm_setr_epi8(1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7, 0);
+    uint64_t keyOffsets[VERUS_X4_LANES];
+    for (int j = 0; j < VERUS_X4_LANES; j++) {
+        uint8_t* curBuf = curBufs + 64 * j;
+        __m128i fill2 = _mm_shuffle_epi8(_mm_loadl_epi64((const __m128i*)&clhash_results[j]), shuf2);
+        _mm_store_si128((__m128i*)(curBuf + 48), fill2);
+        curBuf[47] = ((const uint8_t*)&clhash_results[j])[0];
+        keyOffsets[j] = clhash_results[j] & 511;
+    }
+
+    haraka512_keyed_x4(output, curBufs, m_keyX4, keyOffsets);
 }
 
 } // namespace verus
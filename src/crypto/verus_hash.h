@@ -18,6 +18,7 @@ extern "C" {
 
 #include "haraka.h"
 #include "verus_clhash.h"
+#include "verus_clhash_x4.h"
 
 // Hash output size
 #define VERUSHASH_SIZE 32
@@ -62,21 +63,49 @@ int verus_hash_supported(void);
 // C++ class for mining operations
 namespace verus {
 
+// CLHash kernel family, see verus_kernel.h
+struct ClhashKeyLog;
+typedef __m128i (*ClhashKernelFn)(__m128i *randomsource, const __m128i buf[4], uint64_t keyMask128,
+                                  const ClhashKeyLog &log);
+
+/**
+ * Per-job input to Hasher::scan(), built by Hasher::prepare_job()
+ */
+struct JobContext {
+    alignas(32) uint8_t intermediate[64];  // hash_half() of the canonical block
+    alignas(16) uint8_t nonceSpace[16];    // 15-byte nonce space; bytes 11-14 hold the mining nonce
+    alignas(32) uint8_t target[32];        // Little-endian share target
+};
+
+/**
+ * Fixed-capacity buffer of nonces that met the target during a scan
+ */
+struct CandidateSink {
+    static constexpr uint32_t CAPACITY = 16;
+
+    uint32_t nonces[CAPACITY];
+    uint32_t count = 0;
+
+    bool full() const { return count >= CAPACITY; }
+    void clear() { count = 0; }
+};
+
 /**
  * Mining-optimized VerusHash v2.2 hasher
  * 
- * Usage for stratum mining (two-stage approach):
+ * Usage for stratum mining:
  * 
  * 1. When new job arrives:
  *    - Build full block (140-byte header + 1347-byte solution)
- *    - Clear non-canonical fields for merged mining
- *    - Call hash_half() to compute 64-byte intermediate state
- *    - Call prepare_key() to generate CLHash key (done once per job)
+ *    - Call prepare_job() to canonicalize it, compute the intermediate
+ *      state and generate the CLHash key (done once per job)
  * 
- * 2. For each nonce:
- *    - Update nonceSpace with current mining nonce
- *    - Call hash_with_nonce() to compute final 32-byte hash
- *    - Check if hash meets target
+ * 2. For each range of nonces:
+ *    - Call scan() - it owns the hot loop and reports only the nonces
+ *      whose hash meets the target
+ *
+ * hash_half(), prepare_key() and hash_with_nonce() remain available for
+ * hashing a single nonce (share verification, tests).
  */
 class Hasher {
 public:
@@ -123,12 +152,46 @@ public:
      */
     void hash_with_nonce(const uint8_t* intermediate64, const uint8_t* nonceSpace15, uint8_t* output);
 
-    // Batch hash for better throughput  
-    void hash_batch(const uint32_t* nonces, uint8_t* outputs, size_t count);
+    /**
+     * Set up a job for scan(): canonicalize a copy of the block, compute its
+     * intermediate state and generate the CLHash key for this hasher
+     *
+     * @param block       Full 1487-byte block (not modified)
+     * @param nonceSpace15 15-byte nonce space; bytes 11-14 are replaced per nonce
+     * @param target32    32-byte little-endian target
+     * @param job         Output job context
+     */
+    void prepare_job(const uint8_t* block, const uint8_t* nonceSpace15, const uint8_t* target32,
+                     JobContext& job);
+
+    /**
+     * Hash nonce = first + k * stride for k < count and push every nonce whose
+     * hash meets job.target into sink. FillExtra, CLHash, keyed Haraka512 and
+     * the target check run as one inlined loop with the intermediate and
+     * target in registers. Stops early once sink is full.
+     *
+     * @return Number of nonces hashed (count unless sink filled)
+     */
+    uint32_t scan(const JobContext& job, uint32_t first, uint32_t count, uint32_t stride,
+                  CandidateSink& sink);
+
+    /**
+     * Stage 3 for four nonces at once (experimental 4-lane AVX-512 kernel)
+     * Falls back to four hash_with_nonce() calls when x4_supported() is false.
+     * Results are identical to the scalar path.
+     *
+     * @param intermediate64 The 64-byte intermediate from hash_half()
+     * @param nonceSpaces15  Four 15-byte nonce spaces, back to back (60 bytes)
+     * @param output         Four 32-byte hash outputs, back to back (128 bytes)
+     */
+    void hash_with_nonce_x4(const uint8_t* intermediate64, const uint8_t* nonceSpaces15, uint8_t* output);
 
     // Check CPU support
     static bool supported() { return verus_hash_supported() != 0; }
 
+    // Check CPU support for the 4-lane AVX-512 kernel
+    static bool x4_supported() { return verus_x4_supported() != 0; }
+
     // Get key mask
     uint64_t getKeyMask() const { return m_keyMask; }
     
@@ -151,6 +214,9 @@ private:
     uint64_t m_keySize;
     uint64_t m_keyMask;
     int m_solutionVersion;
+
+    // CLHash variant for m_solutionVersion, used by finalize2b()
+    ClhashKernelFn m_clhashKernel;
     
     // Cached key material for two-stage mining
     // Generated once per job by prepare_key()
@@ -158,6 +224,10 @@ private:
     uint64_t m_cachedKeySize;
     bool m_keyPrepared;
     
+    // Intermediate the cached key was generated from; scan() regenerates
+    // the key if called with a different job
+    alignas(32) uint8_t m_keyIntermediate[64];
+
     // Pristine key backup - restored before each hash_with_nonce
     // This is more efficient than FixKey which has issues
     u128* m_pristineKey;
@@ -172,6 +242,12 @@ private:
     alignas(32) u128 m_pRand[32];
     alignas(32) u128 m_pRandEx[32];
 
+    // Four lane-major key copies and FixKey state for hash_with_nonce_x4()
+    // Allocated on first use so scalar-only hashers do not pay for them
+    u128* m_keyX4;
+    verus_fixkey_x4* m_fixX4;
+    bool m_firstX4AfterPrepare;
+
     // Internal methods
     void reset();
     void write(const uint8_t* data, size_t len);
@@ -1,33 +1,33 @@
 /*
- * VerusCLHash v2.2 Implementation for BloxMiner
- * 
- * This is a complete rewrite matching ccminer's implementation exactly.
- * Includes proper FixKey mechanism for key restoration.
+ * VerusCLHash inlinable kernel family for BloxMiner
+ *
+ * One CLHash body templated on solution version, key-mutation capture and
+ * key mask, plus the reduction and target check as static inline functions.
+ * The fused nonce loop in Hasher::scan() instantiates the v2.2 FixKey
+ * variant with the mask as an immediate; verus_clhash.cpp instantiates the
+ * out-of-line C API and the constexpr dispatch table from the same code.
+ *
+ * C++ only.
  *
- * Based on the official VerusCoin implementation by Michael Toutonghi.
- * Original CLHash by Daniel Lemire.
- * 
  * Copyright (c) 2018 Michael Toutonghi
  * Licensed under Apache 2.0
  */
 
-#include "verus_clhash.h"
-#include <string.h>
-#include <stdlib.h>
+#ifndef BLOXMINER_VERUS_KERNEL_H
+#define BLOXMINER_VERUS_KERNEL_H
 
-// Thread-local key storage
-__thread void *verusclhasher_key_v2 = NULL;
-__thread verusclhash_descr *verusclhasher_descr_ptr_v2 = NULL;
+#include <string.h>
+#include "verus_clhash.h"
 
 // Lazy length hash - multiply length and key
-static inline __attribute__((always_inline)) __m128i lazyLengthHash_v2(uint64_t keylength, uint64_t length) {
+static inline __attribute__((always_inline)) __m128i lazyLengthHash(uint64_t keylength, uint64_t length) {
     const __m128i lengthvector = _mm_set_epi64x(keylength, length);
     const __m128i clprod1 = _mm_clmulepi64_si128(lengthvector, lengthvector, 0x10);
     return clprod1;
 }
 
 // Modulo reduction to 64-bit value
-static inline __attribute__((always_inline)) uint64_t precompReduction64_v2(__m128i A) {
+static inline __attribute__((always_inline)) uint64_t precompReduction64(__m128i A) {
     const __m128i C = _mm_cvtsi64_si128((1U << 4) + (1U << 3) + (1U << 1) + (1U << 0));
     __m128i Q2 = _mm_clmulepi64_si128(A, C, 0x01);
     __m128i Q3 = _mm_shuffle_epi8(_mm_setr_epi8(0, 27, 54, 45, 108, 119, 90, 65,
@@ -39,34 +39,83 @@ static inline __attribute__((always_inline)) uint64_t precompReduction64_v2(__m1
     return _mm_cvtsi128_si64(final);
 }
 
-// FixKey - restore modified key entries
-// This MUST be called after each CLHash to restore the key for the next hash
-void verus_fixkey(uint32_t *fixrand, uint32_t *fixrandex, u128 *keyback,
-                  u128 *g_prand, u128 *g_prandex) {
-    for (int i = 31; i >= 0; i--) {
-        keyback[fixrandex[i]] = g_prandex[i];
-        keyback[fixrand[i]] = g_prand[i];
+// Length hash and reduction of the CLHash accumulator to the 64-bit result
+static inline __attribute__((always_inline)) uint64_t verus_clhash_finish(__m128i acc) {
+    acc = _mm_xor_si128(acc, lazyLengthHash(1024, 64));
+    return precompReduction64(acc);
+}
+
+// hash <= target as 256-bit little-endian numbers, most significant qword first
+static inline __attribute__((always_inline)) int verus_hash_meets_target(const uint8_t *hash, const uint8_t *target) {
+    for (int i = 3; i >= 0; i--) {
+        uint64_t h, t;
+        memcpy(&h, hash + 8 * i, 8);
+        memcpy(&t, target + 8 * i, 8);
+        if (h != t) return h < t;
     }
+    return 1;
 }
 
-// CLHash v2.2 internal implementation - MATCHES CCMINER EXACTLY
-// Note: keyMask should be 511 (already divided by 16)
-__m128i __verusclmulwithoutreduction64alignedrepeat_v2_2_full(
+namespace verus {
+
+// CLHash variants, in solution version order
+enum class ClhashVersion : int {
+    V2_0 = 0,
+    V2_1 = 1,
+    V2_2 = 2,
+};
+
+constexpr int CLHASH_VERSION_COUNT = 3;
+
+// Map a SOLUTION_VERUSHHASH_* constant to the CLHash variant it uses
+constexpr ClhashVersion clhash_version(int solutionVersion) {
+    return solutionVersion >= SOLUTION_VERUSHHASH_V2_2 ? ClhashVersion::V2_2 :
+           solutionVersion >= SOLUTION_VERUSHHASH_V2_1 ? ClhashVersion::V2_1 :
+                                                         ClhashVersion::V2_0;
+}
+
+/**
+ * Where a CLHash call records the 64 key entries it mutates
+ *
+ * FixKey variants fill fixrand/fixrandex/prand/prandex (indices and original
+ * values, for verus_fixkey()); the others fill moveScratch with the 64
+ * mutated entry pointers, prand/prandex interleaved.
+ */
+struct ClhashKeyLog {
+    uint32_t *fixrand;
+    uint32_t *fixrandex;
+    u128 *prand;
+    u128 *prandex;
+    __m128i **moveScratch;
+};
+
+/**
+ * CLHash without reduction
+ *
+ * @tparam V           Solution version variant
+ * @tparam FixKey      Record original key values (true) or mutated pointers (false)
+ * @tparam KeyMask128  Key mask in 128-bit entries, or 0 to use the keyMask128 argument
+ * @return Accumulator for verus_clhash_finish()
+ */
+template <ClhashVersion V, bool FixKey, uint32_t KeyMask128>
+static inline __attribute__((always_inline)) __m128i verus_clhash_kernel(
     __m128i *randomsource,
     const __m128i buf[4],
-    uint64_t keyMask,
-    uint32_t *fixrand,
-    uint32_t *fixrandex,
-    u128 *g_prand,
-    u128 *g_prandex)
+    uint64_t keyMask128,
+    const ClhashKeyLog &log)
 {
-    const __m128i pbuf_copy[4] = {
-        _mm_xor_si128(buf[0], buf[2]),
-        _mm_xor_si128(buf[1], buf[3]),
-        buf[2],
-        buf[3]
-    };
-    const __m128i *pbuf;
+    const uint64_t keyMask = KeyMask128 ? KeyMask128 : keyMask128;
+
+    // v2.1 and later fold the upper half of the input into the lower half
+    __m128i pbuf_copy[4];
+    const __m128i *pbuf_base = buf;
+    if constexpr (V != ClhashVersion::V2_0) {
+        pbuf_copy[0] = _mm_xor_si128(buf[0], buf[2]);
+        pbuf_copy[1] = _mm_xor_si128(buf[1], buf[3]);
+        pbuf_copy[2] = buf[2];
+        pbuf_copy[3] = buf[3];
+        pbuf_base = pbuf_copy;
+    }
 
     // The random buffer must have at least 32 16-byte dwords after the keymask
     // Take the value from the last element inside keyMask + 2
@@ -75,26 +124,32 @@ __m128i __verusclmulwithoutreduction64alignedrepeat_v2_2_full(
     for (int64_t i = 0; i < 32; i++) {
         const uint64_t selector = _mm_cvtsi128_si64(acc);
 
-        uint32_t prand_idx = (selector >> 5) & keyMask;
-        uint32_t prandex_idx = (selector >> 32) & keyMask;
+        const uint32_t prand_idx = (selector >> 5) & keyMask;
+        const uint32_t prandex_idx = (selector >> 32) & keyMask;
 
         // Get two random locations in the key, which will be mutated
         __m128i *prand = randomsource + prand_idx;
         __m128i *prandex = randomsource + prandex_idx;
 
         // Select random start and order of pbuf processing
-        pbuf = pbuf_copy + (selector & 3);
-
-        // Save original values BEFORE modification for FixKey
-        _mm_store_si128(&g_prand[i], prand[0]);
-        _mm_store_si128(&g_prandex[i], prandex[0]);
-        fixrand[i] = prand_idx;
-        fixrandex[i] = prandex_idx;
+        const __m128i *pbuf = pbuf_base + (selector & 3);
+        const __m128i *buftmp = &pbuf[(selector & 1) ? -1 : 1];
+
+        if constexpr (FixKey) {
+            // Save original values BEFORE modification for FixKey
+            _mm_store_si128(&log.prand[i], prand[0]);
+            _mm_store_si128(&log.prandex[i], prandex[0]);
+            log.fixrand[i] = prand_idx;
+            log.fixrandex[i] = prandex_idx;
+        } else {
+            log.moveScratch[2 * i] = prand;
+            log.moveScratch[2 * i + 1] = prandex;
+        }
 
         switch (selector & 0x1c) {
             case 0: {
                 const __m128i temp1 = _mm_load_si128(prandex);
-                const __m128i temp2 = pbuf[(selector & 1) ? -1 : 1];
+                const __m128i temp2 = _mm_load_si128(buftmp);
                 const __m128i add1 = _mm_xor_si128(temp1, temp2);
                 const __m128i clprod1 = _mm_clmulepi64_si128(add1, add1, 0x10);
                 acc = _mm_xor_si128(clprod1, acc);
@@ -130,7 +185,7 @@ __m128i __verusclmulwithoutreduction64alignedrepeat_v2_2_full(
                 const __m128i temp12 = _mm_load_si128(prandex);
                 _mm_store_si128(prandex, tempa2);
 
-                const __m128i temp22 = pbuf[(selector & 1) ? -1 : 1];
+                const __m128i temp22 = _mm_load_si128(buftmp);
                 const __m128i add12 = _mm_xor_si128(temp12, temp22);
                 acc = _mm_xor_si128(add12, acc);
 
@@ -150,7 +205,7 @@ __m128i __verusclmulwithoutreduction64alignedrepeat_v2_2_full(
                 const __m128i temp12 = _mm_load_si128(prand);
                 _mm_store_si128(prand, tempa2);
 
-                const __m128i temp22 = pbuf[(selector & 1) ? -1 : 1];
+                const __m128i temp22 = _mm_load_si128(buftmp);
                 const __m128i add12 = _mm_xor_si128(temp12, temp22);
                 const __m128i clprod12 = _mm_clmulepi64_si128(add12, add12, 0x10);
                 acc = _mm_xor_si128(clprod12, acc);
@@ -164,7 +219,7 @@ __m128i __verusclmulwithoutreduction64alignedrepeat_v2_2_full(
             }
             case 0xc: {
                 const __m128i temp1 = _mm_load_si128(prand);
-                const __m128i temp2 = pbuf[(selector & 1) ? -1 : 1];
+                const __m128i temp2 = _mm_load_si128(buftmp);
                 const __m128i add1 = _mm_xor_si128(temp1, temp2);
 
                 // Cannot be zero here
@@ -193,10 +248,15 @@ __m128i __verusclmulwithoutreduction64alignedrepeat_v2_2_full(
                     const __m128i tempb1 = _mm_mulhrs_epi16(acc, temp12);
                     const __m128i tempb2 = _mm_xor_si128(tempb1, temp12);
                     _mm_store_si128(prand, tempb2);
-                } else {
+                } else if constexpr (V == ClhashVersion::V2_2) {
                     _mm_store_si128(prand, _mm_load_si128(prandex));
                     _mm_store_si128(prandex, tempa2);
                     acc = _mm_xor_si128(_mm_load_si128(pbuf), acc);
+                } else {
+                    // v2.0/v2.1 store prandex first: when prand == prandex the key keeps its old value
+                    const __m128i tempb3 = _mm_load_si128(prandex);
+                    _mm_store_si128(prandex, tempa2);
+                    _mm_store_si128(prand, tempb3);
                 }
                 break;
             }
@@ -207,7 +267,7 @@ __m128i __verusclmulwithoutreduction64alignedrepeat_v2_2_full(
                 const __m128i *rc = prand;
                 __m128i tmp;
 
-                __m128i temp1 = pbuf[(selector & 1) ? -1 : 1];
+                __m128i temp1 = _mm_load_si128(buftmp);
                 __m128i temp2 = _mm_load_si128(pbuf);
 
                 AES2(temp1, temp2, 0);
@@ -224,15 +284,21 @@ __m128i __verusclmulwithoutreduction64alignedrepeat_v2_2_full(
                 const __m128i tempa1 = _mm_load_si128(prand);
                 const __m128i tempa2 = _mm_mulhrs_epi16(acc, tempa1);
 
-                _mm_store_si128(prand, _mm_load_si128(prandex));
-                _mm_store_si128(prandex, _mm_xor_si128(tempa1, tempa2));
+                if constexpr (V == ClhashVersion::V2_2) {
+                    _mm_store_si128(prand, _mm_load_si128(prandex));
+                    _mm_store_si128(prandex, _mm_xor_si128(tempa1, tempa2));
+                } else {
+                    // v2.0/v2.1 store order, as in case 0xc
+                    const __m128i tempa4 = _mm_load_si128(prandex);
+                    _mm_store_si128(prandex, _mm_xor_si128(tempa1, tempa2));
+                    _mm_store_si128(prand, tempa4);
+                }
                 break;
             }
             case 0x14: {
                 // The monkins loop
                 // CRITICAL: Variable MUST be named 'rc' to shadow global rc
                 // so that AES2 macro uses key bytes from the moving pointer
-                const __m128i *buftmp = &pbuf[(selector & 1) ? -1 : 1];
                 __m128i tmp;
 
                 uint64_t rounds = selector >> 61;
@@ -241,7 +307,11 @@ __m128i __verusclmulwithoutreduction64alignedrepeat_v2_2_full(
                 __m128i onekey;
 
                 do {
-                    if (selector & (((uint64_t)0x10000000) << rounds)) {
+                    // v2.0 shifts a 32-bit int: round 3 sign-extends, rounds 4-7 test no bit
+                    const uint64_t roundbit = V == ClhashVersion::V2_0 ?
+                        (uint64_t)(int64_t)(int32_t)(0x10000000U << rounds) :
+                        ((uint64_t)0x10000000) << rounds;
+                    if (selector & roundbit) {
                         const __m128i temp2 = _mm_load_si128(rounds & 1 ? pbuf : buftmp);
                         const __m128i add1 = _mm_xor_si128(rc[0], temp2); rc++;
                         const __m128i clprod1 = _mm_clmulepi64_si128(add1, add1, 0x10);
@@ -267,35 +337,55 @@ __m128i __verusclmulwithoutreduction64alignedrepeat_v2_2_full(
                 break;
             }
             case 0x18: {
-                // CRITICAL: Variable MUST be named 'rc' to shadow global rc
-                const __m128i *buftmp = &pbuf[(selector & 1) ? -1 : 1];
-                __m128i tmp;
+                if constexpr (V == ClhashVersion::V2_0) {
+                    const __m128i temp1 = _mm_load_si128(buftmp);
+                    const __m128i temp2 = _mm_load_si128(prand);
+                    const __m128i add1 = _mm_xor_si128(temp1, temp2);
+                    const __m128i clprod1 = _mm_clmulepi64_si128(add1, add1, 0x10);
+                    acc = _mm_xor_si128(clprod1, acc);
 
-                uint64_t rounds = selector >> 61;
-                __m128i *rc = prand;
-                __m128i onekey;
+                    const __m128i tempa1 = _mm_mulhrs_epi16(acc, temp2);
+                    const __m128i tempa2 = _mm_xor_si128(tempa1, temp2);
 
-                do {
-                    if (selector & (((uint64_t)0x10000000) << rounds)) {
-                        const __m128i temp2 = _mm_load_si128(rounds & 1 ? pbuf : buftmp);
-                        onekey = _mm_xor_si128(rc[0], temp2); rc++;
-                        const int32_t divisor = (uint32_t)selector;
-                        const int64_t dividend = _mm_cvtsi128_si64(onekey);
-                        const __m128i modulo = _mm_cvtsi32_si128(dividend % divisor);
-                        acc = _mm_xor_si128(modulo, acc);
+                    const __m128i tempb3 = _mm_load_si128(prandex);
+                    _mm_store_si128(prandex, tempa2);
+                    _mm_store_si128(prand, tempb3);
+                } else {
+                    uint64_t rounds = selector >> 61;
+                    const __m128i *rc = prand;
+                    __m128i onekey;
+
+                    do {
+                        if (selector & (((uint64_t)0x10000000) << rounds)) {
+                            const __m128i temp2 = _mm_load_si128(rounds & 1 ? pbuf : buftmp);
+                            const __m128i add1 = _mm_xor_si128(rc[0], temp2);
+                            const int32_t divisor = (uint32_t)selector;
+                            const int64_t dividend = _mm_cvtsi128_si64(add1);
+                            const __m128i modulo = _mm_cvtsi32_si128(dividend % divisor);
+                            acc = _mm_xor_si128(modulo, acc);
+                            // v2.2 carries the mixed value forward, v2.1 the raw key
+                            onekey = V == ClhashVersion::V2_2 ? add1 : rc[0];
+                        } else {
+                            __m128i temp2 = _mm_load_si128(rounds & 1 ? buftmp : pbuf);
+                            const __m128i add1 = _mm_xor_si128(rc[0], temp2);
+                            const __m128i clprod1 = _mm_clmulepi64_si128(add1, add1, 0x10);
+                            const __m128i clprod2 = _mm_mulhrs_epi16(acc, clprod1);
+                            acc = _mm_xor_si128(clprod2, acc);
+                            onekey = V == ClhashVersion::V2_2 ? clprod1 : rc[0];
+                        }
+                        rc++;
+                    } while (rounds--);
+
+                    const __m128i tempa3 = _mm_load_si128(prandex);
+
+                    if constexpr (V == ClhashVersion::V2_2) {
+                        _mm_store_si128(prandex, onekey);
+                        _mm_store_si128(prand, _mm_xor_si128(tempa3, acc));
                     } else {
-                        __m128i temp2 = _mm_load_si128(rounds & 1 ? buftmp : pbuf);
-                        const __m128i add1 = _mm_xor_si128(rc[0], temp2); rc++;
-                        onekey = _mm_clmulepi64_si128(add1, add1, 0x10);
-                        const __m128i clprod2 = _mm_mulhrs_epi16(acc, onekey);
-                        acc = _mm_xor_si128(clprod2, acc);
+                        _mm_store_si128(prandex, _mm_xor_si128(tempa3, acc));
+                        _mm_store_si128(prand, onekey);
                     }
-                } while (rounds--);
-
-                const __m128i tempa3 = _mm_load_si128(prandex);
-
-                _mm_store_si128(prandex, onekey);
-                _mm_store_si128(prand, _mm_xor_si128(tempa3, acc));
+                }
                 break;
             }
             case 0x1c: {
@@ -312,10 +402,11 @@ __m128i __verusclmulwithoutreduction64alignedrepeat_v2_2_full(
                 _mm_store_si128(prand, tempa2);
 
                 acc = _mm_xor_si128(tempa3, acc);
-                const __m128i temp4 = pbuf[(selector & 1) ? -1 : 1];
-                acc = _mm_xor_si128(temp4, acc);
+                if constexpr (V == ClhashVersion::V2_2) {
+                    acc = _mm_xor_si128(_mm_load_si128(buftmp), acc);
+                }
                 const __m128i tempb1 = _mm_mulhrs_epi16(acc, tempa3);
-                *prandex = _mm_xor_si128(tempb1, tempa3);
+                _mm_store_si128(prandex, _mm_xor_si128(tempb1, tempa3));
                 break;
             }
         }
@@ -323,20 +414,27 @@ __m128i __verusclmulwithoutreduction64alignedrepeat_v2_2_full(
     return acc;
 }
 
-// Full verusclhash v2.2 with FixKey support
-uint64_t verusclhashv2_2_full(
-    void *random,
-    const unsigned char buf[64],
-    uint64_t keyMask,
-    uint32_t *fixrand,
-    uint32_t *fixrandex,
-    u128 *g_prand,
-    u128 *g_prandex)
-{
-    // Note: ccminer passes 511 directly (keyMask already divided by 16)
-    __m128i acc = __verusclmulwithoutreduction64alignedrepeat_v2_2_full(
-        (__m128i *)random, (const __m128i *)buf, 511,
-        fixrand, fixrandex, g_prand, g_prandex);
-    acc = _mm_xor_si128(acc, lazyLengthHash_v2(1024, 64));
-    return precompReduction64_v2(acc);
+// Key mask in 128-bit entries for the standard VERUSKEYSIZE key (511)
+constexpr uint32_t CLHASH_KEY_MASK128 = (1U << (31 - __builtin_clz(VERUSKEYSIZE))) / 16 - 1;
+
+// Same signature as verus_hash.h declares for Hasher
+typedef __m128i (*ClhashKernelFn)(__m128i *randomsource, const __m128i buf[4], uint64_t keyMask128,
+                                  const ClhashKeyLog &log);
+
+// Out-of-line variants for the standard key, indexed by ClhashVersion
+template <bool FixKey>
+static constexpr ClhashKernelFn CLHASH_KERNELS[CLHASH_VERSION_COUNT] = {
+    verus_clhash_kernel<ClhashVersion::V2_0, FixKey, CLHASH_KEY_MASK128>,
+    verus_clhash_kernel<ClhashVersion::V2_1, FixKey, CLHASH_KEY_MASK128>,
+    verus_clhash_kernel<ClhashVersion::V2_2, FixKey, CLHASH_KEY_MASK128>,
+};
+
+// Kernel for a SOLUTION_VERUSHHASH_* constant and the standard key
+template <bool FixKey>
+constexpr ClhashKernelFn clhash_kernel_for(int solutionVersion) {
+    return CLHASH_KERNELS<FixKey>[static_cast<int>(clhash_version(solutionVersion))];
 }
+
+} // namespace verus
+
+#endif // BLOXMINER_VERUS_KERNEL_H
@@ -0,0 +1,67 @@
+#include "../include/difficulty_controller.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bloxminer {
+
+DifficultyController::DifficultyController(const Options& options)
+    : m_options(options) {
+    m_options.target_interval = std::max(0.1, m_options.target_interval);
+}
+
+double DifficultyController::hashes_per_share(double difficulty) {
+    // 2^256 / (0xffff * 2^208)
+    return difficulty * (281474976710656.0 / 65535.0);
+}
+
+double DifficultyController::ideal(double hashrate) const {
+    return hashrate * m_options.target_interval / hashes_per_share(1.0);
+}
+
+double DifficultyController::update(double hashrate) {
+    if (hashrate <= 0.0) {
+        return 0.0;
+    }
+    m_hashrate = m_samples == 0 ? hashrate : m_hashrate + 0.3 * (hashrate - m_hashrate);
+    m_samples++;
+    if (m_samples < m_options.warmup) {
+        return 0.0;
+    }
+
+    double want = ideal(m_hashrate);
+    if (m_suggested > 0.0 && std::fabs(want - m_suggested) <= m_options.change * m_suggested) {
+        return 0.0;
+    }
+    m_suggested = want;
+    m_suggestions++;
+    return want;
+}
+
+double DifficultyController::on_connect() {
+    if (m_samples < m_options.warmup) {
+        m_suggested = 0.0;
+        return 0.0;
+    }
+    m_suggested = ideal(m_hashrate);
+    m_suggestions++;
+    return m_suggested;
+}
+
+void DifficultyController::record_share(std::chrono::steady_clock::time_point now) {
+    if (m_have_share) {
+        double seconds = std::chrono::duration<double>(now - m_last_share).count();
+        m_interval = m_interval == 0.0 ? seconds : m_interval + 0.1 * (seconds - m_interval);
+    }
+    m_have_share = true;
+    m_last_share = now;
+}
+
+double DifficultyController::expected_interval(double pool_difficulty) const {
+    if (m_hashrate <= 0.0 || pool_difficulty <= 0.0) {
+        return 0.0;
+    }
+    return hashes_per_share(pool_difficulty) / m_hashrate;
+}
+
+}  // namespace bloxminer
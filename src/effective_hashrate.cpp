@@ -0,0 +1,125 @@
+#include "../include/effective_hashrate.hpp"
+#include "../include/difficulty_controller.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace bloxminer {
+
+EffectiveHashrate::EffectiveHashrate(Clock::time_point start) : m_start(start) {}
+
+EffectiveHashrate::Bucket& EffectiveHashrate::bucket(Clock::time_point now, size_t pool) {
+    int64_t index = std::max<int64_t>(
+        0, std::chrono::duration_cast<std::chrono::seconds>(now - m_start).count() / BUCKET_SECONDS);
+
+    // The current minute's buckets are at the back, one per pool mined on
+    for (auto it = m_buckets.rbegin(); it != m_buckets.rend() && it->index >= index; ++it) {
+        if (it->index == index && it->pool == pool) {
+            return *it;
+        }
+    }
+    while (!m_buckets.empty() && m_buckets.front().index <= index - HISTORY_SECONDS / BUCKET_SECONDS) {
+        m_buckets.pop_front();
+    }
+    Bucket b;
+    b.index = index;
+    b.pool = pool;
+    m_buckets.push_back(b);
+    return m_buckets.back();
+}
+
+void EffectiveHashrate::add_work(Clock::time_point now, size_t pool, double hashes, double difficulty) {
+    if (hashes <= 0.0) return;
+    Bucket& b = bucket(now, pool);
+    b.hashes += hashes;
+    if (difficulty > 0.0) {
+        b.expected += hashes / DifficultyController::hashes_per_share(difficulty);
+    }
+}
+
+void EffectiveHashrate::add_found(Clock::time_point now, size_t pool, double difficulty) {
+    Bucket& b = bucket(now, pool);
+    b.found++;
+    b.found_difficulty += difficulty;
+}
+
+void EffectiveHashrate::add_result(Clock::time_point now, size_t pool, double difficulty, bool accepted) {
+    Bucket& b = bucket(now, pool);
+    if (accepted) {
+        b.accepted++;
+        b.accepted_difficulty += difficulty;
+    } else {
+        b.rejected++;
+    }
+}
+
+void EffectiveHashrate::poisson_interval(double n, double& low, double& high) {
+    const double z = 1.96;
+    if (n <= 0.0) {
+        low = 0.0;
+    } else {
+        low = n * std::pow(1.0 - 1.0 / (9.0 * n) - z / (3.0 * std::sqrt(n)), 3.0);
+    }
+    const double m = n + 1.0;
+    high = m * std::pow(1.0 - 1.0 / (9.0 * m) + z / (3.0 * std::sqrt(m)), 3.0);
+}
+
+EffectiveHashrate::Window EffectiveHashrate::window(Clock::time_point now, double seconds, int pool) const {
+    Window w;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    double elapsed = std::chrono::duration<double>(now - m_start).count();
+    int64_t first = std::max<int64_t>(0, static_cast<int64_t>(std::floor((elapsed - seconds) / BUCKET_SECONDS)));
+    w.seconds = elapsed - first * BUCKET_SECONDS;
+
+    double hashes = 0.0;
+    double found_difficulty = 0.0;
+    double accepted_difficulty = 0.0;
+    for (const Bucket& b : m_buckets) {
+        if (b.index < first || (pool >= 0 && b.pool != static_cast<size_t>(pool))) continue;
+        hashes += b.hashes;
+        w.expected += b.expected;
+        w.found += b.found;
+        found_difficulty += b.found_difficulty;
+        w.accepted += b.accepted;
+        accepted_difficulty += b.accepted_difficulty;
+        w.rejected += b.rejected;
+    }
+
+    w.luck = w.luck_low = w.luck_high = nan;
+    w.gap = nan;
+    if (w.seconds <= 0.0) {
+        return w;
+    }
+
+    // Difficulty 1 is worth hashes_per_share(1) hashes to the pool
+    const double unit = DifficultyController::hashes_per_share(1.0);
+    w.local = hashes / w.seconds;
+    w.effective = accepted_difficulty * unit / w.seconds;
+    double low, high;
+    poisson_interval(static_cast<double>(w.accepted), low, high);
+    if (w.accepted > 0) {
+        w.effective_low = w.effective * low / w.accepted;
+        w.effective_high = w.effective * high / w.accepted;
+    } else if (w.expected > 0.0) {
+        // No share yet: bound it by what one share is worth at the mined difficulty
+        double share_hashes = hashes / w.expected;
+        w.effective_high = high * share_hashes / w.seconds;
+    }
+
+    if (w.expected > 0.0) {
+        poisson_interval(static_cast<double>(w.found), low, high);
+        w.luck = w.found / w.expected;
+        w.luck_low = low / w.expected;
+        w.luck_high = high / w.expected;
+    }
+    if (found_difficulty > 0.0) {
+        w.lost = std::max(0.0, 1.0 - accepted_difficulty / found_difficulty);
+    }
+    if (w.local > 0.0) {
+        w.gap = 1.0 - w.effective / w.local;
+    }
+    return w;
+}
+
+}  // namespace bloxminer
@@ -0,0 +1,82 @@
+#include "../include/governor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bloxminer {
+
+Governor::Governor(GovernorMode mode, double target, uint32_t max_threads, uint32_t min_threads)
+    : m_mode(mode), m_target(target),
+      m_max_threads(std::max<uint32_t>(1, max_threads)),
+      m_min_threads(std::max<uint32_t>(1, std::min(min_threads, m_max_threads))) {
+    apply_capacity(0.0);
+}
+
+const char* Governor::mode_name(GovernorMode mode) {
+    switch (mode) {
+        case GovernorMode::Temperature: return "temp";
+        case GovernorMode::Power:       return "power";
+        case GovernorMode::Efficiency:  return "efficiency";
+        default:                        return "off";
+    }
+}
+
+double Governor::min_capacity() const {
+    return MIN_DUTY * m_min_threads / m_max_threads;
+}
+
+void Governor::set_max_threads(uint32_t max_threads) {
+    m_max_threads = std::max<uint32_t>(1, max_threads);
+    m_min_threads = std::min(m_min_threads, m_max_threads);
+    m_last_efficiency = 0.0;  // Readings from the old pool size no longer compare
+    apply_capacity(m_decision.measurement);
+}
+
+Governor::Decision Governor::update(double measurement, double dt) {
+    if (m_mode == GovernorMode::Off || measurement <= 0.0 || dt <= 0.0) {
+        return m_decision;
+    }
+
+    if (m_mode == GovernorMode::Efficiency) {
+        // Perturb and observe: keep stepping while KH/W improves, turn around
+        // when it drops. Settles into +-1 worker around the optimum.
+        if (m_last_efficiency > 0.0 && measurement < m_last_efficiency) {
+            m_direction = -m_direction;
+        }
+        m_last_efficiency = measurement;
+        m_capacity += m_direction * (1.0 / m_max_threads);
+    } else if (m_target > 0.0) {
+        // Velocity-form PID on the relative error; positive means headroom.
+        // Clamped so an unreachable target does not kick capacity back up
+        // through the P term as the reading falls while saturated.
+        double error = std::min(1.0, std::max(-1.0, (m_target - measurement) / m_target));
+        if (!m_primed) {
+            m_error1 = m_error2 = error;
+            m_primed = true;
+        }
+        m_capacity += KP * (error - m_error1)
+                    + KI * error * dt
+                    + KD * (error - 2.0 * m_error1 + m_error2);
+        m_error2 = m_error1;
+        m_error1 = error;
+    }
+
+    apply_capacity(measurement);
+    return m_decision;
+}
+
+void Governor::apply_capacity(double measurement) {
+    m_capacity = std::min(1.0, std::max(min_capacity(), m_capacity));
+
+    // Fewest workers that can carry the capacity, each running at duty <= 1
+    double workers = m_capacity * m_max_threads;
+    uint32_t threads = static_cast<uint32_t>(std::ceil(workers - 1e-9));
+    threads = std::max(m_min_threads, std::min(threads, m_max_threads));
+
+    m_decision.capacity = m_capacity;
+    m_decision.threads = threads;
+    m_decision.duty = std::min(1.0, workers / threads);
+    m_decision.measurement = measurement;
+}
+
+}  // namespace bloxminer
@@ -0,0 +1,85 @@
+#include "../include/job_window.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bloxminer {
+
+JobWindow::JobWindow(size_t capacity)
+    : m_capacity(std::max<size_t>(1, capacity)) {
+}
+
+bool JobWindow::same_work(const stratum::Job& a, const stratum::Job& b) {
+    return a.header_len == b.header_len &&
+           memcmp(a.header, b.header, a.header_len) == 0 &&
+           memcmp(a.target, b.target, sizeof(a.target)) == 0 &&
+           a.solution == b.solution;
+}
+
+bool JobWindow::add(uint64_t generation, const std::string& pool, const stratum::Job& job,
+                    NonceScheduler::Progress& resume) {
+    // Identical work hashes to identical results whatever the pool's flags,
+    // so its saved progress carries over even across clean_jobs
+    bool found = false;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->suspended && it->pool == pool && same_work(it->job, job)) {
+            resume = std::move(it->progress);
+            m_entries.erase(it);
+            m_resumed++;
+            found = true;
+            break;
+        }
+    }
+
+    if (job.clean_jobs) {
+        m_entries.clear();
+    } else {
+        m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), [&](const Entry& e) {
+            return e.pool != pool || e.job.extranonce1 != job.extranonce1 ||
+                   e.job.prev_hash != job.prev_hash;
+        }), m_entries.end());
+    }
+
+    while (m_entries.size() >= m_capacity) {
+        m_entries.pop_front();
+    }
+    Entry entry;
+    entry.generation = generation;
+    entry.pool = pool;
+    entry.job = job;
+    m_entries.push_back(std::move(entry));
+    return found;
+}
+
+void JobWindow::suspend(uint64_t generation, NonceScheduler::Progress progress) {
+    for (auto& e : m_entries) {
+        if (e.generation == generation) {
+            // Appended: workers' tails can arrive on either side of the snapshot
+            e.progress.pass = progress.pass;
+            e.progress.ranges.insert(e.progress.ranges.end(), progress.ranges.begin(), progress.ranges.end());
+            e.suspended = true;
+            return;
+        }
+    }
+}
+
+void JobWindow::give_back(uint64_t generation, const NonceScheduler::Range& range) {
+    if (range.begin >= range.end) return;
+    for (auto& e : m_entries) {
+        if (e.generation == generation) {
+            e.progress.ranges.push_back(range);
+            return;
+        }
+    }
+}
+
+const stratum::Job* JobWindow::find(uint64_t generation) const {
+    for (const auto& e : m_entries) {
+        if (e.generation == generation) {
+            return &e.job;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace bloxminer
@@ -1,13 +1,16 @@
 #include "../include/config.hpp"
 #include "../include/config_manager.hpp"
 #include "../include/miner.hpp"
+#include "../include/autotuner.hpp"
 #include "../include/utils/logger.hpp"
 #include "../include/utils/display.hpp"
+#include "../include/utils/journal.hpp"
 #include "verus_hash.h"
 
 #include <iostream>
 #include <csignal>
 #include <cstring>
+#include <cstdlib>
 #include <getopt.h>
 #include <thread>
 #include <algorithm>
@@ -34,6 +37,7 @@ bool validate_verus_address(const std::string& addr) {
 
 // Async-signal-safe shutdown flag; checked in the main loop
 static std::atomic<bool> g_shutdown_requested{false};
+static Miner* g_miner = nullptr;
 
 void signal_handler(int signum) {
     (void)signum;
@@ -63,15 +67,29 @@ void print_usage(const char* program) {
     std::cout << "Options:" << std::endl;
     std::cout << "  -c, --config <path>       Config file path (default: bloxminer.json)" << std::endl;
     std::cout << "  -o, --pool <host:port>    Pool address (can specify multiple for failover)" << std::endl;
+    std::cout << "                            stratum+ssl://host:port for TLS" << std::endl;
     std::cout << "  -u, --user <wallet>       Wallet address" << std::endl;
     std::cout << "  -p, --pass <password>     Pool password (default: x)" << std::endl;
     std::cout << "  -w, --worker <name>       Worker name (default: bloxminer)" << std::endl;
     std::cout << "  -t, --threads <num>       Number of mining threads (default: auto)" << std::endl;
     std::cout << "  --api-port <port>         API server port (default: 4068, 0 to disable)" << std::endl;
     std::cout << "  --api-bind <addr>         API bind address (default: 127.0.0.1)" << std::endl;
+    std::cout << "  --governor <mode[:target]> Hold temp:<C>, power:<W>, or best efficiency" << std::endl;
+    std::cout << "  --autotune[=goal]         Search threads/placement for best efficiency (default)" << std::endl;
+    std::cout << "                            or hashrate, then save the result to the config file" << std::endl;
+    std::cout << "  --background              Idle priority, shed workers when the CPU is contended" << std::endl;
+    std::cout << "  --heal                    Move pinned threads off cores where they stay slow" << std::endl;
+    std::cout << "  --share-interval <sec>    Suggest a share difficulty that finds one share per <sec>" << std::endl;
+    std::cout << "  --perf-counters           Report per-thread IPC, GHz and cycles per hash (perf_event)" << std::endl;
+    std::cout << "  --log-file <path>         Also write the log to <path>, rotated at 10 MB" << std::endl;
     std::cout << "  -q, --quiet               Quiet mode - reduce log verbosity (only warnings/errors)" << std::endl;
     std::cout << "  -h, --help                Show this help message" << std::endl;
     std::cout << std::endl;
+    std::cout << "Commands:" << std::endl;
+    std::cout << "  journal [--json] [--last N] [--previous] [PATH]" << std::endl;
+    std::cout << "                            Dump the event journal (default: this run's, or the" << std::endl;
+    std::cout << "                            run before it with --previous) as text or JSON lines" << std::endl;
+    std::cout << std::endl;
     std::cout << "Config File:" << std::endl;
     std::cout << "  On first run without arguments, interactive setup creates bloxminer.json" << std::endl;
     std::cout << "  CLI arguments override config file values" << std::endl;
@@ -83,7 +101,20 @@ void print_usage(const char* program) {
     std::cout << std::endl;
 }
 
-bool parse_pool(const std::string& pool, std::string& host, uint16_t& port) {
+// Parse [scheme://]host[:port]; stratum+ssl:// and stratum+tls:// select TLS
+bool parse_pool(std::string pool, std::string& host, uint16_t& port, bool& tls) {
+    tls = false;
+    size_t scheme_end = pool.find("://");
+    if (scheme_end != std::string::npos) {
+        std::string scheme = pool.substr(0, scheme_end);
+        if (scheme == "stratum+ssl" || scheme == "stratum+tls" || scheme == "ssl" || scheme == "tls") {
+            tls = true;
+        } else if (scheme != "stratum+tcp" && scheme != "stratum" && scheme != "tcp") {
+            return false;
+        }
+        pool = pool.substr(scheme_end + 3);
+    }
+
     size_t colon = pool.rfind(':');
     if (colon == std::string::npos) {
         host = pool;
@@ -101,7 +132,77 @@ bool parse_pool(const std::string& pool, std::string& host, uint16_t& port) {
     return true;
 }
 
+// Parse --governor: "temp:<C>", "power:<W>", "efficiency" or "off"
+bool parse_governor(const std::string& spec, GovernorMode& mode, double& target) {
+    size_t colon = spec.find(':');
+    std::string name = spec.substr(0, colon);
+    target = 0.0;
+
+    if (name == "efficiency" || name == "off") {
+        mode = name == "off" ? GovernorMode::Off : GovernorMode::Efficiency;
+        return colon == std::string::npos;
+    }
+    if (name == "temp") {
+        mode = GovernorMode::Temperature;
+    } else if (name == "power") {
+        mode = GovernorMode::Power;
+    } else {
+        return false;
+    }
+    if (colon == std::string::npos) {
+        return false;
+    }
+    try {
+        target = std::stod(spec.substr(colon + 1));
+    } catch (...) {
+        return false;
+    }
+    return target > 0.0;
+}
+
+// `bloxminer journal ...`: decode the binary event journal and exit
+int journal_command(int argc, char* argv[]) {
+    std::string path = utils::journal_path();
+    bool json = false;
+    bool previous = false;
+    size_t last = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (strcmp(argv[i], "--previous") == 0) {
+            previous = true;
+        } else if (strcmp(argv[i], "--last") == 0 && i + 1 < argc) {
+            last = std::strtoul(argv[++i], nullptr, 10);
+        } else if (argv[i][0] == '-') {
+            std::cerr << "Usage: bloxminer journal [--json] [--last N] [--previous] [PATH]" << std::endl;
+            return 1;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (previous) {
+        path += ".1";
+    }
+
+    std::vector<utils::JournalEntry> entries;
+    std::string error;
+    if (!utils::read_journal(path, entries, error)) {
+        std::cerr << "bloxminer journal: " << error << std::endl;
+        return 1;
+    }
+    size_t first = last > 0 && entries.size() > last ? entries.size() - last : 0;
+    for (size_t i = first; i < entries.size(); i++) {
+        std::cout << utils::format_journal_entry(entries[i], json) << '\n';
+    }
+    std::cout.flush();
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "journal") == 0) {
+        return journal_command(argc - 1, argv + 1);
+    }
+
     // Step 1: Parse command line options first pass to get config path and help
     static struct option long_options[] = {
         {"config",   required_argument, 0, 'c'},
@@ -112,6 +213,13 @@ int main(int argc, char* argv[]) {
         {"threads",  required_argument, 0, 't'},
         {"api-port", required_argument, 0, 'a'},
         {"api-bind", required_argument, 0, 'b'},
+        {"governor", required_argument, 0, 'g'},
+        {"autotune", optional_argument, 0, 'A'},
+        {"background", no_argument,     0, 'B'},
+        {"heal",     no_argument,       0, 'H'},
+        {"share-interval", required_argument, 0, 'S'},
+        {"log-file", required_argument, 0, 'L'},
+        {"perf-counters", no_argument,  0, 'P'},
         {"quiet",    no_argument,       0, 'q'},
         {"help",     no_argument,       0, 'h'},
         {0, 0, 0, 0}
@@ -128,19 +236,27 @@ int main(int argc, char* argv[]) {
     bool cli_threads_set = false;
     bool cli_api_port_set = false;
     bool cli_api_bind_set = false;
+    bool cli_governor_set = false;
+    bool cli_background_set = false;
+    bool cli_heal_set = false;
+    bool cli_share_interval_set = false;
+    bool cli_log_file_set = false;
+    bool cli_perf_counters_set = false;
+    bool autotune = false;
+    Autotuner::Goal autotune_goal = Autotuner::Goal::Efficiency;
 
     // Temporary storage for CLI values
     MinerConfig cli_config;
 
     int opt;
-    while ((opt = getopt_long(argc, argv, "c:o:u:p:w:t:a:b:qh", long_options, nullptr)) != -1) {
+    while ((opt = getopt_long(argc, argv, "c:o:u:p:w:t:a:b:g:A::qh", long_options, nullptr)) != -1) {
         switch (opt) {
             case 'c':
                 custom_config_path = optarg;
                 break;
             case 'o': {
                 PoolConfig pool;
-                if (!parse_pool(optarg, pool.host, pool.port)) {
+                if (!parse_pool(optarg, pool.host, pool.port, pool.tls)) {
                     std::cerr << "Invalid pool address: " << optarg << std::endl;
                     return 1;
                 }
@@ -197,6 +313,51 @@ int main(int argc, char* argv[]) {
                 cli_config.api_bind_address = optarg;
                 cli_api_bind_set = true;
                 break;
+            case 'g':
+                if (!parse_governor(optarg, cli_config.governor_mode, cli_config.governor_target)) {
+                    std::cerr << "Invalid governor: " << optarg
+                              << " (expected temp:<C>, power:<W> or efficiency)" << std::endl;
+                    return 1;
+                }
+                cli_governor_set = true;
+                break;
+            case 'A':
+                if (optarg == nullptr || std::string(optarg) == "efficiency") {
+                    autotune_goal = Autotuner::Goal::Efficiency;
+                } else if (std::string(optarg) == "hashrate") {
+                    autotune_goal = Autotuner::Goal::Hashrate;
+                } else {
+                    std::cerr << "Invalid autotune goal: " << optarg
+                              << " (expected efficiency or hashrate)" << std::endl;
+                    return 1;
+                }
+                autotune = true;
+                break;
+            case 'B':
+                cli_background_set = true;
+                break;
+            case 'H':
+                cli_heal_set = true;
+                break;
+            case 'S':
+                try {
+                    cli_config.share_interval = std::stod(optarg);
+                } catch (...) {
+                    cli_config.share_interval = 0.0;
+                }
+                if (cli_config.share_interval <= 0.0) {
+                    std::cerr << "Invalid share interval: " << optarg << std::endl;
+                    return 1;
+                }
+                cli_share_interval_set = true;
+                break;
+            case 'L':
+                cli_config.log_file = optarg;
+                cli_log_file_set = true;
+                break;
+            case 'P':
+                cli_perf_counters_set = true;
+                break;
             case 'q':
                 quiet_mode = true;
                 break;
@@ -230,6 +391,20 @@ int main(int argc, char* argv[]) {
         config.api_enabled = cli_config.api_enabled;
     }
     if (cli_api_bind_set) config.api_bind_address = cli_config.api_bind_address;
+    if (cli_governor_set) {
+        config.governor_mode = cli_config.governor_mode;
+        config.governor_target = cli_config.governor_target;
+    }
+    if (cli_background_set) config.background = true;
+    if (cli_heal_set) config.heal = true;
+    if (cli_share_interval_set) {
+        config.share_interval = cli_config.share_interval;
+        if (config.difficulty_hint == DifficultyHint::Off) {
+            config.difficulty_hint = DifficultyHint::Suggest;
+        }
+    }
+    if (cli_log_file_set) config.log_file = cli_config.log_file;
+    if (cli_perf_counters_set) config.perf_counters = true;
 
     // Update legacy pool fields if CLI pools were set
     if (cli_pools_set && !cli_config.pools.empty()) {
@@ -293,6 +468,20 @@ int main(int argc, char* argv[]) {
         std::cerr << "Continuing anyway..." << std::endl;
     }
 
+    // The governor or background shedding would fight the autotuner over the thread count
+    if (autotune && config.governor_mode != GovernorMode::Off) {
+        std::cerr << "Error: --autotune cannot run with the governor enabled" << std::endl;
+        return 1;
+    }
+    if (autotune && config.background) {
+        std::cerr << "Error: --autotune cannot run in background mode" << std::endl;
+        return 1;
+    }
+    if (autotune && config.heal) {
+        std::cerr << "Error: --autotune cannot run with healing enabled" << std::endl;
+        return 1;
+    }
+
     // Check CPU features before initializing display
     if (!verus::Hasher::supported()) {
         std::cerr << "Error: Your CPU does not support required features." << std::endl;
@@ -309,6 +498,11 @@ int main(int argc, char* argv[]) {
         utils::Logger::instance().set_level(utils::LogLevel::WARN);
     }
 
+    if (!config.log_file.empty() &&
+        !utils::Logger::instance().set_file(config.log_file, uint64_t(config.log_max_size_mb) << 20, config.log_keep)) {
+        LOG_WARN("Could not open log file %s; logging to the terminal only", config.log_file.c_str());
+    }
+
     LOG_INFO("CPU supports VerusHash requirements - OK");
 
     // Setup signal handlers
@@ -320,22 +514,65 @@ int main(int argc, char* argv[]) {
     g_miner = &miner;
 
     if (!miner.start()) {
+        utils::Logger::instance().flush();
         std::cerr << "Failed to start miner" << std::endl;
         return 1;
     }
 
+    // Autotune runs alongside normal mining and saves what it finds
+    Autotuner tuner(miner, config);
+    std::thread tune_thread;
+    if (autotune) {
+        tune_thread = std::thread([&] {
+            TunedProfile best_hashrate, best_efficiency;
+            if (!tuner.run(autotune_goal, best_hashrate, best_efficiency)) {
+                return;
+            }
+            config.tuned_hashrate = best_hashrate;
+            config.tuned_efficiency = best_efficiency;
+            const TunedProfile& chosen =
+                autotune_goal == Autotuner::Goal::Efficiency && best_efficiency.threads > 0
+                    ? best_efficiency : best_hashrate;
+            config.num_threads = chosen.threads;
+            config.placement = chosen.placement;
+            config.smt = chosen.smt;
+            config.chunk_target_ms = chosen.chunk_target_ms;
+
+            std::string path = custom_config_path.empty() ? ConfigManager::LOCAL_CONFIG : custom_config_path;
+            if (ConfigManager::save_config(config, path)) {
+                LOG_INFO("Autotune: saved to %s", path.c_str());
+            } else {
+                LOG_ERROR("Autotune: failed to save %s", path.c_str());
+            }
+        });
+    }
+
     // Wait for miner to finish
     while (miner.is_running()) {
+        if (g_shutdown_requested.load(std::memory_order_relaxed)) {
+            tuner.stop();
+            if (tune_thread.joinable()) {
+                tune_thread.join();
+            }
+            miner.stop();
+            break;
+        }
         std::this_thread::sleep_for(std::chrono::seconds(1));
     }
+    if (tune_thread.joinable()) {
+        tune_thread.join();
+    }
 
     g_miner = nullptr;
 
+    // The logger thread may still hold the miner's last lines
+    utils::Logger::instance().flush();
+
     // Print final stats
     const auto& stats = miner.get_stats();
     std::cout << std::endl;
     std::cout << "Final Statistics:" << std::endl;
-    std::cout << "  Total hashes: " << stats.hashes.load() << std::endl;
+    std::cout << "  Total hashes: " << stats.total_hashes() << std::endl;
     std::cout << "  Shares accepted: " << stats.shares_accepted.load() << std::endl;
     std::cout << "  Shares rejected: " << stats.shares_rejected.load() << std::endl;
 
@@ -3,7 +3,10 @@
 #include "../include/utils/logger.hpp"
 #include "../include/utils/system_monitor.hpp"
 #include "../include/utils/display.hpp"
+#include "../include/utils/cpu_topology.hpp"
+#include "../include/nlohmann/json.hpp"
 
+#include <cmath>
 #include <cstring>
 #include <sstream>
 #include <iomanip>
@@ -12,15 +15,18 @@
 
 // Thread affinity for CPU pinning
 #ifdef __linux__
+#include <dirent.h>
 #include <sched.h>
 #include <pthread.h>
 #include <unistd.h>
-#include <fcntl.h>
-#include <sys/stat.h>
 #endif
 
 namespace bloxminer {
 
+// Nonces per Hasher::scan() call: short enough that a job change is noticed
+// within about a millisecond, long enough to amortize the call
+static constexpr uint32_t SCAN_CHUNK_NONCES = 1024;
+
 Miner::Miner(const MinerConfig& config) : m_config(config) {
     // Auto-detect thread count if not specified
     if (m_config.num_threads == 0) {
@@ -29,6 +35,58 @@ Miner::Miner(const MinerConfig& config) : m_config(config) {
             m_config.num_threads = 4;  // Fallback
         }
     }
+    m_scheduler.set_target_ms(std::max<uint32_t>(1, m_config.chunk_target_ms));
+    m_requested_threads = m_config.num_threads;
+    m_placement = m_config.placement;
+    m_smt = m_config.smt;
+    m_core_cpus = utils::CpuTopology::one_per_core();
+    
+    // Background mode stays off the foreground's cores: no hard pinning
+    if (m_config.background) {
+        m_placement = ThreadPlacement::Unpinned;
+        m_pressure = std::make_unique<PressureController>(
+            m_config.num_threads, m_config.background_pressure_high, m_config.background_pressure_low,
+            m_config.background_recover_ms);
+    }
+    
+    // Healing moves pinned workers; background workers are never pinned
+    if (m_config.heal && !m_config.background) {
+        PlacementHealer::Options heal;
+        heal.threshold = m_config.heal_threshold;
+        heal.confirmations = m_config.heal_confirmations;
+        heal.retire_below = m_config.heal_retire_below;
+        m_healer = std::make_unique<PlacementHealer>(placement_cpus(), heal);
+    }
+    
+    if (m_config.governor_mode != GovernorMode::Off) {
+        m_governor = std::make_unique<Governor>(m_config.governor_mode, m_config.governor_target,
+                                                m_config.num_threads, m_config.governor_min_threads);
+    }
+    
+    // Latency ranking only has something to choose between with several pools
+    if (m_config.pool_latency_ranking && m_config.pools.size() > 1) {
+        PoolRanker::Options options;
+        options.margin_ms = m_config.pool_switch_margin_ms;
+        options.margin = m_config.pool_switch_margin;
+        options.confirmations = m_config.pool_switch_confirmations;
+        m_ranker = std::make_unique<PoolRanker>(m_config.pools.size(), options);
+    }
+    
+    DifficultyController::Options difficulty;
+    difficulty.target_interval = m_config.share_interval;
+    difficulty.change = m_config.difficulty_change;
+    m_difficulty = std::make_unique<DifficultyController>(difficulty);
+    
+    if (m_config.share_buffer_size > 0) {
+        m_share_buffer = std::make_unique<ShareBuffer>(m_config.share_buffer_size,
+                                                       m_config.share_buffer_max_age);
+    }
+    
+    m_pool_shares.reset(new PoolShares[m_config.pools.size()]);
+    
+    if (m_config.perf_counters) {
+        m_thread_perf.reset(new ThreadPerf[MinerStats::MAX_THREADS]);
+    }
 }
 
 Miner::~Miner() {
@@ -49,7 +107,8 @@ bool Miner::start() {
     LOG_INFO("Starting BloxMiner v%s", VERSION);
     LOG_INFO("Using %d mining threads", m_config.num_threads);
     if (m_config.pools.size() > 1) {
-        LOG_INFO("Configured %zu pools (failover enabled)", m_config.pools.size());
+        LOG_INFO("Configured %zu pools (failover enabled, %s)", m_config.pools.size(),
+                 m_ranker ? "lowest latency first" : "in order");
         for (size_t i = 0; i < m_config.pools.size(); i++) {
             LOG_INFO("  Pool %zu: %s:%d", i + 1, m_config.pools[i].host.c_str(), m_config.pools[i].port);
         }
@@ -65,7 +124,12 @@ bool Miner::start() {
     
     m_running = true;
     m_stats.start_time = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_effective_mutex);
+        m_effective = EffectiveHashrate(m_stats.start_time);
+    }
     m_stats.num_threads = m_config.num_threads;
+    m_active_threads = m_config.num_threads;
 
     // Display is initialized in main.cpp before LOG calls
     // No need to re-initialize here
@@ -75,21 +139,53 @@ bool Miner::start() {
         on_new_job(job);
     });
     
-    m_stratum.on_share_result([this](bool accepted, const std::string& reason) {
-        on_share_result(accepted, reason);
+    m_stratum.on_share_result([this](bool accepted, const std::string& reason, double rtt_ms, double difficulty) {
+        on_share_result(accepted, reason, rtt_ms, difficulty);
     });
     
+    // Journal first, so it sees the first connect
+    if (m_config.journal_records > 0) {
+        std::string journal_path = utils::journal_path();
+        if (!m_journal.open(journal_path, m_config.journal_records)) {
+            LOG_WARN("Could not create %s; no event journal this run", journal_path.c_str());
+        }
+    }
+    
     // Start stratum thread
     m_stratum_thread = std::thread(&Miner::stratum_thread, this);
     
+    // Stats segment read by bloxminer-stat (HiveOS h-stats.sh)
+    std::string shared_path = utils::shared_stats_path();
+    if (!m_shared_stats.open(shared_path)) {
+        LOG_WARN("Could not create %s; bloxminer-stat will not see this miner", shared_path.c_str());
+    }
+    
     // Start stats thread
     m_stats_thread = std::thread(&Miner::stats_thread, this);
     
+    // Start pool latency probes
+    if (m_ranker) {
+        m_probe_thread = std::thread(&Miner::probe_thread, this);
+    }
+    
     // Start API server
     if (m_config.api_enabled) {
         auto stats_callback = [this]() -> std::string {
             return get_api_stats_json();
         };
+        if (m_config.api_control) {
+            m_api_server.set_control_callback(
+                [this](const std::string& action, const std::string& body, std::string& response) {
+                    int status = handle_control(action, body, response);
+                    m_api_server.publish(get_api_stats_json());  // Control thread: show the change without waiting
+                    return status;
+                });
+        }
+        m_api_server.set_metrics_callback([this]() -> std::string {
+            return get_metrics_text();
+        });
+        m_api_server.set_event_bus(&m_events);
+        m_api_server.publish(get_api_stats_json());
         if (m_api_server.start(m_config.api_port, stats_callback, m_config.api_bind_address)) {
             LOG_INFO("API server started on %s:%d", m_config.api_bind_address.c_str(), m_config.api_port);
         } else {
@@ -97,10 +193,43 @@ bool Miner::start() {
         }
     }
     
+    // Start governor
+    if (m_governor) {
+        LOG_INFO("Governor: %s, target %f, every %us", Governor::mode_name(m_governor->mode()),
+                 m_governor->target(), m_config.governor_interval);
+        m_governor_thread = std::thread(&Miner::governor_thread, this);
+    }
+    
+    // Start background-mode pressure monitor
+    if (m_pressure) {
+        std::stringstream ss;
+        ss << m_config.background_pressure_high << "%";
+        LOG_INFO("Background mode: idle-priority workers, shedding above %s CPU pressure",
+                 ss.str().c_str());
+        m_background_thread = std::thread(&Miner::background_thread, this);
+    }
+    
+    // Start placement healing
+    if (m_healer) {
+        std::stringstream ss;
+        ss << "Placement healing: every " << std::max<uint32_t>(1, m_config.heal_interval) << "s, workers "
+           << std::fixed << std::setprecision(0) << m_config.heal_threshold * 100.0
+           << "% below the median for " << m_config.heal_confirmations << " intervals are moved";
+        LOG_INFO("%s", ss.str().c_str());
+        m_heal_thread = std::thread(&Miner::heal_thread, this);
+    }
+    
     // Start mining threads
-    m_mining_threads.reserve(m_config.num_threads);
-    for (uint32_t i = 0; i < m_config.num_threads; i++) {
-        m_mining_threads.emplace_back(&Miner::mining_thread, this, i);
+    {
+        std::lock_guard<std::mutex> pool_lock(m_pool_mutex);
+        if (m_healer) {
+            std::lock_guard<std::mutex> lock(m_healer_mutex);
+            m_healer->resize(m_config.num_threads);
+        }
+        m_mining_threads.reserve(m_config.num_threads);
+        for (uint32_t i = 0; i < m_config.num_threads; i++) {
+            m_mining_threads.emplace_back(&Miner::mining_thread, this, i);
+        }
     }
     
     return true;
@@ -136,25 +265,242 @@ void Miner::stop() {
         m_stats_thread.join();
     }
     
-    for (auto& t : m_mining_threads) {
-        if (t.joinable()) {
-            t.join();
-        }
+    if (m_probe_thread.joinable()) {
+        m_probe_thread.join();
+    }
+    
+    if (m_governor_thread.joinable()) {
+        m_governor_thread.join();
+    }
+    
+    if (m_background_thread.joinable()) {
+        m_background_thread.join();
+    }
+    
+    if (m_heal_thread.joinable()) {
+        m_heal_thread.join();
     }
     
-    m_mining_threads.clear();
+    {
+        std::lock_guard<std::mutex> pool_lock(m_pool_mutex);
+        for (auto& t : m_mining_threads) {
+            if (t.joinable()) {
+                t.join();
+            }
+        }
+        m_mining_threads.clear();
+    }
     
     LOG_INFO("Miner stopped");
 }
 
+bool Miner::set_thread_count(uint32_t count) {
+    if (count == 0 || count > MinerStats::MAX_THREADS) {
+        return false;
+    }
+    
+    m_requested_threads = count;
+    
+    // Governor and background mode keep throttling, now relative to the new ceiling
+    if (m_governor) {
+        std::lock_guard<std::mutex> lock(m_governor_mutex);
+        m_governor->set_max_threads(count);
+        m_duty = m_governor->current().duty;
+    }
+    if (m_pressure) {
+        std::lock_guard<std::mutex> lock(m_pressure_mutex);
+        m_pressure->set_max_threads(count);
+    }
+    update_pool();
+    return true;
+}
+
+void Miner::update_pool() {
+    std::lock_guard<std::mutex> pool_lock(m_pool_mutex);
+    if (!m_running) {
+        m_config.num_threads = m_requested_threads;
+        return;
+    }
+    
+    // Requested size, throttled by the governor, capped by background mode
+    // and by the CPUs healing has left
+    uint32_t count = m_requested_threads;
+    if (m_governor) {
+        std::lock_guard<std::mutex> lock(m_governor_mutex);
+        count = m_governor->current().threads;
+    }
+    if (m_pressure) {
+        std::lock_guard<std::mutex> lock(m_pressure_mutex);
+        count = std::min(count, m_pressure->allowed());
+    }
+    if (m_healer) {
+        std::lock_guard<std::mutex> lock(m_healer_mutex);
+        if (!m_healer->excluded().empty()) {
+            count = std::max<uint32_t>(1, std::min(count, m_healer->allowed()));
+        }
+    }
+    
+    uint32_t old_count = m_active_threads.load();
+    if (count == old_count) {
+        return;
+    }
+    if (m_healer) {
+        std::lock_guard<std::mutex> lock(m_healer_mutex);
+        m_healer->resize(count);
+    }
+    
+    if (count < old_count) {
+        // Retire the highest ids; each hands back the rest of its range,
+        // folds its hashes into the total and exits
+        m_active_threads = count;
+        m_job_cv.notify_all();
+        for (uint32_t i = count; i < old_count; i++) {
+            if (m_mining_threads[i].joinable()) {
+                m_mining_threads[i].join();
+            }
+        }
+        m_stats.num_threads = count;
+    } else {
+        // New workers steal from the current job's ranges until the next job
+        // splits the space between all of them
+        m_stats.num_threads = count;
+        m_scheduler.resize(count);
+        m_active_threads = count;
+        m_mining_threads.resize(std::max<size_t>(m_mining_threads.size(), count));
+        for (uint32_t i = old_count; i < count; i++) {
+            m_mining_threads[i] = std::thread(&Miner::mining_thread, this, i);
+        }
+    }
+    
+    // Pinning depends on the pool size, so let every worker re-apply it
+    m_placement_generation++;
+    m_journal.record(utils::JournalEvent::Throttle, count, old_count);
+    m_events.publish("throttle", nlohmann::json{{"threads", count}, {"previous", old_count},
+                                                {"requested", m_requested_threads.load()}}.dump());
+    if (m_pressure) {
+        LOG_DEBUG("Mining threads: %u -> %u", old_count, count);
+    } else {
+        LOG_INFO("Mining threads: %u -> %u", old_count, count);
+    }
+}
+
+void Miner::set_paused(bool paused) {
+    if (m_paused.exchange(paused) == paused) {
+        return;
+    }
+    m_job_cv.notify_all();
+    m_journal.record(utils::JournalEvent::Pause, paused ? 1 : 0);
+    m_events.publish("pause", nlohmann::json{{"paused", paused}}.dump());
+    LOG_INFO("Mining %s", paused ? "paused" : "resumed");
+}
+
+void Miner::set_placement(ThreadPlacement placement) {
+    m_placement = placement;
+    m_placement_generation++;
+    LOG_INFO("Thread placement: %s", placement == ThreadPlacement::Pinned ? "pinned" : "unpinned");
+    
+    // A placement change starts healing over with every CPU usable
+    if (m_healer) {
+        {
+            std::lock_guard<std::mutex> lock(m_healer_mutex);
+            m_healer->reset(placement_cpus());
+        }
+        update_pool();
+    }
+}
+
+void Miner::set_smt(bool smt) {
+    m_smt = smt;
+    m_placement_generation++;
+    if (m_healer) {
+        {
+            std::lock_guard<std::mutex> lock(m_healer_mutex);
+            m_healer->reset(placement_cpus());
+        }
+        update_pool();
+    }
+}
+
+void Miner::set_chunk_target_ms(uint32_t chunk_ms) {
+    m_scheduler.set_target_ms(std::max<uint32_t>(1, chunk_ms));
+}
+
+std::vector<int> Miner::placement_cpus() const {
+    // The CPUs pinned workers use, in the order apply_placement assigns them
+    if (!m_smt && !m_core_cpus.empty()) {
+        return m_core_cpus;
+    }
+    std::vector<int> cpus;
+    unsigned hw = std::thread::hardware_concurrency();
+    for (unsigned i = 0; i < hw; i++) {
+        cpus.push_back(static_cast<int>(i));
+    }
+    return cpus;
+}
+
+void Miner::apply_placement(uint32_t thread_id) {
+    // Pin thread to specific CPU core for better cache locality.
+    // Skip if hw == 0 (sandbox/container) or oversubscribed (would alias cores).
+#ifdef __linux__
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw == 0) {
+        return;
+    }
+    // Healing keeps its own CPU per worker, with slow CPUs swapped out
+    int healed_cpu = -1;
+    if (m_healer && m_placement == ThreadPlacement::Pinned) {
+        std::lock_guard<std::mutex> lock(m_healer_mutex);
+        if (m_active_threads <= m_healer->cpus().size()) {
+            healed_cpu = m_healer->cpu_for(thread_id);
+        }
+    }
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    if (healed_cpu >= 0 && healed_cpu < CPU_SETSIZE) {
+        CPU_SET(healed_cpu, &cpuset);
+    } else if (m_placement == ThreadPlacement::Pinned && !m_smt &&
+        m_active_threads <= m_core_cpus.size() && thread_id < m_core_cpus.size()) {
+        // One thread per physical core, leaving SMT siblings idle
+        CPU_SET(m_core_cpus[thread_id], &cpuset);
+    } else if (m_placement == ThreadPlacement::Pinned && m_active_threads <= hw && thread_id < hw) {
+        CPU_SET(thread_id, &cpuset);
+    } else {
+        for (unsigned i = 0; i < hw && i < CPU_SETSIZE; i++) {
+            CPU_SET(i, &cpuset);
+        }
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#else
+    (void)thread_id;
+#endif
+}
+
 void Miner::stratum_thread() {
     constexpr int MAX_CONSECUTIVE_FAILURES = 3;
     constexpr int PRIMARY_RETRY_INTERVAL_SECONDS = 300;  // 5 minutes
     constexpr uint32_t MAX_BACKOFF_SECONDS = 60;
 
     int consecutive_failures = 0;
+    bool had_session = false;
+
+    // Start on the fastest pool rather than the first listed
+    if (m_ranker) {
+        probe_pools();
+        std::lock_guard<std::mutex> lock(m_ranker_mutex);
+        size_t best = m_ranker->ranking().front();
+        if (m_ranker->healthy(best)) {
+            std::lock_guard<std::mutex> job_lock(m_job_mutex);
+            m_current_pool_index = best;
+        }
+    }
 
     while (m_running) {
+        // Session-to-first-job clock: runs across failed attempts and backoff
+        if (!m_awaiting_first_job) {
+            m_session_start = std::chrono::steady_clock::now();
+            m_awaiting_first_job = true;
+        }
+
         // Get current pool
         const PoolConfig& current_pool = m_config.pools[m_current_pool_index];
 
@@ -166,35 +512,63 @@ void Miner::stratum_thread() {
         }
 
         // Connect to pool
-        if (!m_stratum.connect(current_pool.host, current_pool.port)) {
+        if (!m_stratum.connect(current_pool.host, current_pool.port, current_pool.tls, current_pool.tls_verify)) {
             LOG_ERROR("Failed to connect to %s:%d", current_pool.host.c_str(), current_pool.port);
             consecutive_failures++;
             goto handle_failure;
         }
 
-        // Subscribe
-        if (!m_stratum.subscribe()) {
-            LOG_ERROR("Failed to subscribe to %s:%d", current_pool.host.c_str(), current_pool.port);
-            m_stratum.disconnect();
-            consecutive_failures++;
-            goto handle_failure;
-        }
-
-        // Authorize
+        // Subscribe and authorize
         {
             std::string username = m_config.wallet_address;
             if (!m_config.worker_name.empty()) {
                 username += "." + m_config.worker_name;
             }
 
-            if (!m_stratum.authorize(username, m_config.worker_password)) {
-                LOG_ERROR("Failed to authorize on %s:%d", current_pool.host.c_str(), current_pool.port);
+            // Ask for a difficulty sized to the hashrate measured so far
+            double suggest = 0.0;
+            if (m_config.difficulty_hint != DifficultyHint::Off) {
+                std::lock_guard<std::mutex> lock(m_difficulty_mutex);
+                suggest = m_difficulty->on_connect();
+            }
+            std::string password = m_config.worker_password;
+            if (suggest > 0.0) {
+                log_suggestion(suggest);
+                if (m_config.difficulty_hint == DifficultyHint::Password) {
+                    // Comma-separated key=value convention: "x,d=1024"
+                    std::stringstream ss;
+                    ss << password << (password.empty() ? "" : ",") << "d=" << std::setprecision(6) << suggest;
+                    password = ss.str();
+                    suggest = 0.0;
+                }
+            }
+
+            if (!m_stratum.handshake(username, password, suggest)) {
+                LOG_ERROR("Failed to subscribe/authorize on %s:%d", current_pool.host.c_str(), current_pool.port);
                 m_stratum.disconnect();
                 consecutive_failures++;
                 goto handle_failure;
             }
         }
 
+        // Shares found while reconnecting go out now if a job already arrived;
+        // otherwise on_new_job replays them once it has the block to check against
+        {
+            std::lock_guard<std::mutex> lock(m_job_mutex);
+            m_session_ready = true;
+            if (had_session) {
+                m_reconnects.fetch_add(1, std::memory_order_relaxed);
+            }
+            m_journal.record(utils::JournalEvent::PoolConnected, m_current_pool_index.load(), had_session ? 1 : 0);
+            m_events.publish("pool", nlohmann::json{{"state", "connected"}, {"pool", current_pool_key()},
+                                                    {"index", m_current_pool_index.load()},
+                                                    {"reconnect", had_session}}.dump());
+            had_session = true;
+            if (!m_awaiting_first_job) {
+                replay_buffered_shares();
+            }
+        }
+
         // Connection successful - reset failure tracking
         consecutive_failures = 0;
         m_current_backoff_seconds = 5;  // Reset backoff on success
@@ -206,10 +580,27 @@ void Miner::stratum_thread() {
 
         // Run receive loop (blocks until disconnected)
         m_stratum.run();
+        m_session_ready = false;  // Buffer shares until the next session is up
+        m_journal.record(utils::JournalEvent::PoolLost, m_current_pool_index.load());
+        m_events.publish("pool", nlohmann::json{{"state", "disconnected"},
+                                                {"index", m_current_pool_index.load()}}.dump());
 
         // Always clean up socket after run() returns
         m_stratum.disconnect();
 
+        // The probe thread found a faster pool and ended the session on purpose
+        {
+            size_t switch_to = m_switch_to.exchange(SIZE_MAX);
+            if (switch_to != SIZE_MAX && m_running) {
+                std::lock_guard<std::mutex> lock(m_job_mutex);
+                m_journal.record(utils::JournalEvent::PoolSwitch, m_current_pool_index.load(), switch_to);
+                m_events.publish("pool", nlohmann::json{{"state", "switch"}, {"from", m_current_pool_index.load()},
+                                                        {"to", switch_to}, {"reason", "latency"}}.dump());
+                m_current_pool_index = switch_to;
+                continue;
+            }
+        }
+
         if (m_running) {
             utils::Logger::instance().disconnected("Connection lost");
             consecutive_failures++;
@@ -222,12 +613,19 @@ void Miner::stratum_thread() {
         // Update fail count for current pool
         m_config.pools[m_current_pool_index].fail_count++;
 
+        // A switch requested while the connection was still being set up
+        m_switch_to = SIZE_MAX;
+
         // Check if we should switch to backup pool
         if (consecutive_failures >= MAX_CONSECUTIVE_FAILURES && m_config.pools.size() > 1) {
             size_t next_pool = (m_current_pool_index + 1) % m_config.pools.size();
 
-            // Don't switch if we're on a backup and primary might be back
-            if (m_current_pool_index != 0) {
+            if (m_ranker) {
+                // Next best by latency; probes bring us back once this pool recovers
+                std::lock_guard<std::mutex> lock(m_ranker_mutex);
+                next_pool = m_ranker->next_after_failure(m_current_pool_index);
+            } else if (m_current_pool_index != 0) {
+                // Don't switch if we're on a backup and primary might be back
                 auto now = std::chrono::steady_clock::now();
                 auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
                     now - m_last_primary_retry).count();
@@ -243,7 +641,13 @@ void Miner::stratum_thread() {
                          next_pool + 1, m_config.pools.size(),
                          m_config.pools[next_pool].host.c_str(),
                          m_config.pools[next_pool].port);
-                m_current_pool_index = next_pool;
+                {
+                    std::lock_guard<std::mutex> lock(m_job_mutex);
+                    m_journal.record(utils::JournalEvent::PoolSwitch, m_current_pool_index.load(), next_pool);
+                    m_events.publish("pool", nlohmann::json{{"state", "switch"}, {"from", m_current_pool_index.load()},
+                                                            {"to", next_pool}, {"reason", "failover"}}.dump());
+                    m_current_pool_index = next_pool;
+                }
                 consecutive_failures = 0;  // Reset for new pool
                 m_current_backoff_seconds = 5;  // Reset backoff for new pool
             }
@@ -258,16 +662,188 @@ void Miner::stratum_thread() {
     }
 }
 
+void Miner::probe_pools() {
+    constexpr uint32_t PROBE_TIMEOUT_MS = 2000;
+
+    // All pools at once, so a round takes one timeout at most
+    struct Result {
+        bool ok = false;
+        double connect_ms = 0.0;
+        double rtt_ms = 0.0;
+    };
+    std::vector<Result> results(m_config.pools.size());
+    std::vector<std::thread> probes;
+    for (size_t i = 0; i < m_config.pools.size(); i++) {
+        probes.emplace_back([this, i, &results] {
+            Result& r = results[i];
+            const PoolConfig& pool = m_config.pools[i];
+            r.ok = stratum::StratumClient::probe(pool.host, pool.port, PROBE_TIMEOUT_MS,
+                                                 r.connect_ms, r.rtt_ms, pool.tls, pool.tls_verify);
+        });
+    }
+    for (auto& t : probes) {
+        t.join();
+    }
+
+    size_t current;
+    {
+        std::lock_guard<std::mutex> lock(m_job_mutex);
+        current = m_current_pool_index;
+    }
+    std::lock_guard<std::mutex> lock(m_ranker_mutex);
+    for (size_t i = 0; i < results.size(); i++) {
+        m_ranker->record_probe(i, results[i].ok, results[i].connect_ms, results[i].rtt_ms);
+    }
+    double submit_ms = m_stratum.get_submit_rtt_ms();
+    if (submit_ms > 0) {
+        m_ranker->record_submit(current, submit_ms);
+    }
+}
+
+void Miner::probe_thread() {
+    while (m_running) {
+        for (uint32_t i = 0; i < m_config.pool_probe_interval * 10 && m_running; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        if (!m_running) break;
+
+        probe_pools();
+
+        // Only move a working session; failover handles the rest
+        if (!m_stratum.is_connected() || m_switch_to != SIZE_MAX) continue;
+
+        size_t current;
+        {
+            std::lock_guard<std::mutex> lock(m_job_mutex);
+            current = m_current_pool_index;
+        }
+        size_t target;
+        double current_ms, target_ms;
+        {
+            std::lock_guard<std::mutex> lock(m_ranker_mutex);
+            target = m_ranker->evaluate(current);
+            current_ms = m_ranker->entry(current).rtt_ms;
+            target_ms = m_ranker->entry(target).rtt_ms;
+        }
+        if (target == current) continue;
+
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << target_ms << " ms vs " << current_ms << " ms";
+        LOG_WARN("Switching to faster pool %zu/%zu: %s:%d (%s)",
+                 target + 1, m_config.pools.size(), m_config.pools[target].host.c_str(),
+                 m_config.pools[target].port, ss.str().c_str());
+        m_switch_to = target;
+        m_stratum.interrupt();
+    }
+}
+
 void Miner::stats_thread() {
+    uint64_t last_wraps = 0;
+    uint64_t last_hashes = m_stats.total_hashes();
+    auto last_time = std::chrono::steady_clock::now();
+    
+    // Per-thread hash counts at the last interval, and when each last moved
+    std::vector<uint64_t> thread_hashes(MinerStats::MAX_THREADS, 0);
+    std::vector<std::chrono::steady_clock::time_point> thread_progress(MinerStats::MAX_THREADS, last_time);
+
     while (m_running) {
         std::this_thread::sleep_for(std::chrono::seconds(m_config.stats_interval));
         
         if (!m_running) break;
         
+        // Every nonce of the current job was handed out before the pool sent a new one
+        uint64_t wraps = m_scheduler.wraps();
+        if (wraps != last_wraps) {
+            LOG_WARN("Nonce space exhausted %llu time(s); rescanning until the next job",
+                     static_cast<unsigned long long>(wraps - last_wraps));
+            last_wraps = wraps;
+        }
+        
         double hashrate = m_stats.get_hashrate();
+        double interval_hashrate = 0.0;
+        
+        // Hashrate over this interval drives the suggested difficulty; the
+        // password convention can only change it at the next connect
+        {
+            auto sample_time = std::chrono::steady_clock::now();
+            uint64_t hashes = m_stats.total_hashes();
+            double seconds = std::chrono::duration<double>(sample_time - last_time).count();
+            double suggest = 0.0;
+            if (seconds > 0.0) {
+                interval_hashrate = static_cast<double>(hashes - last_hashes) / seconds;
+                std::lock_guard<std::mutex> lock(m_difficulty_mutex);
+                suggest = m_difficulty->update(interval_hashrate);
+            }
+            
+            // The interval's hashes, at the share difficulty they were mined for
+            double difficulty = 0.0;
+            size_t pool_index = 0;
+            {
+                std::lock_guard<std::mutex> lock(m_job_mutex);
+                difficulty = m_has_job ? m_current_job.difficulty : 0.0;
+                pool_index = m_current_pool_index;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_effective_mutex);
+                m_effective.add_work(sample_time, pool_index, static_cast<double>(hashes - last_hashes),
+                                     difficulty);
+            }
+            last_hashes = hashes;
+            last_time = sample_time;
+            if (suggest > 0.0 && m_config.difficulty_hint == DifficultyHint::Suggest && m_session_ready &&
+                m_stratum.suggest_difficulty(suggest)) {
+                log_suggestion(suggest);
+            }
+        }
         
         // Get system stats (temp, power)
         auto sys_stats = utils::SystemMonitor::instance().get_stats();
+        const double unavailable = std::numeric_limits<double>::quiet_NaN();
+        m_cpu_temp = sys_stats.temp_available ? sys_stats.cpu_temp : unavailable;
+        m_cpu_power = sys_stats.cpu_power_available ? sys_stats.cpu_power : unavailable;
+        m_gpu_power = sys_stats.gpu_power_available ? sys_stats.gpu_power : unavailable;
+        
+        if (m_thread_perf) {
+            update_perf_view();
+        }
+        
+        // API clients get this render until the next interval
+        if (m_config.api_enabled) {
+            m_api_server.publish(get_api_stats_json());
+        }
+        
+        nlohmann::json tick = {{"hashrate", std::round(interval_hashrate)},
+                               {"accepted", m_stats.shares_accepted.load()},
+                               {"rejected", m_stats.shares_rejected.load()},
+                               {"threads", m_active_threads.load()}};
+        if (sys_stats.temp_available) tick["temp"] = std::round(sys_stats.cpu_temp * 10.0) / 10.0;
+        if (sys_stats.cpu_power_available || sys_stats.gpu_power_available) {
+            tick["power"] = std::round((sys_stats.cpu_power + sys_stats.gpu_power) * 10.0) / 10.0;
+        }
+        m_events.publish("stats", tick.dump());
+        m_journal.record(utils::JournalEvent::Stats, static_cast<uint64_t>(interval_hashrate), m_active_threads.load());
+        m_journal.calibrate();
+        
+        // A worker that should be hashing but has not finished a scan since
+        // the last interval: descheduled, throttled, or stuck
+        {
+            auto now = std::chrono::steady_clock::now();
+            uint32_t active = std::min<uint32_t>(m_active_threads.load(), MinerStats::MAX_THREADS);
+            bool mining = m_has_job && !m_paused;
+            for (uint32_t i = 0; i < MinerStats::MAX_THREADS; i++) {
+                uint64_t hashes = m_stats.thread_hashes[i].load(std::memory_order_relaxed);
+                if (hashes != thread_hashes[i] || !mining || i >= active) {
+                    thread_hashes[i] = hashes;
+                    thread_progress[i] = now;
+                    continue;
+                }
+                auto stalled_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - thread_progress[i]).count();
+                if (stalled_ms >= 2000) {
+                    m_journal.record_thread(utils::JournalEvent::ThreadStall, static_cast<uint16_t>(i),
+                                     static_cast<uint64_t>(stalled_ms));
+                }
+            }
+        }
         
         // Calculate efficiency (KH/W) - use total power if available
         double efficiency = 0.0;
@@ -293,12 +869,27 @@ void Miner::stats_thread() {
             disp_stats.current_pool_index = m_current_pool_index;
         }
         disp_stats.total_pools = m_config.pools.size();
+        {
+            EffectiveHashrate::Window hour;
+            {
+                std::lock_guard<std::mutex> lock(m_effective_mutex);
+                hour = m_effective.window(std::chrono::steady_clock::now(), 3600.0);
+            }
+            if (hour.local > 0.0 && hour.expected > 0.0) {
+                disp_stats.effective_hashrate = hour.effective;
+                disp_stats.effective_margin = hour.effective > 0.0
+                    ? (hour.effective_high - hour.effective_low) / 2.0 / hour.effective : 1.0;
+                disp_stats.effective_gap = hour.gap;
+                disp_stats.luck = hour.luck;
+            }
+        }
         
         auto now = std::chrono::steady_clock::now();
         disp_stats.uptime_seconds = std::chrono::duration<double>(now - m_stats.start_time).count();
         
         // Collect per-thread hashrates
-        for (uint32_t i = 0; i < m_config.num_threads; i++) {
+        const uint32_t num_threads = m_stats.num_threads;
+        for (uint32_t i = 0; i < num_threads; i++) {
             disp_stats.thread_hashrates.push_back(m_stats.get_thread_hashrate(i));
         }
 
@@ -315,7 +906,7 @@ void Miner::stats_thread() {
 
         // Build per-thread string
         std::stringstream threads_ss;
-        for (uint32_t i = 0; i < m_config.num_threads; i++) {
+        for (uint32_t i = 0; i < num_threads; i++) {
             if (i > 0) threads_ss << ",";
             double thr = disp_stats.thread_hashrates[i];
             if (thr >= 1e6) threads_ss << std::fixed << std::setprecision(1) << (thr/1e6) << "M";
@@ -334,84 +925,456 @@ void Miner::stats_thread() {
                  << " ac=" << disp_stats.accepted
                  << " rj=" << disp_stats.rejected
                  << " thr=" << threads_ss.str();
+        
+        // Counter rates per thread, in the same order as thr=
+        if (m_thread_perf) {
+            std::lock_guard<std::mutex> lock(m_perf_mutex);
+            auto list = [&](const char* key, double PerfView::*field, int precision) {
+                stats_ss << " " << key << "=";
+                for (size_t i = 0; i < m_perf_view.size(); i++) {
+                    double v = m_perf_view[i].*field;
+                    stats_ss << (i ? "," : "");
+                    if (std::isnan(v)) stats_ss << "-";
+                    else stats_ss << std::fixed << std::setprecision(precision) << v;
+                }
+            };
+            if (!m_perf_view.empty()) {
+                list("ipc", &PerfView::ipc, 2);
+                list("ghz", &PerfView::ghz, 2);
+                list("cph", &PerfView::cycles_per_hash, 0);
+                list("bmh", &PerfView::mispredicts_per_hash, 3);
+            }
+        }
         LOG_INFO("%s", stats_ss.str().c_str());
         
-        // Write stats to file for HiveOS h-stats.sh (avoids screen buffer issues)
-        // SEC-001: Use per-user directory to prevent /tmp symlink attack.
-        // O_NOFOLLOW refuses to open if path is a symlink.
-#ifdef __linux__
+        // Update the shared stats segment in place for HiveOS h-stats.sh and
+        // other agents (bloxminer-stat): a poll reads memory, no log parsing
+        if (m_shared_stats.is_open()) {
+            utils::SharedStats shared;
+            memset(&shared, 0, sizeof(shared));
+            strncpy(shared.version, VERSION, sizeof(shared.version) - 1);
+            strncpy(shared.algo, "verushash", sizeof(shared.algo) - 1);
+            shared.updated_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            shared.pid = static_cast<uint32_t>(getpid());
+            shared.num_threads = std::min<uint32_t>(num_threads, utils::SharedStats::MAX_THREADS);
+            shared.uptime = disp_stats.uptime_seconds;
+            shared.hashrate = hashrate;
+            shared.accepted = disp_stats.accepted;
+            shared.rejected = disp_stats.rejected;
+            shared.stale = m_stats.shares_stale.load();
+            shared.cpu_temp = sys_stats.temp_available ? sys_stats.cpu_temp : 0.0;
+            shared.cpu_power = sys_stats.cpu_power;
+            shared.gpu_power = sys_stats.gpu_power;
+            shared.difficulty = disp_stats.difficulty;
+            shared.pool_index = static_cast<uint32_t>(disp_stats.current_pool_index);
+            shared.connected = m_session_ready ? 1 : 0;
+            for (uint32_t i = 0; i < shared.num_threads; i++) {
+                shared.thread_hashrate[i] = disp_stats.thread_hashrates[i];
+            }
+            m_shared_stats.publish(shared);
+        }
+    }
+}
+
+void Miner::update_perf_view() {
+    const uint32_t num_threads = std::min<uint32_t>(m_stats.num_threads, MinerStats::MAX_THREADS);
+    const uint32_t available = m_perf_available.load(std::memory_order_relaxed);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    m_perf_last.resize(MinerStats::MAX_THREADS);
+    if (available == 0) {
+        return;  // No worker could open its counters
+    }
+    
+    std::vector<PerfView> view;
+    view.reserve(num_threads);
+    for (uint32_t i = 0; i < num_threads; i++) {
+        const ThreadPerf& tp = m_thread_perf[i];
+        std::array<uint64_t, 7> now = {tp.cycles.load(), tp.instructions.load(), tp.branch_misses.load(),
+                                       tp.l1d_misses.load(), tp.ref_cycles.load(), tp.running_ns.load(),
+                                       tp.hashes.load()};
+        std::array<double, 7> d;
+        for (size_t k = 0; k < now.size(); k++) {
+            d[k] = static_cast<double>(now[k] - m_perf_last[i][k]);
+        }
+        m_perf_last[i] = now;
+        
+        const double cycles = d[0], instructions = d[1], branch_misses = d[2], l1d_misses = d[3];
+        const double ref_cycles = d[4], running_ns = d[5], hashes = d[6];
+        auto has = [available](utils::PerfCounters::Counter c) { return (available & (1u << c)) != 0; };
+        PerfView v;
+        v.ipc = cycles > 0 && has(utils::PerfCounters::Instructions) ? instructions / cycles : nan;
+        v.ghz = running_ns > 0 && cycles > 0 ? cycles / running_ns : nan;
+        v.freq_ratio = ref_cycles > 0 && has(utils::PerfCounters::RefCycles) ? cycles / ref_cycles : nan;
+        v.cycles_per_hash = hashes > 0 && cycles > 0 ? cycles / hashes : nan;
+        v.mispredicts_per_hash = hashes > 0 && has(utils::PerfCounters::BranchMisses) ? branch_misses / hashes : nan;
+        v.l1d_misses_per_hash = hashes > 0 && has(utils::PerfCounters::L1dMisses) ? l1d_misses / hashes : nan;
+        view.push_back(v);
+    }
+    
+    std::lock_guard<std::mutex> lock(m_perf_mutex);
+    m_perf_view = std::move(view);
+}
+
+void Miner::governor_thread() {
+    const auto interval = std::chrono::seconds(std::max<uint32_t>(1, m_config.governor_interval));
+    auto last_time = std::chrono::steady_clock::now();
+    uint64_t last_hashes = m_stats.total_hashes();
+    bool warned = false;
+    uint32_t last_threads = m_governor->current().threads;
+    int64_t last_duty_permille = 1000;
+    
+    while (m_running) {
+        // Sleep in short steps so stop() is not held up by the interval
+        auto wake = last_time + interval;
+        while (m_running && std::chrono::steady_clock::now() < wake) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        if (!m_running) break;
+        
+        auto now = std::chrono::steady_clock::now();
+        double dt = std::chrono::duration<double>(now - last_time).count();
+        uint64_t hashes = m_stats.total_hashes();
+        double hashrate = dt > 0 ? (hashes - last_hashes) / dt : 0.0;
+        last_time = now;
+        last_hashes = hashes;
+        
+        auto& monitor = utils::SystemMonitor::instance();
+        double measurement = 0.0;
+        switch (m_governor->mode()) {
+            case GovernorMode::Temperature:
+                measurement = monitor.get_cpu_temp();
+                break;
+            case GovernorMode::Power:
+                measurement = monitor.get_cpu_power();
+                break;
+            case GovernorMode::Efficiency: {
+                double power = monitor.get_cpu_power() + monitor.get_gpu_power();
+                // Paused or between jobs there is no efficiency to measure
+                measurement = power > 0 && hashrate > 0 ? hashrate / 1000.0 / power : 0.0;
+                break;
+            }
+            default:
+                break;
+        }
+        if (measurement <= 0.0) {
+            if (!warned && !m_paused && m_has_job) {
+                LOG_WARN("Governor: no %s reading available, holding current capacity",
+                         Governor::mode_name(m_governor->mode()));
+                warned = true;
+            }
+            continue;
+        }
+        
+        Governor::Decision decision;
+        {
+            std::lock_guard<std::mutex> lock(m_governor_mutex);
+            decision = m_governor->update(measurement, dt);
+        }
+        m_duty = decision.duty;
+        
+        // Journal real moves, not the small duty corrections of every interval
+        int64_t duty_permille = std::lround(decision.duty * 1000.0);
+        if (decision.threads != last_threads || std::abs(duty_permille - last_duty_permille) >= 50) {
+            m_journal.record(utils::JournalEvent::Governor, decision.threads, static_cast<uint64_t>(duty_permille));
+            last_duty_permille = duty_permille;
+        }
+        
+        if (decision.threads != last_threads) {
+            last_threads = decision.threads;
+            // LOG_INFO has no precision support; format the numbers here
+            std::stringstream ss;
+            ss << "Governor: " << Governor::mode_name(m_governor->mode()) << " "
+               << std::fixed << std::setprecision(1) << measurement
+               << ", capacity " << std::setprecision(0) << decision.capacity * 100.0 << "% -> "
+               << decision.threads << " threads at " << decision.duty * 100.0 << "% duty";
+            LOG_INFO("%s", ss.str().c_str());
+            update_pool();
+        }
+    }
+}
+
+// Cumulative "some" CPU stall time in microseconds from /proc/pressure/cpu
+static bool read_cpu_pressure_total(uint64_t& total_us) {
+    std::ifstream file("/proc/pressure/cpu");
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.compare(0, 5, "some ") != 0) continue;
+        size_t pos = line.find("total=");
+        if (pos == std::string::npos) return false;
+        total_us = std::strtoull(line.c_str() + pos + 6, nullptr, 10);
+        return true;
+    }
+    return false;
+}
+
+// Cumulative run-queue wait of this process's threads in nanoseconds (schedstat field 2).
+// Threads that exited since the last read drop out, so callers clamp the delta at 0.
+static bool read_own_wait_total(uint64_t& total_ns) {
+    DIR* dir = opendir("/proc/self/task");
+    if (!dir) return false;
+    bool any = false;
+    total_ns = 0;
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+        std::ifstream file(std::string("/proc/self/task/") + entry->d_name + "/schedstat");
+        uint64_t run_ns = 0, wait_ns = 0;
+        if (file >> run_ns >> wait_ns) {
+            total_ns += wait_ns;
+            any = true;
+        }
+    }
+    closedir(dir);
+    return any;
+}
+
+void Miner::background_thread() {
+    const auto poll = std::chrono::milliseconds(std::max<uint32_t>(10, m_config.background_poll_ms));
+    
+    uint64_t last_total = 0;
+    if (!read_cpu_pressure_total(last_total)) {
+        LOG_WARN("Background mode: /proc/pressure/cpu unavailable (kernel without PSI); "
+                 "workers run at idle priority but are not shed");
+        return;
+    }
+    // PSI counts the workers too whenever they wait for a core. Their wait is
+    // taken out of it, so only other tasks' stalls count as foreground pressure.
+    uint64_t last_own = 0;
+    bool own_available = read_own_wait_total(last_own);
+    if (!own_available) {
+        LOG_WARN("Background mode: /proc/self/task/*/schedstat unavailable; "
+                 "the workers' own wait counts as foreground pressure");
+    }
+    long cpus = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+    auto last_time = std::chrono::steady_clock::now();
+    uint32_t last_allowed = m_requested_threads;
+    
+    while (m_running) {
+        std::this_thread::sleep_for(poll);
+        if (!m_running) break;
+        
+        uint64_t total = 0;
+        if (!read_cpu_pressure_total(total)) continue;
+        uint64_t own = 0;
+        if (own_available && !read_own_wait_total(own)) own = last_own;
+        auto now = std::chrono::steady_clock::now();
+        double dt = std::chrono::duration<double>(now - last_time).count();
+        double stall = dt > 0 ? (total - last_total) / 1e6 / dt * 100.0 : 0.0;
+        // PSI "some" averages over CPUs, so the workers' wait is spread over all of them
+        double own_pressure = dt > 0 && own > last_own ? (own - last_own) / 1e9 / dt / cpus * 100.0 : 0.0;
+        own_pressure = std::min(own_pressure, stall);
+        double pressure = stall - own_pressure;
+        last_total = total;
+        last_own = own;
+        last_time = now;
+        
+        // What one worker gives up per second while shed
+        uint32_t active = m_stats.num_threads;
+        double thread_rate = 0.0;
+        for (uint32_t i = 0; i < active; i++) {
+            thread_rate += m_stats.get_thread_hashrate(i);
+        }
+        thread_rate = active > 0 ? thread_rate / active : 0.0;
+        
+        uint32_t allowed;
+        {
+            std::lock_guard<std::mutex> lock(m_pressure_mutex);
+            allowed = m_pressure->update(pressure, own_pressure, dt, thread_rate);
+        }
+        if (allowed == last_allowed) continue;
+        
+        // Log the edges; the steps in between are DEBUG
+        uint32_t requested = m_requested_threads;
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << pressure << "% (own " << own_pressure << "%)";
+        if (last_allowed >= requested) {
+            LOG_INFO("Background: CPU pressure %s, shedding to %u threads", ss.str().c_str(), allowed);
+        } else if (allowed >= requested) {
+            LOG_INFO("Background: CPU pressure %s, back to %u threads", ss.str().c_str(), allowed);
+        } else {
+            LOG_DEBUG("Background: CPU pressure %s, %u threads", ss.str().c_str(), allowed);
+        }
+        last_allowed = allowed;
+        update_pool();
+    }
+}
+
+void Miner::heal_thread() {
+    const auto interval = std::chrono::seconds(std::max<uint32_t>(1, m_config.heal_interval));
+    constexpr size_t HEAL_LOG_SIZE = 16;
+    auto last_time = std::chrono::steady_clock::now();
+    uint64_t last_generation = m_placement_generation.load();
+    std::vector<uint64_t> last_hashes;
+
+    while (m_running) {
+        auto wake = last_time + interval;
+        while (m_running && std::chrono::steady_clock::now() < wake) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        if (!m_running) break;
+
+        auto now = std::chrono::steady_clock::now();
+        double dt = std::chrono::duration<double>(now - last_time).count();
+        last_time = now;
+        uint32_t n = std::min<uint32_t>(m_active_threads.load(), MinerStats::MAX_THREADS);
+        std::vector<uint64_t> hashes(n);
+        for (uint32_t i = 0; i < n; i++) {
+            hashes[i] = m_stats.thread_hashes[i].load(std::memory_order_relaxed);
+        }
+
+        // Only a whole interval of everyone mining on the same CPUs compares
+        // fairly; workers re-pin and reset their counts when the pool changes
+        uint64_t generation = m_placement_generation.load();
+        bool comparable = generation == last_generation && hashes.size() == last_hashes.size() &&
+                          m_has_job && !m_paused && m_placement == ThreadPlacement::Pinned;
+        std::vector<double> rates(n);
+        for (uint32_t i = 0; comparable && i < n; i++) {
+            if (hashes[i] < last_hashes[i]) {
+                comparable = false;
+                break;
+            }
+            rates[i] = (hashes[i] - last_hashes[i]) / dt;
+        }
+        last_generation = generation;
+        last_hashes = std::move(hashes);
+        if (!comparable) {
+            continue;
+        }
+
+        std::vector<PlacementHealer::Decision> decisions;
         {
-            char uid_dir[64];
-            snprintf(uid_dir, sizeof(uid_dir), "/tmp/bloxminer-%d", static_cast<int>(getuid()));
-            mkdir(uid_dir, 0700);
-            char stats_path[128];
-            snprintf(stats_path, sizeof(stats_path), "%s/stats.txt", uid_dir);
-            int fd = open(stats_path, O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW, 0600);
-            if (fd >= 0) {
-                std::string content = stats_ss.str() + "\n";
-                write(fd, content.c_str(), content.size());
-                close(fd);
+            std::lock_guard<std::mutex> lock(m_healer_mutex);
+            decisions = m_healer->update(rates);
+            int64_t unix_now = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            for (const auto& d : decisions) {
+                m_heal_log.push_back({unix_now, d});
+                if (m_heal_log.size() > HEAL_LOG_SIZE) {
+                    m_heal_log.pop_front();
+                }
+            }
+        }
+
+        for (const auto& d : decisions) {
+            // LOG_* has no precision support; format the numbers here
+            std::stringstream ss;
+            ss << "Heal: thread " << d.thread << " on CPU " << d.from_cpu << " at " << std::fixed
+               << std::setprecision(1) << d.hashrate / 1000.0 << " KH/s, " << std::setprecision(0)
+               << (1.0 - d.hashrate / d.median) * 100.0 << "% below the median " << std::setprecision(1)
+               << d.median / 1000.0 << " KH/s: ";
+            switch (d.action) {
+                case PlacementHealer::Action::Move:
+                    ss << "moved to CPU " << d.to_cpu << ", CPU " << d.from_cpu << " no longer used";
+                    break;
+                case PlacementHealer::Action::Retire:
+                    ss << "no spare CPU, retired; CPU " << d.from_cpu << " no longer used";
+                    if (d.to_cpu >= 0) {
+                        ss << " (thread " << d.thread << " takes CPU " << d.to_cpu << ")";
+                    }
+                    break;
+                case PlacementHealer::Action::Keep:
+                    ss << (d.was_moved ? "still slow after a move, kept (not the CPU)"
+                                       : "no spare CPU and not slow enough to retire, kept");
+                    break;
+            }
+            LOG_WARN("%s", ss.str().c_str());
+
+            uint64_t action = d.action == PlacementHealer::Action::Move ? 0
+                              : (d.action == PlacementHealer::Action::Retire ? 1 : 2);
+            m_journal.record_thread(utils::JournalEvent::Heal, static_cast<uint16_t>(d.thread), action,
+                                    (static_cast<uint64_t>(static_cast<uint32_t>(d.from_cpu)) << 32) |
+                                        static_cast<uint32_t>(d.to_cpu));
+            nlohmann::json event = {{"thread", d.thread}, {"action", PlacementHealer::action_name(d.action)},
+                                    {"from_cpu", d.from_cpu},
+                                    {"hashrate", std::round(d.hashrate)}, {"median", std::round(d.median)}};
+            event["to_cpu"] = d.to_cpu >= 0 ? nlohmann::json(d.to_cpu) : nlohmann::json(nullptr);
+            m_events.publish("heal", event.dump());
+        }
+
+        // Workers re-pin at their next range boundary; a retirement shrinks the pool
+        for (const auto& d : decisions) {
+            if (d.action == PlacementHealer::Action::Move) {
+                m_placement_generation++;
+            } else if (d.action == PlacementHealer::Action::Retire) {
+                update_pool();
             }
         }
-#endif
     }
 }
 
 void Miner::mining_thread(uint32_t thread_id) {
-    // Pin thread to specific CPU core for better cache locality.
-    // Skip if hw == 0 (sandbox/container) or oversubscribed (would alias cores).
+    uint64_t placement_generation = m_placement_generation.load();
+    apply_placement(thread_id);
+    
+    // Background mode: only run on CPU time nothing else wants
 #ifdef __linux__
-    {
-        unsigned hw = std::thread::hardware_concurrency();
-        if (hw > 0 && m_config.num_threads <= hw) {
-            cpu_set_t cpuset;
-            CPU_ZERO(&cpuset);
-            CPU_SET(thread_id, &cpuset);
-            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
-        }
+    if (m_config.background) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
     }
 #endif
 
     verus::Hasher hasher;
-    alignas(32) uint8_t hash[32];
-    alignas(32) uint8_t target[32];
+    verus::JobContext job_ctx;
+    verus::CandidateSink sink;
     
     // Full block buffer: 140-byte header + 3-byte prefix + 1344-byte solution = 1487 bytes
     alignas(32) uint8_t full_block[1536];  // Aligned and padded
     
-    // Intermediate state from hash_half (64 bytes)
-    alignas(32) uint8_t intermediate[64];
-    
-    // 15-byte nonceSpace for hash_with_nonce
+    // 15-byte nonceSpace; the mining nonce (bytes 11-14) is filled in by Hasher::scan()
     uint8_t nonceSpace[15] = {0};
     
     std::string current_job_id;
     std::string current_solution;
-    uint8_t solution_version = 0;
-    uint32_t nonce = thread_id;  // Each thread starts at different offset
-    uint32_t nonce_step = m_config.num_threads;
+    uint64_t current_generation = 0;
+    double current_difficulty = 0.0;   // Of the job and pool current_generation was built from,
+    size_t current_pool = 0;           // for shares that go stale before they are counted
     
     // Thread started silently for cleaner display
     
     // Initialize per-thread stats
     m_stats.init_thread(thread_id);
     
+    // Hardware counters, read once per range; mining goes on without them
+    utils::PerfCounters perf;
+    utils::PerfSample perf_last;
+    if (m_thread_perf && thread_id < MinerStats::MAX_THREADS) {
+        std::string error;
+        if (perf.open(error)) {
+            m_perf_available.fetch_or(perf.available(), std::memory_order_relaxed);
+        } else if (!m_perf_warned.exchange(true)) {
+            LOG_WARN("Performance counters unavailable: %s; mining without them", error.c_str());
+            std::lock_guard<std::mutex> lock(m_perf_mutex);
+            m_perf_error = error;
+        }
+    }
+    
     while (m_running) {
+        // Range boundary: where a worker pauses or moves (it may also retire mid-range)
+        if (thread_id >= m_active_threads) break;
+        if (m_placement_generation.load() != placement_generation) {
+            placement_generation = m_placement_generation.load();
+            apply_placement(thread_id);
+        }
+        
         // Wait for job
         {
             std::unique_lock<std::mutex> lock(m_job_mutex);
-            m_job_cv.wait_for(lock, std::chrono::milliseconds(100), [this] {
-                return m_has_job || !m_running;
+            m_job_cv.wait_for(lock, std::chrono::milliseconds(100), [this, thread_id] {
+                return (m_has_job && !m_paused) || !m_running || thread_id >= m_active_threads;
             });
             
             if (!m_running) break;
-            if (!m_has_job) continue;
+            if (!m_has_job || m_paused || thread_id >= m_active_threads) continue;
             
             // Check if job changed
-            if (m_current_job.job_id != current_job_id) {
+            if (m_job_generation.load() != current_generation) {
+                current_generation = m_job_generation.load();
                 current_job_id = m_current_job.job_id;
                 current_solution = m_current_job.solution;
-                memcpy(target, m_current_job.target, 32);
+                current_difficulty = m_current_job.difficulty;
+                current_pool = m_current_pool_index;
                 
                 // Build full block for hashing
                 memset(full_block, 0, sizeof(full_block));
@@ -428,9 +1391,6 @@ void Miner::mining_thread(uint32_t thread_id) {
                 size_t sol_bytes = current_solution.length() / 2;
                 utils::hex_to_bytes(current_solution, full_block + 143, sol_bytes);
                 
-                // Get solution version (first byte of solution body)
-                solution_version = full_block[143];
-                
                 // Save header nonce values to nonceSpace BEFORE clearing
                 // nonceSpace layout from ccminer (15 bytes total):
                 // - bytes 0-6: header[108:114] = first 7 bytes of nNonce (extranonce1 + padding)
@@ -441,101 +1401,206 @@ void Miner::mining_thread(uint32_t thread_id) {
                 //               memcpy(nonceSpace + 7, &pdata[32], 4);  // bytes 128-131
                 memcpy(nonceSpace, full_block + 108, 7);
                 memcpy(nonceSpace + 7, full_block + 128, 4);
-                // nonceSpace[11..14] will be set per-nonce
                 
-                // For version >= 7 with merged mining (solution[5] > 0), clear non-canonical data
-                if (solution_version >= 7 && full_block[143 + 5] > 0) {
-                    // Clear header fields: hashPrevBlock, hashMerkleRoot, hashFinalSaplingRoot (96 bytes at offset 4)
-                    memset(full_block + 4, 0, 96);
-                    // Clear nBits (4 bytes at offset 104)
-                    memset(full_block + 104, 0, 4);
-                    // Clear nNonce (32 bytes at offset 108)
-                    memset(full_block + 108, 0, 32);
-                    // Clear hashPrevMMRRoot and hashBlockMMRRoot in solution (64 bytes starting at solution byte 8)
-                    memset(full_block + 143 + 8, 0, 64);
-                }
-                
-                // Compute intermediate state from full block (once per job)
-                // This matches ccminer: VerusHashHalf(blockhash_half, full_data, 1487)
-                hasher.hash_half(full_block, 1487, intermediate);
-                
-                // Prepare CLHash key from intermediate (once per job)
-                // This matches ccminer: GenNewCLKey(blockhash_half, data_key)
-                hasher.prepare_key(intermediate);
+                // Canonicalize, hash_half and CLHash key (once per job)
+                // This matches ccminer: VerusHashHalf + GenNewCLKey
+                hasher.prepare_job(full_block, nonceSpace, m_current_job.target, job_ctx);
                 
-                // Debug: log job setup (only thread 0 to avoid flooding)
-                // Debug logging removed for cleaner display
-                
-                // Reset nonce for new job
-                nonce = thread_id;
+                // Pool notify to this thread hashing the new job
+                int64_t received = m_job_received_ns.load(std::memory_order_relaxed);
+                int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+                m_job_switch_seconds.observe(static_cast<double>(now_ns - received) / 1e9);
+                m_journal.record_thread(utils::JournalEvent::JobPrepared, static_cast<uint16_t>(thread_id),
+                                 current_generation, static_cast<uint64_t>(std::max<int64_t>(0, now_ns - received)));
             }
         }
         
-        // Mine batch
-        uint32_t batch_end = nonce + m_config.batch_size;
+        // Next contiguous nonce range for this job: our own, or stolen from a
+        // slower thread. Fails only if the job changed since we built job_ctx.
+        NonceScheduler::Range range;
+        if (!m_scheduler.acquire(thread_id, current_generation, range)) {
+            continue;
+        }
         
-        while (nonce < batch_end && m_running && m_has_job) {
-            // Check if job changed
-            if (m_current_job.job_id != current_job_id) {
+        // Mine range: Hasher::scan() owns the hot loop; this thread only checks
+        // for a new job between scans and submits the candidates it reports
+        auto range_start = std::chrono::steady_clock::now();
+        uint64_t nonce = range.begin;
+        
+        while (nonce < range.end && m_running && m_has_job) {
+            if (m_job_generation.load(std::memory_order_relaxed) != current_generation) {
+                // Keep the unscanned tail with the old job in case the pool sends it again
+                NonceScheduler::Range tail = range;
+                tail.begin = nonce;
+                std::lock_guard<std::mutex> lock(m_job_mutex);
+                m_jobs.give_back(current_generation, tail);
                 break;
             }
             
-            // Set mining nonce in nonceSpace (bytes 11-14, little-endian)
-            nonceSpace[11] = (nonce >> 0) & 0xFF;
-            nonceSpace[12] = (nonce >> 8) & 0xFF;
-            nonceSpace[13] = (nonce >> 16) & 0xFF;
-            nonceSpace[14] = (nonce >> 24) & 0xFF;
+            // Retired mid-range: hand the rest back for others to steal
+            if (thread_id >= m_active_threads.load(std::memory_order_relaxed)) {
+                NonceScheduler::Range tail = range;
+                tail.begin = nonce;
+                m_scheduler.release(thread_id, current_generation, tail);
+                break;
+            }
             
-            // Use two-stage hash with proper FillExtra rotation
-            // This matches ccminer's Verus2hash exactly
-            hasher.hash_with_nonce(intermediate, nonceSpace, hash);
-            // PERF-001: only per-thread counter; get_hashrate() sums these instead of a shared atomic
-            m_stats.thread_hashes[thread_id]++;
+            uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(range.end - nonce, SCAN_CHUNK_NONCES));
             
-            // Debug sampling disabled for production
-            // static thread_local uint64_t sample_count = 0;
-            // if (++sample_count % 500000 == 0) {
-            //     std::string hash_hex = utils::bytes_to_hex(hash, 32);
-            //     LOG_INFO("[SAMPLE] hash_last4=%s (target=40000000)", hash_hex.substr(56, 8).c_str());
-            // }
+            sink.clear();
+            uint32_t done = hasher.scan(job_ctx, static_cast<uint32_t>(nonce), count, 1, sink);
+            // PERF-001: only per-thread counter, bumped once per scan; get_hashrate() sums these
+            m_stats.thread_hashes[thread_id].fetch_add(done, std::memory_order_relaxed);
             
-            // Check if hash meets target
-            if (check_hash(hash, target)) {
+            for (uint32_t i = 0; i < sink.count; i++) {
                 // Found a share!
+                m_journal.record_thread(utils::JournalEvent::ShareFound, static_cast<uint16_t>(thread_id),
+                                 sink.nonces[i], current_generation);
                 std::lock_guard<std::mutex> lock(m_job_mutex);
                 
-                // Verify job hasn't changed before submitting
-                if (m_current_job.job_id == current_job_id) {
+                // Submit against the job it was found on, if the pool still accepts it
+                if (m_job_generation.load() == current_generation) {
                     utils::Logger::instance().share_found(m_current_job.difficulty);
-                    submit_share(m_current_job, nonce, current_solution);
+                    m_events.publish("share", nlohmann::json{{"thread", thread_id}, {"job", current_job_id},
+                                                             {"nonce", sink.nonces[i]}, {"late", false}}.dump());
+                    submit_share(m_current_job, sink.nonces[i], current_solution);
+                } else if (const stratum::Job* job = m_jobs.find(current_generation)) {
+                    // Newer job arrived without clean_jobs: this one is still valid
+                    m_stats.shares_late++;
+                    utils::Logger::instance().share_found(job->difficulty);
+                    m_events.publish("share", nlohmann::json{{"thread", thread_id}, {"job", current_job_id},
+                                                             {"nonce", sink.nonces[i]}, {"late", true}}.dump());
+                    submit_share(*job, sink.nonces[i], current_solution);
                 } else {
-                    // Job changed, share is stale - don't submit
+                    // Job changed, share is stale - don't submit; found all the same
+                    m_stats.shares_stale++;
+                    {
+                        std::lock_guard<std::mutex> effective_lock(m_effective_mutex);
+                        m_effective.add_found(std::chrono::steady_clock::now(), current_pool,
+                                              current_difficulty);
+                    }
                     LOG_WARN("Discarding stale share for job %s (current: %s)", 
                              current_job_id.c_str(), m_current_job.job_id.c_str());
                 }
             }
             
-            nonce += nonce_step;
+            nonce += done;
         }
         
-        // Wrap nonce if needed
-        if (nonce >= 0xFFFFFFFF - nonce_step) {
-            nonce = thread_id;
+        // Size the next range to the chunk wall-time target
+        double busy = std::chrono::duration<double>(std::chrono::steady_clock::now() - range_start).count();
+        m_scheduler.report(thread_id, nonce - range.begin, busy);
+        m_batch_seconds.observe(busy);
+        
+        utils::PerfSample sample;
+        if (perf.is_open() && perf.read(sample)) {
+            // Multiplexed counts are scaled estimates and can step back a little
+            auto add = [](std::atomic<uint64_t>& total, uint64_t now, uint64_t last) {
+                total.fetch_add(now > last ? now - last : 0, std::memory_order_relaxed);
+            };
+            ThreadPerf& tp = m_thread_perf[thread_id];
+            add(tp.cycles, sample.cycles, perf_last.cycles);
+            add(tp.instructions, sample.instructions, perf_last.instructions);
+            add(tp.branch_misses, sample.branch_misses, perf_last.branch_misses);
+            add(tp.l1d_misses, sample.l1d_misses, perf_last.l1d_misses);
+            add(tp.ref_cycles, sample.ref_cycles, perf_last.ref_cycles);
+            add(tp.running_ns, sample.running_ns, perf_last.running_ns);
+            tp.hashes.fetch_add(nonce - range.begin, std::memory_order_relaxed);
+            perf_last = sample;
+        }
+        
+        // Governor duty cycle: idle in proportion to the range just mined,
+        // waking early for a new job, a retire or shutdown
+        double duty = m_duty.load(std::memory_order_relaxed);
+        if (duty < 1.0) {
+            auto idle = std::chrono::duration<double>(std::min(1.0, busy * (1.0 - duty) / duty));
+            std::unique_lock<std::mutex> lock(m_job_mutex);
+            m_job_cv.wait_for(lock, idle, [this, thread_id, current_generation] {
+                return !m_running || thread_id >= m_active_threads ||
+                       m_job_generation.load() != current_generation;
+            });
         }
     }
     
-    // Thread stopped silently
+    // Thread stopped silently; a retired slot's hashes stay in the total
+    if (m_running) {
+        m_stats.retire_thread(thread_id);
+    }
 }
 
 void Miner::on_new_job(const stratum::Job& job) {
     std::lock_guard<std::mutex> lock(m_job_mutex);
     
+    // Park the outgoing job's unhanded nonces in case the pool sends it again
+    if (m_has_job) {
+        m_jobs.suspend(m_job_generation, m_scheduler.suspend(m_job_generation));
+    }
+    
+    m_job_received_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count(), std::memory_order_relaxed);
     m_current_job = job;
+    uint64_t generation = ++m_job_generation;
+    NonceScheduler::Progress progress;
+    bool resumed = m_jobs.add(generation, current_pool_key(), job, progress);
+    if (resumed) {
+        LOG_DEBUG("Job %s sent again, resuming its nonce ranges", job.job_id.c_str());
+        m_scheduler.resume(generation, m_active_threads, progress);
+    } else {
+        m_scheduler.reset(generation, m_active_threads);
+    }
+    m_journal.record(utils::JournalEvent::JobReceived, generation,
+                     (job.clean_jobs ? 1u : 0u) | (resumed ? 2u : 0u));
+    m_events.publish("job", nlohmann::json{{"job", job.job_id}, {"clean", job.clean_jobs},
+                                           {"difficulty", job.difficulty}, {"resumed", resumed}}.dump());
     m_has_job = true;
     m_job_cv.notify_all();
+    
+    if (m_session_ready) {
+        replay_buffered_shares();
+    }
+    
+    // Time without a fresh job: what a reconnect really costs
+    if (m_awaiting_first_job.exchange(false)) {
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - m_session_start).count();
+        m_first_job_ms = ms;
+        const stratum::ConnectTiming& t = m_stratum.last_connect_timing();
+        m_connect_timing = t;
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << ms << " ms (DNS " << t.dns_ms
+           << (t.dns_cached ? " cached" : "") << ", connect " << t.connect_ms;
+        if (t.tls) {
+            ss << ", TLS " << t.tls_ms << (t.tls_resumed ? " resumed" : " full");
+        }
+        if (t.handshake_ms > 0) {  // Zero if the job beat the authorize reply
+            ss << ", subscribe+authorize " << t.handshake_ms;
+        }
+        ss << ")";
+        LOG_INFO("First job %s", ss.str().c_str());
+    }
 }
 
-void Miner::on_share_result(bool accepted, const std::string& reason) {
+void Miner::on_share_result(bool accepted, const std::string& reason, double rtt_ms, double difficulty) {
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_difficulty_mutex);
+        m_difficulty->record_share(now);
+    }
+
+    // Results arrive on the session they were submitted to
+    size_t pool_index = m_current_pool_index.load(std::memory_order_relaxed);
+    if (difficulty > 0.0) {
+        std::lock_guard<std::mutex> lock(m_effective_mutex);
+        m_effective.add_result(now, pool_index, difficulty, accepted);
+    }
+    PoolShares& pool = m_pool_shares[pool_index];
+    (accepted ? pool.accepted : pool.rejected).fetch_add(1, std::memory_order_relaxed);
+    m_journal.record(utils::JournalEvent::ShareResult, accepted ? 1 : 0,
+                     static_cast<uint64_t>(std::max(0.0, rtt_ms * 1000.0)));
+    m_events.publish("share_result", nlohmann::json{{"accepted", accepted}, {"reason", reason.substr(0, 96)},
+                                                    {"rtt_ms", std::round(rtt_ms * 100.0) / 100.0}}.dump());
+    
     if (accepted) {
         m_stats.shares_accepted++;
         if (m_config.show_shares) {
@@ -553,18 +1618,85 @@ void Miner::submit_share(const stratum::Job& job, uint32_t nonce, const std::str
     share.ntime = job.ntime;
     share.nonce = nonce;
     share.solution = solution;
+    share.difficulty = job.difficulty;
+    {
+        std::lock_guard<std::mutex> lock(m_effective_mutex);
+        m_effective.add_found(std::chrono::steady_clock::now(), m_current_pool_index, job.difficulty);
+    }
     
-    m_stats.shares_submitted++;
-    m_stratum.submit_share(share);
+    // Journaled before the send: a fast pool's result can beat submit_share()'s return
+    if (m_session_ready) {
+        m_journal.record(utils::JournalEvent::ShareSubmitted, nonce, 0);
+        if (m_stratum.submit_share(share)) {
+            m_stats.shares_submitted++;
+            return;
+        }
+    }
+    
+    // No session to send it to: hold it for the reconnect instead of losing it
+    if (m_share_buffer) {
+        ShareBuffer::Pending pending;
+        pending.share = share;
+        pending.pool = current_pool_key();
+        pending.extranonce1 = job.extranonce1;
+        pending.prev_hash = job.prev_hash;
+        pending.found = std::chrono::steady_clock::now();
+        m_share_buffer->push(std::move(pending));
+        m_journal.record(utils::JournalEvent::ShareSubmitted, nonce, 1);
+        if (m_share_buffer->size() == 1) {
+            LOG_INFO("No pool session, buffering shares for replay");
+        }
+    }
 }
 
-bool Miner::check_hash(const uint8_t* hash, const uint8_t* target) {
-    return utils::meets_target(hash, target);
+void Miner::replay_buffered_shares() {
+    // Caller holds m_job_mutex and has a job from the new session in m_current_job
+    if (!m_share_buffer || m_share_buffer->size() == 0) return;
+    
+    size_t waiting = m_share_buffer->size();
+    std::vector<stratum::Share> replay = m_share_buffer->take(
+        current_pool_key(), m_current_job.extranonce1,
+        m_current_job.prev_hash, std::chrono::steady_clock::now());
+    
+    for (const auto& share : replay) {
+        m_stats.shares_submitted++;
+        m_journal.record(utils::JournalEvent::ShareSubmitted, share.nonce, 2);
+        m_stratum.submit_share(share);
+    }
+    if (replay.size() == waiting) {
+        LOG_INFO("Replayed %zu buffered share(s)", replay.size());
+    } else {
+        LOG_WARN("Replayed %zu of %zu buffered share(s); the rest no longer match the session or block",
+                 replay.size(), waiting);
+    }
+}
+
+void Miner::log_suggestion(double difficulty) {
+    std::stringstream ss;
+    ss << std::setprecision(6) << difficulty << " (one share per " << m_config.share_interval << " s)";
+    LOG_INFO("Suggesting share difficulty %s", ss.str().c_str());
+}
+
+std::string Miner::current_pool_key() const {
+    // Caller holds m_job_mutex (or is the stratum thread, which writes the index)
+    const PoolConfig& pool = m_config.pools[m_current_pool_index];
+    return pool.host + ":" + std::to_string(pool.port);
 }
 
 std::string Miner::get_api_stats_json() {
     double hashrate = m_stats.get_hashrate();
-    auto sys_stats = utils::SystemMonitor::instance().get_stats();
+    
+    // The stats thread's last readings: rendering must not take a RAPL sample of its own
+    utils::SystemStats sys_stats;
+    double cpu_temp = m_cpu_temp;
+    double cpu_power = m_cpu_power;
+    double gpu_power = m_gpu_power;
+    sys_stats.temp_available = !std::isnan(cpu_temp);
+    sys_stats.cpu_temp = sys_stats.temp_available ? cpu_temp : 0.0;
+    sys_stats.cpu_power_available = !std::isnan(cpu_power);
+    sys_stats.cpu_power = sys_stats.cpu_power_available ? cpu_power : 0.0;
+    sys_stats.gpu_power_available = !std::isnan(gpu_power);
+    sys_stats.gpu_power = sys_stats.gpu_power_available ? gpu_power : 0.0;
 
     auto now = std::chrono::steady_clock::now();
     double uptime = std::chrono::duration<double>(now - m_stats.start_time).count();
@@ -572,10 +1704,20 @@ std::string Miner::get_api_stats_json() {
     // Snapshot job fields under lock to avoid data race with on_new_job/stratum_thread
     double snap_difficulty;
     size_t snap_pool_index;
+    ShareBuffer::Stats snap_buffer;
+    size_t snap_buffer_waiting = 0;
+    size_t snap_window;
+    uint64_t snap_resumed;
     {
         std::lock_guard<std::mutex> lock(m_job_mutex);
+        snap_window = m_jobs.size();
+        snap_resumed = m_jobs.resumed();
         snap_difficulty = m_current_job.difficulty;
         snap_pool_index = m_current_pool_index;
+        if (m_share_buffer) {
+            snap_buffer = m_share_buffer->stats();
+            snap_buffer_waiting = m_share_buffer->size();
+        }
     }
 
     // Calculate efficiency based on total power (CPU + GPU)
@@ -584,11 +1726,30 @@ std::string Miner::get_api_stats_json() {
     if (total_power > 0) {
         efficiency = hashrate / 1000.0 / total_power;  // KH/W
     }
+
+    // Share rate against what the pool's difficulty and the suggestion aim for
+    std::stringstream diff_ss;
+    {
+        std::lock_guard<std::mutex> lock(m_difficulty_mutex);
+        const char* mode = m_config.difficulty_hint == DifficultyHint::Suggest ? "suggest" :
+                           m_config.difficulty_hint == DifficultyHint::Password ? "password" : "off";
+        uint64_t shares = m_stats.shares_accepted.load() + m_stats.shares_rejected.load();
+        diff_ss << "{\"mode\":\"" << mode << "\","
+                << "\"pool\":" << std::setprecision(6) << snap_difficulty << ","
+                << "\"suggested\":" << m_difficulty->suggested() << ","
+                << "\"suggestions\":" << m_difficulty->suggestions() << ","
+                << std::fixed << std::setprecision(2)
+                << "\"target_interval\":" << m_difficulty->options().target_interval << ","
+                << "\"expected_interval\":" << m_difficulty->expected_interval(snap_difficulty) << ","
+                << "\"observed_interval\":" << m_difficulty->observed_interval() << ","
+                << "\"shares_per_min\":" << (uptime > 0 ? shares * 60.0 / uptime : 0.0) << "}";
+    }
     
     // Build per-thread hashrates array
     std::stringstream hs_ss;
     hs_ss << "[";
-    for (uint32_t i = 0; i < m_config.num_threads; i++) {
+    const uint32_t num_threads = m_stats.num_threads;
+    for (uint32_t i = 0; i < num_threads; i++) {
         if (i > 0) hs_ss << ",";
         hs_ss << std::fixed << std::setprecision(1) << (m_stats.get_thread_hashrate(i) / 1000.0);  // KH/s
     }
@@ -601,23 +1762,161 @@ std::string Miner::get_api_stats_json() {
          << "\"version\":\"" << VERSION << "\","
          << "\"algorithm\":\"verushash\","
          << "\"uptime\":" << std::fixed << std::setprecision(0) << uptime << ","
+         << "\"paused\":" << (m_paused ? "true" : "false") << ","
          << "\"hashrate\":{";
     json << "\"total\":" << std::fixed << std::setprecision(2) << (hashrate / 1000.0) << ",";  // KH/s
     json << "\"threads\":" << hs_ss.str() << ",";
-    json << "\"unit\":\"KH/s\"},"
+    json << "\"unit\":\"KH/s\"},";
+    
+    // Pool-side hashrate from accepted share difficulty, luck and losses
+    {
+        struct Span {
+            const char* name;
+            double seconds;
+        };
+        const Span spans[] = {{"1h", 3600.0}, {"6h", 6 * 3600.0}, {"24h", 24 * 3600.0}};
+        auto now = std::chrono::steady_clock::now();
+        auto number = [&json](double v, int precision) {
+            if (std::isnan(v)) json << "null";
+            else json << std::fixed << std::setprecision(precision) << v;
+        };
+        std::lock_guard<std::mutex> lock(m_effective_mutex);
+        json << "\"effective\":{";
+        for (size_t s = 0; s < 3; s++) {
+            EffectiveHashrate::Window w = m_effective.window(now, spans[s].seconds);
+            json << (s ? "," : "") << "\"" << spans[s].name << "\":{"
+                 << "\"seconds\":" << std::fixed << std::setprecision(0) << w.seconds
+                 << ",\"local\":" << std::setprecision(2) << w.local / 1000.0
+                 << ",\"effective\":" << w.effective / 1000.0
+                 << ",\"effective_low\":" << w.effective_low / 1000.0
+                 << ",\"effective_high\":" << w.effective_high / 1000.0
+                 << ",\"gap\":";
+            number(w.gap, 4);
+            json << ",\"found\":" << w.found
+                 << ",\"accepted\":" << w.accepted
+                 << ",\"rejected\":" << w.rejected
+                 << ",\"expected\":" << std::fixed << std::setprecision(1) << w.expected
+                 << ",\"luck\":";
+            number(w.luck, 3);
+            json << ",\"luck_low\":";
+            number(w.luck_low, 3);
+            json << ",\"luck_high\":";
+            number(w.luck_high, 3);
+            json << ",\"lost\":" << std::fixed << std::setprecision(4) << w.lost;
+            if (m_config.pools.size() > 1) {
+                json << ",\"pools\":[";
+                bool first = true;
+                for (size_t i = 0; i < m_config.pools.size(); i++) {
+                    EffectiveHashrate::Window p = m_effective.window(now, spans[s].seconds, static_cast<int>(i));
+                    if (p.local <= 0.0 && p.found == 0) continue;
+                    json << (first ? "" : ",") << "{\"index\":" << i
+                         << ",\"local\":" << std::fixed << std::setprecision(2) << p.local / 1000.0
+                         << ",\"effective\":" << p.effective / 1000.0
+                         << ",\"accepted\":" << p.accepted
+                         << ",\"rejected\":" << p.rejected << "}";
+                    first = false;
+                }
+                json << "]";
+            }
+            json << "}";
+        }
+        json << ",\"unit\":\"KH/s\"},";
+    }
+    
+    // Hardware counters over the last stats interval, per thread
+    json << "\"perf\":{\"enabled\":" << (m_thread_perf ? "true" : "false");
+    if (m_thread_perf) {
+        std::lock_guard<std::mutex> lock(m_perf_mutex);
+        json << ",\"available\":" << (m_perf_available.load() ? "true" : "false");
+        if (!m_perf_error.empty()) {
+            json << ",\"error\":" << nlohmann::json(m_perf_error).dump();
+        }
+        auto number = [&json](double v, int precision) {
+            if (std::isnan(v)) json << "null";
+            else json << std::fixed << std::setprecision(precision) << v;
+        };
+        json << ",\"threads\":[";
+        for (size_t i = 0; i < m_perf_view.size(); i++) {
+            const PerfView& v = m_perf_view[i];
+            json << (i ? "," : "") << "{\"ipc\":";
+            number(v.ipc, 3);
+            json << ",\"ghz\":";
+            number(v.ghz, 3);
+            json << ",\"freq_ratio\":";
+            number(v.freq_ratio, 3);
+            json << ",\"cycles_per_hash\":";
+            number(v.cycles_per_hash, 0);
+            json << ",\"mispredicts_per_hash\":";
+            number(v.mispredicts_per_hash, 4);
+            json << ",\"l1d_misses_per_hash\":";
+            number(v.l1d_misses_per_hash, 2);
+            json << "}";
+        }
+        json << "]";
+    }
+    json << "},"
          << "\"shares\":{"
          << "\"accepted\":" << m_stats.shares_accepted.load() << ","
          << "\"rejected\":" << m_stats.shares_rejected.load() << ","
-         << "\"submitted\":" << m_stats.shares_submitted.load() << "},"
+         << "\"submitted\":" << m_stats.shares_submitted.load() << ","
+         << "\"late\":" << m_stats.shares_late.load() << ","
+         << "\"stale\":" << m_stats.shares_stale.load() << ","
+         << "\"buffered\":" << snap_buffer.buffered << ","
+         << "\"waiting\":" << snap_buffer_waiting << ","
+         << "\"replayed\":" << snap_buffer.replayed << ","
+         << "\"dropped\":{\"full\":" << snap_buffer.dropped_full
+         << ",\"stale\":" << snap_buffer.dropped_stale
+         << ",\"session\":" << snap_buffer.dropped_session << "}},"
+         << "\"jobs\":{\"valid\":" << snap_window << ",\"resumed\":" << snap_resumed << "},"
+         << "\"difficulty\":" << diff_ss.str() << ","
          << "\"pool\":{";
     json << "\"host\":\"" << m_config.pool_host << "\","
          << "\"port\":" << m_config.pool_port << ","
          << "\"worker\":\"" << m_config.worker_name << "\","
          << "\"difficulty\":" << std::fixed << std::setprecision(6) << snap_difficulty << ","
          << "\"current_index\":" << snap_pool_index << ","
-         << "\"total_pools\":" << m_config.pools.size() << "},"
+         << "\"total_pools\":" << m_config.pools.size() << ","
+         << "\"first_job_ms\":" << std::fixed << std::setprecision(1) << m_first_job_ms.load();
+    if (m_config.pools[snap_pool_index].tls) {
+        // Last handshake's time and whether its session ticket was accepted
+        stratum::ConnectTiming t;
+        {
+            std::lock_guard<std::mutex> lock(m_job_mutex);
+            t = m_connect_timing;
+        }
+        json << ",\"tls\":{"
+             << "\"handshake_ms\":" << t.tls_ms << ","
+             << "\"resumed\":" << (t.tls_resumed ? "true" : "false") << ","
+             << "\"handshakes\":" << m_stratum.tls_handshakes() << ","
+             << "\"resumptions\":" << m_stratum.tls_resumptions() << "}";
+    }
+    if (m_ranker) {
+        // Best first; latencies are smoothed probe measurements
+        std::lock_guard<std::mutex> lock(m_ranker_mutex);
+        json << ",\"selection\":\"latency\",\"ranking\":[";
+        std::vector<size_t> order = m_ranker->ranking();
+        for (size_t r = 0; r < order.size(); r++) {
+            size_t i = order[r];
+            const PoolRanker::Entry& e = m_ranker->entry(i);
+            if (r > 0) json << ",";
+            json << "{\"index\":" << i << ","
+                 << "\"host\":\"" << m_config.pools[i].host << "\","
+                 << "\"port\":" << m_config.pools[i].port << ","
+                 << "\"healthy\":" << (m_ranker->healthy(i) ? "true" : "false") << ","
+                 << "\"connect_ms\":" << std::fixed << std::setprecision(1) << e.connect_ms << ","
+                 << "\"rtt_ms\":" << e.rtt_ms << ",";
+            if (e.submit_ms > 0) {
+                json << "\"submit_ms\":" << e.submit_ms << ",";
+            }
+            json << "\"probes\":" << e.probes << ","
+                 << "\"failures\":" << e.failures << "}";
+        }
+        json << "]";
+    }
+    json << "},"
          << "\"hardware\":{";
-    json << "\"threads\":" << m_config.num_threads << ",";
+    json << "\"threads\":" << num_threads << ","
+         << "\"placement\":\"" << (m_placement == ThreadPlacement::Pinned ? "pinned" : "unpinned") << "\",";
     if (sys_stats.temp_available) {
         json << "\"temp\":" << std::fixed << std::setprecision(1) << sys_stats.cpu_temp << ",";
     }
@@ -631,11 +1930,174 @@ std::string Miner::get_api_stats_json() {
         json << "\"total_power\":" << std::fixed << std::setprecision(1) << total_power << ",";
         json << "\"efficiency\":" << std::fixed << std::setprecision(1) << efficiency << ",";
     }
-    json << "\"efficiency_unit\":\"KH/W\"},"
-         << "\"total_hashes\":" << m_stats.hashes.load()
+    json << "\"efficiency_unit\":\"KH/W\"},";
+    if (m_pressure) {
+        PressureController::Stats bg;
+        {
+            std::lock_guard<std::mutex> lock(m_pressure_mutex);
+            bg = m_pressure->stats();
+        }
+        json << "\"background\":{"
+             << "\"pressure\":" << std::fixed << std::setprecision(2) << bg.pressure << ","
+             << "\"own_pressure\":" << std::fixed << std::setprecision(2) << bg.own_pressure << ","
+             << "\"threads_allowed\":" << bg.allowed << ","
+             << "\"threads_fit\":" << bg.ceiling << ","
+             << "\"shed_events\":" << bg.shed_events << ","
+             << "\"worker_seconds_shed\":" << std::fixed << std::setprecision(1) << bg.worker_seconds_shed << ","
+             << "\"hashes_forgone\":" << std::fixed << std::setprecision(0) << bg.hashes_forgone << ","
+             << "\"stall_avoided_s\":" << std::fixed << std::setprecision(2) << bg.stall_avoided << "},";
+    }
+    if (m_healer) {
+        std::lock_guard<std::mutex> lock(m_healer_mutex);
+        json << "\"heal\":{"
+             << "\"cpus\":" << m_healer->cpus().size() << ","
+             << "\"excluded\":" << nlohmann::json(m_healer->excluded()).dump() << ","
+             << "\"moves\":" << m_healer->moves() << ","
+             << "\"retired\":" << m_healer->retired() << ","
+             << "\"decisions\":[";
+        for (size_t i = 0; i < m_heal_log.size(); i++) {
+            const PlacementHealer::Decision& d = m_heal_log[i].decision;
+            json << (i ? "," : "") << "{\"time\":" << m_heal_log[i].time
+                 << ",\"thread\":" << d.thread
+                 << ",\"action\":\"" << PlacementHealer::action_name(d.action) << "\""
+                 << ",\"from_cpu\":" << d.from_cpu
+                 << ",\"to_cpu\":";
+            if (d.to_cpu >= 0) json << d.to_cpu;
+            else json << "null";
+            json << ",\"hashrate\":" << std::fixed << std::setprecision(1) << d.hashrate / 1000.0
+                 << ",\"median\":" << std::fixed << std::setprecision(1) << d.median / 1000.0 << "}";
+        }
+        json << "]},";
+    }
+    if (m_governor) {
+        Governor::Decision decision;
+        {
+            std::lock_guard<std::mutex> lock(m_governor_mutex);
+            decision = m_governor->current();
+        }
+        json << "\"governor\":{"
+             << "\"mode\":\"" << Governor::mode_name(m_governor->mode()) << "\","
+             << "\"target\":" << std::fixed << std::setprecision(1) << m_governor->target() << ","
+             << "\"measurement\":" << std::fixed << std::setprecision(2) << decision.measurement << ","
+             << "\"capacity\":" << std::fixed << std::setprecision(3) << decision.capacity << ","
+             << "\"threads\":" << decision.threads << ","
+             << "\"duty\":" << std::fixed << std::setprecision(3) << decision.duty << "},";
+    }
+    json
+         << "\"total_hashes\":" << m_stats.total_hashes()
          << "}";
     
     return json.str();
 }
 
+std::string Miner::get_metrics_text() {
+    // Atomics only: a scrape never takes m_job_mutex or waits on a mining thread
+    utils::MetricsWriter out;
+    
+    out.family("bloxminer_hashes_total", "counter", "Hashes computed per mining thread");
+    const uint32_t num_threads = m_stats.num_threads;
+    for (uint32_t i = 0; i < num_threads && i < MinerStats::MAX_THREADS; i++) {
+        out.sample("bloxminer_hashes_total", "thread=\"" + std::to_string(i) + "\"",
+                   m_stats.thread_hashes[i].load(std::memory_order_relaxed));
+    }
+    out.sample("bloxminer_hashes_total", "thread=\"retired\"",
+               m_stats.retired_hashes.load(std::memory_order_relaxed));
+    
+    out.family("bloxminer_shares_total", "counter", "Shares by pool and result");
+    for (size_t i = 0; i < m_config.pools.size(); i++) {
+        std::string pool = "pool=\"" + utils::MetricsWriter::escape(
+            m_config.pools[i].host + ":" + std::to_string(m_config.pools[i].port)) + "\"";
+        out.sample("bloxminer_shares_total", pool + ",result=\"accepted\"",
+                   m_pool_shares[i].accepted.load(std::memory_order_relaxed));
+        out.sample("bloxminer_shares_total", pool + ",result=\"rejected\"",
+                   m_pool_shares[i].rejected.load(std::memory_order_relaxed));
+    }
+    
+    out.family("bloxminer_shares_discarded_total", "counter", "Shares found on a job the pool no longer accepts");
+    out.sample("bloxminer_shares_discarded_total", "", m_stats.shares_stale.load(std::memory_order_relaxed));
+    out.family("bloxminer_shares_late_total", "counter", "Shares submitted against an earlier, still valid job");
+    out.sample("bloxminer_shares_late_total", "", m_stats.shares_late.load(std::memory_order_relaxed));
+    
+    out.family("bloxminer_reconnects_total", "counter", "Pool sessions established after the first");
+    out.sample("bloxminer_reconnects_total", "", m_reconnects.load(std::memory_order_relaxed));
+    
+    out.family("bloxminer_hashrate", "gauge", "Average hashes per second since start");
+    out.sample("bloxminer_hashrate", "", m_stats.get_hashrate());
+    out.family("bloxminer_active_threads", "gauge", "Mining threads currently running");
+    out.sample("bloxminer_active_threads", "", static_cast<uint64_t>(m_active_threads.load()));
+    out.family("bloxminer_pool_difficulty", "gauge", "Share difficulty set by the pool");
+    out.sample("bloxminer_pool_difficulty", "", m_stratum.get_difficulty());
+    out.family("bloxminer_pool_connected", "gauge", "1 while a pool session is up");
+    out.sample("bloxminer_pool_connected", "", static_cast<uint64_t>(m_session_ready ? 1 : 0));
+    out.family("bloxminer_pool_index", "gauge", "Configured pool currently mined (0-based)");
+    out.sample("bloxminer_pool_index", "", static_cast<uint64_t>(m_current_pool_index.load()));
+    
+    double temp = m_cpu_temp;
+    if (!std::isnan(temp)) {
+        out.family("bloxminer_cpu_temperature_celsius", "gauge", "CPU package temperature");
+        out.sample("bloxminer_cpu_temperature_celsius", "", temp);
+    }
+    double cpu_power = m_cpu_power;
+    double gpu_power = m_gpu_power;
+    if (!std::isnan(cpu_power) || !std::isnan(gpu_power)) {
+        out.family("bloxminer_power_watts", "gauge", "Power draw by device");
+        if (!std::isnan(cpu_power)) out.sample("bloxminer_power_watts", "device=\"cpu\"", cpu_power);
+        if (!std::isnan(gpu_power)) out.sample("bloxminer_power_watts", "device=\"gpu\"", gpu_power);
+    }
+    
+    out.histogram("bloxminer_share_rtt_seconds", "Share submit to pool response",
+                  m_stratum.submit_rtt_histogram());
+    out.histogram("bloxminer_job_switch_seconds", "Pool notify to a mining thread hashing the new job",
+                  m_job_switch_seconds);
+    out.histogram("bloxminer_batch_seconds", "Wall time of one nonce range on a mining thread",
+                  m_batch_seconds);
+    
+    return out.str();
+}
+
+int Miner::handle_control(const std::string& action, const std::string& body, std::string& response) {
+    using json = nlohmann::json;
+    
+    json request = body.empty() ? json::object() : json::parse(body, nullptr, false);
+    if (request.is_discarded() || !request.is_object()) {
+        response = R"({"error":"body must be a JSON object"})";
+        return 400;
+    }
+    
+    if (action == "threads") {
+        // Range-checked as read: narrowing first would turn 2^32 + 1 into 1
+        uint64_t threads = request.contains("threads") && request["threads"].is_number_unsigned()
+                               ? request["threads"].get<uint64_t>() : 0;
+        if (threads > MinerStats::MAX_THREADS || !set_thread_count(static_cast<uint32_t>(threads))) {
+            response = "{\"error\":\"threads must be 1-" + std::to_string(MinerStats::MAX_THREADS) + "\"}";
+            return 400;
+        }
+    } else if (action == "pause") {
+        set_paused(true);
+    } else if (action == "resume") {
+        set_paused(false);
+    } else if (action == "placement") {
+        std::string placement = request.contains("placement") && request["placement"].is_string()
+                                    ? request["placement"].get<std::string>() : "";
+        if (placement == "pinned") {
+            set_placement(ThreadPlacement::Pinned);
+        } else if (placement == "unpinned") {
+            set_placement(ThreadPlacement::Unpinned);
+        } else {
+            response = R"({"error":"placement must be \"pinned\" or \"unpinned\""})";
+            return 400;
+        }
+    } else {
+        response = R"({"error":"unknown action","actions":["threads","pause","resume","placement"]})";
+        return 404;
+    }
+    
+    json state;
+    state["threads"] = m_stats.num_threads.load();
+    state["paused"] = m_paused.load();
+    state["placement"] = m_placement == ThreadPlacement::Pinned ? "pinned" : "unpinned";
+    response = state.dump();
+    return 200;
+}
+
 }  // namespace bloxminer
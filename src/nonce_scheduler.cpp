@@ -0,0 +1,275 @@
+#include "../include/nonce_scheduler.hpp"
+
+#include <algorithm>
+
+namespace bloxminer {
+
+NonceScheduler::NonceScheduler(uint32_t target_ms, uint64_t space)
+    : m_target_seconds(target_ms / 1000.0), m_space(space) {
+}
+
+void NonceScheduler::set_target_ms(uint32_t target_ms) {
+    m_target_seconds.store(target_ms / 1000.0, std::memory_order_relaxed);
+}
+
+void NonceScheduler::seed(uint64_t epoch, uint64_t pass, uint32_t num_workers) {
+    for (uint32_t i = 0; i < MAX_WORKERS; i++) {
+        Slot& slot = m_slots[i];
+        std::lock_guard<std::mutex> lock(slot.lock);
+        slot.epoch = epoch;
+        slot.pass = pass;
+        if (i < num_workers) {
+            slot.begin = m_space * i / num_workers;
+            slot.end = m_space * (i + 1) / num_workers;
+        } else {
+            slot.begin = slot.end = 0;
+        }
+        slot.remaining.store(slot.end - slot.begin, std::memory_order_relaxed);
+    }
+}
+
+void NonceScheduler::reset(uint64_t epoch, uint32_t num_workers) {
+    num_workers = std::max<uint32_t>(1, std::min(num_workers, MAX_WORKERS));
+
+    std::lock_guard<std::mutex> lock(m_seed_mutex);
+    m_epoch.store(epoch, std::memory_order_release);
+    m_num_workers.store(num_workers, std::memory_order_release);
+    m_pass.store(0, std::memory_order_relaxed);
+    m_backlog.clear();
+    seed(epoch, 0, num_workers);
+}
+
+NonceScheduler::Progress NonceScheduler::suspend(uint64_t epoch) {
+    Progress progress;
+    std::lock_guard<std::mutex> lock(m_seed_mutex);
+    if (m_epoch.load(std::memory_order_relaxed) != epoch) {
+        return progress;
+    }
+    progress.pass = m_pass.load(std::memory_order_relaxed);
+    progress.ranges = m_backlog;
+    const uint32_t num_workers = m_num_workers.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < num_workers; i++) {
+        Slot& slot = m_slots[i];
+        std::lock_guard<std::mutex> slot_lock(slot.lock);
+        if (slot.epoch == epoch && slot.begin < slot.end) {
+            progress.ranges.push_back(Range{slot.begin, slot.end, slot.pass});
+        }
+    }
+    return progress;
+}
+
+void NonceScheduler::resume(uint64_t epoch, uint32_t num_workers, const Progress& progress) {
+    num_workers = std::max<uint32_t>(1, std::min(num_workers, MAX_WORKERS));
+
+    std::lock_guard<std::mutex> lock(m_seed_mutex);
+    m_epoch.store(epoch, std::memory_order_release);
+    m_num_workers.store(num_workers, std::memory_order_release);
+    m_pass.store(progress.pass, std::memory_order_relaxed);
+
+    // Smallest first, so the largest are popped into the slots
+    m_backlog = progress.ranges;
+    std::sort(m_backlog.begin(), m_backlog.end(),
+              [](const Range& a, const Range& b) { return a.size() < b.size(); });
+    for (uint32_t i = 0; i < MAX_WORKERS; i++) {
+        Slot& slot = m_slots[i];
+        std::lock_guard<std::mutex> slot_lock(slot.lock);
+        slot.epoch = epoch;
+        slot.pass = progress.pass;
+        slot.begin = slot.end = 0;
+        if (i < num_workers && !m_backlog.empty()) {
+            slot.begin = m_backlog.back().begin;
+            slot.end = m_backlog.back().end;
+            slot.pass = m_backlog.back().pass;
+            m_backlog.pop_back();
+        }
+        slot.remaining.store(slot.end - slot.begin, std::memory_order_relaxed);
+    }
+}
+
+void NonceScheduler::resize(uint32_t num_workers) {
+    num_workers = std::max<uint32_t>(1, std::min(num_workers, MAX_WORKERS));
+
+    // seed() gave every slot the current epoch, so new slots are empty but
+    // valid and can park what their workers steal
+    std::lock_guard<std::mutex> lock(m_seed_mutex);
+    if (num_workers > m_num_workers.load(std::memory_order_relaxed)) {
+        m_num_workers.store(num_workers, std::memory_order_release);
+    }
+}
+
+bool NonceScheduler::take_front(Slot& slot, uint64_t epoch, uint64_t chunk, Range& out) {
+    std::lock_guard<std::mutex> lock(slot.lock);
+    if (slot.epoch != epoch || slot.begin == slot.end) {
+        return false;
+    }
+    uint64_t n = std::min(chunk, slot.end - slot.begin);
+    out.begin = slot.begin;
+    out.end = slot.begin + n;
+    out.pass = slot.pass;
+    slot.begin += n;
+    slot.remaining.store(slot.end - slot.begin, std::memory_order_relaxed);
+    return true;
+}
+
+bool NonceScheduler::steal(uint32_t worker, uint64_t epoch, Range& out) {
+    const uint32_t num_workers = m_num_workers.load(std::memory_order_acquire);
+    // Workers outside the current pool have no slot to park a stolen range in
+    const bool park = worker < num_workers;
+    const uint64_t chunk = chunk_size(worker);
+
+    // A victim can drain between selection and locking; pick again
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint32_t victim = num_workers;
+        uint64_t best = 0;
+        for (uint32_t i = 0; i < num_workers; i++) {
+            if (i == worker) continue;
+            uint64_t r = m_slots[i].remaining.load(std::memory_order_relaxed);
+            if (r > best) {
+                best = r;
+                victim = i;
+            }
+        }
+        if (victim == num_workers) {
+            return false;
+        }
+
+        Range stolen;
+        {
+            Slot& v = m_slots[victim];
+            std::lock_guard<std::mutex> lock(v.lock);
+            if (v.epoch != epoch) {
+                return false;
+            }
+            uint64_t avail = v.end - v.begin;
+            if (avail == 0) continue;
+
+            // Back half, so the victim keeps its cache-warm front; small tails go whole
+            uint64_t take;
+            if (!park) {
+                take = std::min(avail, chunk);
+            } else {
+                take = avail <= 2 * MIN_CHUNK ? avail : avail / 2;
+            }
+            stolen.begin = v.end - take;
+            stolen.end = v.end;
+            stolen.pass = v.pass;
+            v.end -= take;
+            v.remaining.store(v.end - v.begin, std::memory_order_relaxed);
+        }
+        m_steals.fetch_add(1, std::memory_order_relaxed);
+
+        out = stolen;
+        if (park && stolen.size() > chunk) {
+            // Keep one chunk, park the rest as our own range so it can be stolen in turn
+            Slot& own = m_slots[worker];
+            std::lock_guard<std::mutex> lock(own.lock);
+            if (own.epoch != epoch) {
+                return false;
+            }
+            // A restart may have refilled our slot meanwhile; then run the stolen range whole
+            if (own.begin == own.end) {
+                out.end = stolen.begin + chunk;
+                own.begin = out.end;
+                own.end = stolen.end;
+                own.pass = stolen.pass;
+                own.remaining.store(own.end - own.begin, std::memory_order_relaxed);
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+bool NonceScheduler::acquire(uint32_t worker, uint64_t epoch, Range& out) {
+    for (;;) {
+        if (m_epoch.load(std::memory_order_acquire) != epoch) {
+            return false;
+        }
+
+        const uint32_t num_workers = m_num_workers.load(std::memory_order_acquire);
+        if (worker < num_workers &&
+            take_front(m_slots[worker], epoch, chunk_size(worker), out)) {
+            return true;
+        }
+        if (steal(worker, epoch, out)) {
+            return true;
+        }
+
+        // Every range has been handed out: restart the space for this job.
+        // Ranges still being scanned from the previous pass are not waited for.
+        std::lock_guard<std::mutex> lock(m_seed_mutex);
+        if (m_epoch.load(std::memory_order_relaxed) != epoch) {
+            return false;
+        }
+        bool empty = true;
+        for (uint32_t i = 0; i < num_workers && empty; i++) {
+            empty = m_slots[i].remaining.load(std::memory_order_relaxed) == 0;
+        }
+        if (empty && !m_backlog.empty()) {
+            // A resumed job's leftover ranges come before a restart
+            for (uint32_t i = 0; i < num_workers && !m_backlog.empty(); i++) {
+                Slot& slot = m_slots[i];
+                std::lock_guard<std::mutex> slot_lock(slot.lock);
+                slot.begin = m_backlog.back().begin;
+                slot.end = m_backlog.back().end;
+                slot.pass = m_backlog.back().pass;
+                slot.remaining.store(slot.end - slot.begin, std::memory_order_relaxed);
+                m_backlog.pop_back();
+            }
+        } else if (empty) {
+            uint64_t pass = m_pass.fetch_add(1, std::memory_order_relaxed) + 1;
+            m_wraps.fetch_add(1, std::memory_order_relaxed);
+            seed(epoch, pass, num_workers);
+        }
+    }
+}
+
+bool NonceScheduler::release(uint32_t worker, uint64_t epoch, const Range& range) {
+    if (range.begin >= range.end) {
+        return true;
+    }
+    if (worker >= MAX_WORKERS) {
+        return false;
+    }
+    Slot& slot = m_slots[worker];
+    std::lock_guard<std::mutex> lock(slot.lock);
+    // After a restart or a new job the tail is covered again anyway
+    if (slot.epoch != epoch || slot.pass != range.pass) {
+        return false;
+    }
+    // Slots hold one contiguous range: rejoin it at either end, or refill an empty slot
+    if (slot.begin == slot.end) {
+        slot.begin = range.begin;
+        slot.end = range.end;
+    } else if (range.end == slot.begin) {
+        slot.begin = range.begin;
+    } else if (range.begin == slot.end) {
+        slot.end = range.end;
+    } else {
+        return false;
+    }
+    slot.remaining.store(slot.end - slot.begin, std::memory_order_relaxed);
+    return true;
+}
+
+void NonceScheduler::report(uint32_t worker, uint64_t nonces, double seconds) {
+    if (worker >= MAX_WORKERS || nonces == 0 || seconds <= 0.0) {
+        return;
+    }
+    Slot& slot = m_slots[worker];
+    double sample = static_cast<double>(nonces) / seconds;
+    slot.rate = slot.rate > 0.0 ? 0.75 * slot.rate + 0.25 * sample : sample;
+
+    double target = slot.rate * m_target_seconds.load(std::memory_order_relaxed);
+    uint64_t chunk = static_cast<uint64_t>(std::min(target, static_cast<double>(MAX_CHUNK)));
+    slot.chunk.store(std::max(chunk, MIN_CHUNK), std::memory_order_relaxed);
+}
+
+uint64_t NonceScheduler::chunk_size(uint32_t worker) const {
+    if (worker >= MAX_WORKERS) {
+        return INITIAL_CHUNK;
+    }
+    return m_slots[worker].chunk.load(std::memory_order_relaxed);
+}
+
+}  // namespace bloxminer
@@ -0,0 +1,160 @@
+#include "../include/placement_healer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bloxminer {
+
+PlacementHealer::PlacementHealer(const std::vector<int>& cpus, const Options& options)
+    : m_options(options), m_cpus(cpus) {
+    m_options.confirmations = std::max<uint32_t>(1, m_options.confirmations);
+    m_options.min_threads = std::max<uint32_t>(1, m_options.min_threads);
+}
+
+void PlacementHealer::reset(const std::vector<int>& cpus) {
+    size_t workers = m_assigned.size();
+    m_cpus = cpus;
+    m_excluded.clear();
+    m_assigned.clear();
+    m_workers.clear();
+    resize(static_cast<uint32_t>(workers));
+}
+
+void PlacementHealer::resize(uint32_t workers) {
+    if (m_assigned.size() > workers) {
+        m_assigned.resize(workers);
+    }
+    while (m_assigned.size() < workers) {
+        m_assigned.push_back(spare_cpu());
+    }
+    // Rates so far were measured with a different pool; who was moved stays known
+    m_workers.resize(workers);
+    for (Worker& w : m_workers) {
+        w.strikes = 0;
+        w.reported = false;
+    }
+}
+
+bool PlacementHealer::in_use(int cpu) const {
+    return std::find(m_assigned.begin(), m_assigned.end(), cpu) != m_assigned.end();
+}
+
+bool PlacementHealer::is_excluded(int cpu) const {
+    return std::find(m_excluded.begin(), m_excluded.end(), cpu) != m_excluded.end();
+}
+
+int PlacementHealer::spare_cpu() const {
+    for (int cpu : m_cpus) {
+        if (!is_excluded(cpu) && !in_use(cpu)) {
+            return cpu;
+        }
+    }
+    return -1;
+}
+
+int PlacementHealer::cpu_for(uint32_t thread) const {
+    return thread < m_assigned.size() ? m_assigned[thread] : -1;
+}
+
+std::vector<PlacementHealer::Decision> PlacementHealer::update(const std::vector<double>& hashrates) {
+    const size_t n = m_assigned.size();
+    if (hashrates.size() != n) {
+        return {};
+    }
+
+    // A worker that just moved ran on two CPUs this interval: not counted
+    std::vector<bool> counted(n, false);
+    std::vector<double> measured;
+    for (size_t i = 0; i < n; i++) {
+        Worker& w = m_workers[i];
+        if (w.settle > 0) {
+            w.settle--;
+            w.strikes = 0;
+        } else if (m_assigned[i] >= 0 && std::isfinite(hashrates[i])) {
+            counted[i] = true;
+            measured.push_back(hashrates[i]);
+        }
+    }
+    if (measured.size() < MIN_WORKERS) {
+        return {};
+    }
+    std::sort(measured.begin(), measured.end());
+    const size_t mid = measured.size() / 2;
+    const double median = measured.size() % 2 ? measured[mid] : (measured[mid - 1] + measured[mid]) / 2.0;
+    if (median <= 0.0) {
+        return {};
+    }
+
+    // Count slow intervals; the slowest confirmed outlier is the candidate
+    const double slow = median * (1.0 - m_options.threshold);
+    int worst = -1;
+    for (size_t i = 0; i < n; i++) {
+        if (!counted[i]) {
+            continue;
+        }
+        Worker& w = m_workers[i];
+        if (hashrates[i] < slow) {
+            w.strikes++;
+        } else {
+            w.strikes = 0;
+            w.reported = false;
+        }
+        if (w.strikes >= m_options.confirmations && !w.reported &&
+            (worst < 0 || hashrates[i] < hashrates[worst])) {
+            worst = static_cast<int>(i);
+        }
+    }
+    if (worst < 0) {
+        return {};
+    }
+
+    const uint32_t t = static_cast<uint32_t>(worst);
+    Worker& w = m_workers[t];
+    Decision d{Action::Keep, t, m_assigned[t], -1, hashrates[t], median, w.moved};
+
+    if (!w.moved) {
+        int spare = spare_cpu();
+        if (spare >= 0) {
+            m_excluded.push_back(d.from_cpu);
+            m_assigned[t] = spare;
+            w = Worker();
+            w.moved = true;
+            w.settle = 1;
+            m_moves++;
+            d.action = Action::Move;
+            d.to_cpu = spare;
+            return {d};
+        }
+        if (hashrates[t] < median * m_options.retire_below && n > m_options.min_threads) {
+            // The pool shrinks from the top: this worker takes the top one's CPU
+            m_excluded.push_back(d.from_cpu);
+            const size_t last = n - 1;
+            if (t != last) {
+                m_assigned[t] = m_assigned[last];
+                d.to_cpu = m_assigned[t];
+                w = Worker();
+                w.settle = 1;
+            }
+            m_assigned.pop_back();
+            m_workers.pop_back();
+            m_retired++;
+            d.action = Action::Retire;
+            return {d};
+        }
+    }
+
+    // Slow, but still worth its hashes where it is
+    w.reported = true;
+    return {d};
+}
+
+const char* PlacementHealer::action_name(Action action) {
+    switch (action) {
+        case Action::Move: return "move";
+        case Action::Retire: return "retire";
+        case Action::Keep: return "keep";
+    }
+    return "unknown";
+}
+
+}  // namespace bloxminer
@@ -0,0 +1,90 @@
+#include "../include/pool_ranker.hpp"
+
+#include <algorithm>
+
+namespace bloxminer {
+
+PoolRanker::PoolRanker(size_t num_pools, const Options& options)
+    : m_options(options), m_entries(num_pools) {
+}
+
+void PoolRanker::record_probe(size_t pool, bool ok, double connect_ms, double rtt_ms) {
+    if (pool >= m_entries.size()) return;
+    Entry& e = m_entries[pool];
+
+    if (!ok) {
+        e.failures++;
+        return;
+    }
+    // A pool back from failing starts over rather than averaging with stale samples
+    double a = (e.probes == 0 || e.failures >= m_options.max_failures) ? 1.0 : m_options.alpha;
+    e.connect_ms += a * (connect_ms - e.connect_ms);
+    e.rtt_ms += a * (rtt_ms - e.rtt_ms);
+    e.probes++;
+    e.failures = 0;
+}
+
+void PoolRanker::record_submit(size_t pool, double ms) {
+    if (pool >= m_entries.size()) return;
+    m_entries[pool].submit_ms = ms;
+}
+
+std::vector<size_t> PoolRanker::ranking() const {
+    std::vector<size_t> order(m_entries.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        if (healthy(a) != healthy(b)) return healthy(a);
+        if (!healthy(a)) return false;
+        return m_entries[a].rtt_ms < m_entries[b].rtt_ms;
+    });
+    return order;
+}
+
+bool PoolRanker::healthy(size_t pool) const {
+    // A single failed probe does not demote a pool; max_failures in a row does
+    const Entry& e = m_entries[pool];
+    return e.probes > 0 && e.failures < m_options.max_failures;
+}
+
+bool PoolRanker::beats(size_t candidate, size_t current) const {
+    if (!healthy(candidate)) return false;
+    // The pool in use failed its probes: any healthy pool is better
+    if (!healthy(current)) return true;
+    const Entry& c = m_entries[candidate];
+    const Entry& cur = m_entries[current];
+    double gain = cur.rtt_ms - c.rtt_ms;
+    return gain > m_options.margin_ms && gain > m_options.margin * cur.rtt_ms;
+}
+
+size_t PoolRanker::evaluate(size_t current) {
+    if (current >= m_entries.size()) return current;
+
+    size_t best = ranking().front();
+    if (best == current || !beats(best, current)) {
+        m_challenger = SIZE_MAX;
+        m_challenger_rounds = 0;
+        return current;
+    }
+
+    // Hysteresis: the same pool must win several rounds in a row
+    if (best != m_challenger) {
+        m_challenger = best;
+        m_challenger_rounds = 0;
+    }
+    if (++m_challenger_rounds < std::max<uint32_t>(1, m_options.confirmations)) {
+        return current;
+    }
+    m_challenger = SIZE_MAX;
+    m_challenger_rounds = 0;
+    return best;
+}
+
+size_t PoolRanker::next_after_failure(size_t current) const {
+    for (size_t pool : ranking()) {
+        if (pool != current) return pool;
+    }
+    return current;
+}
+
+}  // namespace bloxminer
@@ -0,0 +1,85 @@
+#include "../include/pressure_controller.hpp"
+
+#include <algorithm>
+
+namespace bloxminer {
+
+PressureController::PressureController(uint32_t max_threads, double high, double low,
+                                       uint32_t recover_ms, uint32_t min_threads)
+    : m_max_threads(std::max<uint32_t>(1, max_threads)),
+      m_min_threads(std::max<uint32_t>(1, std::min(min_threads, m_max_threads))),
+      m_high(high), m_low(std::min(low, high)),
+      m_recover_seconds(recover_ms / 1000.0) {
+    m_stats.allowed = m_max_threads;
+    m_stats.ceiling = m_max_threads;
+}
+
+void PressureController::set_max_threads(uint32_t max_threads) {
+    m_max_threads = std::max<uint32_t>(1, max_threads);
+    m_min_threads = std::min(m_min_threads, m_max_threads);
+    m_stats.allowed = m_max_threads;
+    m_stats.ceiling = m_max_threads;
+    m_calm_seconds = 0.0;
+    m_trigger_pressure = 0.0;
+    m_backoff = 1;
+    m_probing = false;
+}
+
+uint32_t PressureController::update(double pressure, double own_pressure, double dt, double thread_hashrate) {
+    m_stats.pressure = pressure;
+    m_stats.own_pressure = own_pressure;
+
+    if (pressure >= m_high) {
+        // Foreground wants the CPUs: halve now, again on the next reading if needed
+        m_trigger_pressure = std::max(m_trigger_pressure, pressure);
+        if (m_stats.allowed > m_min_threads) {
+            m_stats.allowed = std::max(m_min_threads, m_stats.allowed / 2);
+            m_stats.shed_events++;
+        }
+        m_calm_seconds = 0.0;
+        m_probing = false;
+    } else if (own_pressure > m_low) {
+        // Workers wait for cores: one too many, not a foreground burst
+        if (m_stats.allowed > m_min_threads) {
+            m_stats.allowed--;
+            m_stats.shed_events++;
+        }
+        m_stats.ceiling = m_stats.allowed;
+        if (m_probing) {
+            m_backoff = std::min(m_backoff * 2, MAX_PROBE_BACKOFF);
+            m_probing = false;
+        }
+        m_calm_seconds = 0.0;
+    } else if (pressure <= m_low) {
+        m_calm_seconds += dt;
+        if (m_probing && m_calm_seconds >= m_recover_seconds) {
+            // The probe held
+            m_backoff = 1;
+            m_probing = false;
+        }
+        bool probe = m_stats.allowed >= m_stats.ceiling;
+        double wait = probe ? m_recover_seconds * m_backoff : m_recover_seconds;
+        if (m_calm_seconds >= wait && m_stats.allowed < m_max_threads) {
+            m_stats.allowed++;
+            m_calm_seconds = 0.0;
+            if (probe) {
+                m_stats.ceiling = m_stats.allowed;
+                m_probing = true;
+            }
+        }
+    } else {
+        m_calm_seconds = 0.0;
+    }
+
+    uint32_t shed = m_max_threads - m_stats.allowed;
+    if (shed > 0) {
+        m_stats.worker_seconds_shed += shed * dt;
+        m_stats.hashes_forgone += shed * dt * thread_hashrate;
+        m_stats.stall_avoided += std::max(0.0, (m_trigger_pressure - pressure) / 100.0 * dt);
+    } else {
+        m_trigger_pressure = 0.0;
+    }
+    return m_stats.allowed;
+}
+
+}  // namespace bloxminer
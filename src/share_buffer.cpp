@@ -0,0 +1,38 @@
+#include "../include/share_buffer.hpp"
+
+#include <algorithm>
+
+namespace bloxminer {
+
+ShareBuffer::ShareBuffer(size_t capacity, uint32_t max_age_seconds)
+    : m_capacity(std::max<size_t>(1, capacity)), m_max_age(max_age_seconds) {
+}
+
+void ShareBuffer::push(Pending pending) {
+    if (m_pending.size() >= m_capacity) {
+        m_pending.pop_front();
+        m_stats.dropped_full++;
+    }
+    m_pending.push_back(std::move(pending));
+    m_stats.buffered++;
+}
+
+std::vector<stratum::Share> ShareBuffer::take(const std::string& pool, const std::string& extranonce1,
+                                              const std::string& prev_hash,
+                                              std::chrono::steady_clock::time_point now) {
+    std::vector<stratum::Share> valid;
+    for (auto& p : m_pending) {
+        if (p.pool != pool || p.extranonce1 != extranonce1) {
+            m_stats.dropped_session++;
+        } else if (p.prev_hash != prev_hash || now - p.found > m_max_age) {
+            m_stats.dropped_stale++;
+        } else {
+            valid.push_back(std::move(p.share));
+        }
+    }
+    m_pending.clear();
+    m_stats.replayed += valid.size();
+    return valid;
+}
+
+}  // namespace bloxminer
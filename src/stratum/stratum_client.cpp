@@ -11,11 +11,16 @@
 #include <fcntl.h>
 #include <poll.h>
 
+#include <cerrno>
 #include <cstring>
 #include <sstream>
+#include <iomanip>
 #include <algorithm>
 #include <cmath>
 #include <openssl/sha.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/x509v3.h>
 
 // Simple JSON parsing helpers (avoiding external dependency)
 namespace {
@@ -123,6 +128,242 @@ std::vector<std::string> extract_string_array(const std::string& json, size_t st
     return result;
 }
 
+// Resolved addresses by "host:port". getaddrinfo() does not expose record
+// TTLs, so entries are trusted for DNS_CACHE_TTL; past that they are
+// re-resolved, but still used if the resolver fails (DNS down, pool up).
+constexpr auto DNS_CACHE_TTL = std::chrono::seconds(300);
+
+struct Address {
+    sockaddr_storage addr;
+    socklen_t len;
+};
+
+struct CachedAddresses {
+    std::vector<Address> addrs;
+    std::chrono::steady_clock::time_point resolved;
+};
+
+std::mutex g_dns_mutex;
+std::unordered_map<std::string, CachedAddresses> g_dns_cache;
+
+// All addresses of host, families interleaved IPv6 first (RFC 8305 section 4)
+std::vector<Address> resolve(const std::string& host, uint16_t port, bool& cached) {
+    std::string key = host + ":" + std::to_string(port);
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(g_dns_mutex);
+        auto it = g_dns_cache.find(key);
+        if (it != g_dns_cache.end() && now - it->second.resolved < DNS_CACHE_TTL) {
+            cached = true;
+            return it->second.addrs;
+        }
+    }
+    cached = false;
+
+    struct addrinfo hints{}, *result;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    std::string port_str = std::to_string(port);
+    if (getaddrinfo(host.c_str(), port_str.c_str(), &hints, &result) != 0) {
+        std::lock_guard<std::mutex> lock(g_dns_mutex);
+        auto it = g_dns_cache.find(key);
+        if (it == g_dns_cache.end()) return {};
+        cached = true;
+        return it->second.addrs;
+    }
+
+    std::vector<Address> v6, v4;
+    for (struct addrinfo* ai = result; ai; ai = ai->ai_next) {
+        if (ai->ai_addrlen > sizeof(sockaddr_storage)) continue;
+        Address a{};
+        memcpy(&a.addr, ai->ai_addr, ai->ai_addrlen);
+        a.len = ai->ai_addrlen;
+        if (ai->ai_family == AF_INET6) v6.push_back(a);
+        else if (ai->ai_family == AF_INET) v4.push_back(a);
+    }
+    freeaddrinfo(result);
+
+    std::vector<Address> addrs;
+    for (size_t i = 0; i < std::max(v6.size(), v4.size()); i++) {
+        if (i < v6.size()) addrs.push_back(v6[i]);
+        if (i < v4.size()) addrs.push_back(v4[i]);
+    }
+
+    std::lock_guard<std::mutex> lock(g_dns_mutex);
+    g_dns_cache[key] = {addrs, now};
+    return addrs;
+}
+
+// Drop a cached entry whose addresses all failed, so the next attempt re-resolves
+void forget(const std::string& host, uint16_t port) {
+    std::lock_guard<std::mutex> lock(g_dns_mutex);
+    g_dns_cache.erase(host + ":" + std::to_string(port));
+}
+
+// Happy eyeballs (RFC 8305): start a non-blocking connect to each address in
+// turn, the next one after ATTEMPT_DELAY_MS or as soon as one fails, and keep
+// the first that completes. Returns a non-blocking socket, or -1.
+int connect_first(const std::vector<Address>& addrs, uint32_t timeout_ms) {
+    using clock = std::chrono::steady_clock;
+    constexpr auto ATTEMPT_DELAY = std::chrono::milliseconds(250);
+
+    const auto deadline = clock::now() + std::chrono::milliseconds(timeout_ms);
+    auto next_attempt = clock::now();
+    std::vector<struct pollfd> pending;
+    size_t next = 0;
+    int winner = -1;
+
+    while (winner < 0 && clock::now() < deadline) {
+        if (next < addrs.size() && (clock::now() >= next_attempt || pending.empty())) {
+            const Address& a = addrs[next++];
+            next_attempt = clock::now() + ATTEMPT_DELAY;
+            int fd = socket(a.addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0) continue;
+            if (::connect(fd, reinterpret_cast<const sockaddr*>(&a.addr), a.len) == 0) {
+                winner = fd;
+            } else if (errno == EINPROGRESS) {
+                pending.push_back({fd, POLLOUT, 0});
+            } else {
+                close(fd);
+                next_attempt = clock::now();
+            }
+            continue;
+        }
+        if (pending.empty()) break;  // Every address refused
+
+        auto wait_until = next < addrs.size() ? std::min(deadline, next_attempt) : deadline;
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(wait_until - clock::now());
+        if (poll(pending.data(), pending.size(), static_cast<int>(std::max<int64_t>(0, wait.count()))) < 0 &&
+            errno != EINTR) {
+            break;
+        }
+        for (size_t i = 0; i < pending.size();) {
+            if (pending[i].revents == 0) {
+                i++;
+                continue;
+            }
+            int err = 0;
+            socklen_t len = sizeof(err);
+            getsockopt(pending[i].fd, SOL_SOCKET, SO_ERROR, &err, &len);
+            if (err == 0 && winner < 0) {
+                winner = pending[i].fd;
+            } else {
+                close(pending[i].fd);
+                next_attempt = clock::now();
+            }
+            pending.erase(pending.begin() + i);
+        }
+    }
+
+    for (const auto& p : pending) {
+        close(p.fd);
+    }
+    if (winner >= 0) {
+        int flag = 1;
+        setsockopt(winner, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+    }
+    return winner;
+}
+
+void set_blocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) & ~O_NONBLOCK);
+}
+
+// Wait until fd is ready for what the last SSL call asked for; false on timeout or error
+bool wait_for_ssl(SSL* ssl, int rc, int fd, std::chrono::steady_clock::time_point deadline) {
+    int err = SSL_get_error(ssl, rc);
+    short events;
+    if (err == SSL_ERROR_WANT_READ) {
+        events = POLLIN;
+    } else if (err == SSL_ERROR_WANT_WRITE) {
+        events = POLLOUT;
+    } else {
+        return false;
+    }
+    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now()).count();
+    struct pollfd pfd = {fd, events, 0};
+    return wait > 0 && poll(&pfd, 1, static_cast<int>(wait)) == 1;
+}
+
+// TLS session tickets by "host:port", kept across reconnects and failover.
+// Only the miner's own connections store tickets (via SSL app data); probes
+// always do a full handshake.
+std::mutex g_tls_mutex;
+std::unordered_map<std::string, SSL_SESSION*> g_tls_sessions;
+
+int on_new_session(SSL* ssl, SSL_SESSION* session) {
+    auto* key = static_cast<const std::string*>(SSL_get_app_data(ssl));
+    if (key == nullptr) return 0;
+    std::lock_guard<std::mutex> lock(g_tls_mutex);
+    SSL_SESSION*& slot = g_tls_sessions[*key];
+    if (slot != nullptr) SSL_SESSION_free(slot);
+    slot = session;
+    return 1;  // We keep the reference
+}
+
+SSL_CTX* client_ctx() {
+    static SSL_CTX* ctx = [] {
+        SSL_CTX* c = SSL_CTX_new(TLS_client_method());
+        SSL_CTX_set_min_proto_version(c, TLS1_2_VERSION);
+        SSL_CTX_set_default_verify_paths(c);
+        // Tickets go to on_new_session only; OpenSSL's own cache is server-keyed
+        SSL_CTX_set_session_cache_mode(c, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(c, on_new_session);
+        return c;
+    }();
+    return ctx;
+}
+
+// New client SSL on a connected non-blocking socket, handshake done; null on failure
+SSL* tls_connect(int fd, const std::string& host, bool verify, SSL_SESSION* resume,
+                 const std::string* ticket_key, std::chrono::steady_clock::time_point deadline) {
+    SSL* ssl = SSL_new(client_ctx());
+    if (ssl == nullptr) return nullptr;
+    SSL_set_fd(ssl, fd);
+    SSL_set_app_data(ssl, const_cast<std::string*>(ticket_key));
+
+    // SNI only for names: RFC 6066 does not allow IP literals
+    struct in6_addr ip;
+    bool is_ip = inet_pton(AF_INET, host.c_str(), &ip) == 1 || inet_pton(AF_INET6, host.c_str(), &ip) == 1;
+    if (!is_ip) {
+        SSL_set_tlsext_host_name(ssl, host.c_str());
+    }
+    if (verify) {
+        SSL_set_verify(ssl, SSL_VERIFY_PEER, nullptr);
+        if (is_ip) {
+            X509_VERIFY_PARAM_set1_ip_asc(SSL_get0_param(ssl), host.c_str());
+        } else {
+            SSL_set1_host(ssl, host.c_str());
+        }
+    } else {
+        SSL_set_verify(ssl, SSL_VERIFY_NONE, nullptr);
+    }
+    if (resume != nullptr) {
+        SSL_set_session(ssl, resume);
+    }
+
+    int rc;
+    while ((rc = SSL_connect(ssl)) != 1) {
+        if (!wait_for_ssl(ssl, rc, fd, deadline)) {
+            long result = SSL_get_verify_result(ssl);
+            if (result != X509_V_OK) {
+                LOG_ERROR("TLS certificate check failed for %s: %s", host.c_str(),
+                          X509_verify_cert_error_string(result));
+            } else if (ticket_key != nullptr) {
+                char buf[256];
+                ERR_error_string_n(ERR_peek_last_error(), buf, sizeof(buf));
+                LOG_ERROR("TLS handshake with %s failed: %s", host.c_str(), buf);
+            }
+            ERR_clear_error();
+            SSL_free(ssl);
+            return nullptr;
+        }
+    }
+    return ssl;
+}
+
 }  // namespace
 
 namespace bloxminer {
@@ -137,6 +378,7 @@ StratumClient::StratumClient()
     , m_difficulty(1.0)
     , m_message_id(1)
     , m_has_pool_target(false)
+    , m_submit_rtt_ms(0.0)
 {
     memset(m_pool_target, 0, 32);
 }
@@ -145,54 +387,55 @@ StratumClient::~StratumClient() {
     disconnect();
 }
 
-bool StratumClient::connect(const std::string& host, uint16_t port) {
+bool StratumClient::connect(const std::string& host, uint16_t port, bool tls, bool tls_verify) {
+    constexpr uint32_t CONNECT_TIMEOUT_MS = 10000;
+    using clock = std::chrono::steady_clock;
+
     // Safety: ensure any existing socket is closed before creating new one
-    if (m_socket >= 0) {
-        shutdown(m_socket, SHUT_RDWR);
-        close(m_socket);
-        m_socket = -1;
-    }
-    m_connected = false;
+    disconnect();
 
-    m_recv_buffer.clear();
     m_host = host;
     m_port = port;
+    m_submit_rtt_ms = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(m_pending_mutex);
+        m_pending_submits.clear();
+    }
+    m_timing = ConnectTiming();
 
-    // Resolve hostname
-    struct addrinfo hints{}, *result;
-    hints.ai_family = AF_INET;
-    hints.ai_socktype = SOCK_STREAM;
-    
-    std::string port_str = std::to_string(port);
-    if (getaddrinfo(host.c_str(), port_str.c_str(), &hints, &result) != 0) {
+    // Resolve hostname (cached)
+    auto start = clock::now();
+    std::vector<Address> addrs = resolve(host, port, m_timing.dns_cached);
+    if (addrs.empty()) {
         LOG_ERROR("Failed to resolve hostname: %s", host.c_str());
         return false;
     }
-    
-    // Create socket
-    m_socket = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    auto resolved = clock::now();
+
+    // Connect: every address, first to answer wins
+    m_socket = connect_first(addrs, CONNECT_TIMEOUT_MS);
     if (m_socket < 0) {
-        LOG_ERROR("Failed to create socket");
-        freeaddrinfo(result);
-        return false;
-    }
-    
-    // Set TCP_NODELAY for lower latency
-    int flag = 1;
-    setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
-    
-    // Connect
-    if (::connect(m_socket, result->ai_addr, result->ai_addrlen) < 0) {
         LOG_ERROR("Failed to connect to %s:%d", host.c_str(), port);
-        close(m_socket);
-        m_socket = -1;
-        freeaddrinfo(result);
+        forget(host, port);
         return false;
     }
-    
-    freeaddrinfo(result);
+
+    auto connected = clock::now();
+    m_timing.dns_ms = std::chrono::duration<double, std::milli>(resolved - start).count();
+    m_timing.connect_ms = std::chrono::duration<double, std::milli>(connected - resolved).count();
+
+    if (tls) {
+        if (!start_tls(host, tls_verify)) {
+            close(m_socket);
+            m_socket = -1;
+            return false;
+        }
+        m_timing.tls_ms = std::chrono::duration<double, std::milli>(clock::now() - connected).count();
+    } else {
+        set_blocking(m_socket);
+    }
     m_connected = true;
-    
+
     utils::Logger::instance().connected(host, port);
     return true;
 }
@@ -202,6 +445,19 @@ void StratumClient::disconnect() {
     m_connected = false;
     m_recv_buffer.clear();
 
+    {
+        std::lock_guard<std::mutex> lock(m_ssl_mutex);
+        if (m_ssl != nullptr) {
+            // Best-effort close_notify; marking the shutdown done either way keeps
+            // the session resumable after a dropped connection
+            SSL_shutdown(m_ssl);
+            SSL_set_shutdown(m_ssl, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+            SSL_free(m_ssl);
+            m_ssl = nullptr;
+            ERR_clear_error();
+        }
+    }
+
     if (m_socket >= 0) {
         shutdown(m_socket, SHUT_RDWR);
         close(m_socket);
@@ -209,22 +465,218 @@ void StratumClient::disconnect() {
     }
 }
 
-bool StratumClient::subscribe() {
+bool StratumClient::start_tls(const std::string& host, bool verify) {
+    constexpr auto TLS_TIMEOUT = std::chrono::seconds(10);
+    
+    // Unverified sessions are kept apart so they never satisfy a verifying connect
+    m_tls_key = host + ":" + std::to_string(m_port) + (verify ? "" : " noverify");
+    SSL_SESSION* resume = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(g_tls_mutex);
+        auto it = g_tls_sessions.find(m_tls_key);
+        if (it != g_tls_sessions.end() && SSL_SESSION_is_resumable(it->second)) {
+            resume = it->second;
+            SSL_SESSION_up_ref(resume);
+        }
+    }
+    
+    SSL* ssl = tls_connect(m_socket, host, verify, resume, &m_tls_key,
+                           std::chrono::steady_clock::now() + TLS_TIMEOUT);
+    if (resume != nullptr) {
+        SSL_SESSION_free(resume);
+    }
+    if (ssl == nullptr) {
+        return false;
+    }
+    
+    m_timing.tls = true;
+    m_timing.tls_resumed = SSL_session_reused(ssl) == 1;
+    m_tls_handshakes++;
+    if (m_timing.tls_resumed) {
+        m_tls_resumptions++;
+    }
+    std::lock_guard<std::mutex> lock(m_ssl_mutex);
+    m_ssl = ssl;
+    return true;
+}
+
+void StratumClient::interrupt() {
+    // run() sees the connection already marked down and returns quietly
+    m_running = false;
+    m_connected = false;
+    if (m_socket >= 0) {
+        shutdown(m_socket, SHUT_RDWR);
+    }
+}
+
+bool StratumClient::probe(const std::string& host, uint16_t port, uint32_t timeout_ms,
+                          double& connect_ms, double& rtt_ms, bool tls, bool tls_verify) {
+    using clock = std::chrono::steady_clock;
+    
+    bool cached = false;
+    std::vector<Address> addrs = resolve(host, port, cached);
+    if (addrs.empty()) {
+        return false;
+    }
+    
+    auto start = clock::now();
+    int fd = connect_first(addrs, timeout_ms);
+    if (fd < 0) {
+        return false;
+    }
+    connect_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    
+    SSL* ssl = nullptr;
+    if (tls) {
+        ssl = tls_connect(fd, host, tls_verify, nullptr, nullptr,
+                          clock::now() + std::chrono::milliseconds(timeout_ms));
+        if (ssl == nullptr) {
+            close(fd);
+            return false;
+        }
+    }
+    auto connected = clock::now();
+    
+    // Stratum round trip: the pool has to parse a request and answer it
+    const std::string request =
+        "{\"id\":1,\"method\":\"mining.subscribe\",\"params\":[\"BloxMiner/1.0.0\"]}\n";
+    const auto deadline = connected + std::chrono::milliseconds(timeout_ms);
+    auto finish = [&](bool ok) {
+        if (ssl != nullptr) {
+            SSL_free(ssl);
+            ERR_clear_error();
+        }
+        close(fd);
+        return ok;
+    };
+    
+    if (ssl != nullptr) {
+        int rc;
+        while ((rc = SSL_write(ssl, request.c_str(), static_cast<int>(request.length()))) <= 0) {
+            if (!wait_for_ssl(ssl, rc, fd, deadline)) return finish(false);
+        }
+    } else if (send(fd, request.c_str(), request.length(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.length())) {
+        return finish(false);
+    }
+    
+    bool answered = false;
+    char buf[1024];
+    while (!answered) {
+        ssize_t n;
+        if (ssl != nullptr) {
+            int rc = SSL_read(ssl, buf, sizeof(buf));
+            if (rc <= 0) {
+                if (!wait_for_ssl(ssl, rc, fd, deadline)) break;
+                continue;
+            }
+            n = rc;
+        } else {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock::now()).count();
+            struct pollfd pfd = {fd, POLLIN, 0};
+            if (wait <= 0 || poll(&pfd, 1, static_cast<int>(wait)) != 1) break;
+            n = recv(fd, buf, sizeof(buf), 0);
+        }
+        if (n <= 0) break;
+        answered = memchr(buf, '\n', static_cast<size_t>(n)) != nullptr;
+    }
+    rtt_ms = std::chrono::duration<double, std::milli>(clock::now() - connected).count();
+    
+    return finish(answered);
+}
+
+std::string StratumClient::suggest_message(double difficulty) {
+    if (difficulty <= 0.0) {
+        return "";
+    }
+    uint64_t id = m_message_id++;
+    m_suggest_id = id;
     std::stringstream ss;
-    ss << "{\"id\":" << m_message_id++ 
+    ss << "{\"id\":" << id
+       << ",\"method\":\"mining.suggest_difficulty\""
+       << ",\"params\":[" << std::setprecision(6) << difficulty << "]}\n";
+    return ss.str();
+}
+
+bool StratumClient::suggest_difficulty(double difficulty) {
+    std::string msg = suggest_message(difficulty);
+    if (msg.empty()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_send_mutex);
+    return send_message(msg);
+}
+
+bool StratumClient::handshake(const std::string& username, const std::string& password, double suggest) {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    
+    // All requests in one write: one round trip instead of two
+    uint64_t subscribe_id = m_message_id++;
+    std::string suggestion = suggest_message(suggest);
+    uint64_t auth_id = m_message_id++;
+    
+    // Back on the same pool, ask to resume the previous session: pools that
+    // support it hand out the same extranonce1, so buffered shares stay valid
+    std::string pool = m_host + ":" + std::to_string(m_port);
+    std::string resume;
+    if (!m_session_id.empty() && m_session_pool == pool) {
+        resume = ",\"" + json_escape(m_session_id) + "\"";
+    }
+    
+    std::stringstream ss;
+    ss << "{\"id\":" << subscribe_id
        << ",\"method\":\"mining.subscribe\""
-       << ",\"params\":[\"BloxMiner/1.0.0\"]}\n";
+       << ",\"params\":[\"BloxMiner/1.0.0\"" << resume << "]}\n"
+       << suggestion
+       << "{\"id\":" << auth_id
+       << ",\"method\":\"mining.authorize\""
+       << ",\"params\":[\"" << json_escape(username) << "\",\"" << json_escape(password) << "\"]}\n";
     
     if (!send_message(ss.str())) {
         return false;
     }
     
-    // Wait for response
-    std::string response = receive_line();
-    if (response.empty()) {
-        LOG_ERROR("No response to subscribe");
+    // Replies are matched by id; difficulty and the first job may arrive in between
+    bool subscribed = false;
+    bool authorized = false;
+    for (int attempts = 0; attempts < 16 && !(subscribed && authorized); attempts++) {
+        std::string response = receive_line();
+        if (response.empty()) {
+            LOG_ERROR("No response to %s", subscribed ? "authorize" : "subscribe");
+            return false;
+        }
+        
+        // Check if this is a notification (has "method" field)
+        if (response.find("\"method\"") != std::string::npos) {
+            process_message(response);
+            continue;
+        }
+        
+        int64_t id = extract_int(response, "id");
+        if (id == static_cast<int64_t>(subscribe_id)) {
+            parse_subscribe_result(response);
+            subscribed = true;
+        } else if (id == static_cast<int64_t>(auth_id)) {
+            if (!authorize_succeeded(response)) {
+                LOG_ERROR("Authorization failed: %s", response.c_str());
+                return false;
+            }
+            m_username = username;  // Stored for share submission
+            LOG_INFO("Authorized as %s", username.c_str());
+            authorized = true;
+        }
+    }
+    
+    if (!(subscribed && authorized)) {
+        LOG_ERROR("Subscribe/authorize timed out");
         return false;
     }
+    m_timing.handshake_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    return true;
+}
+
+void StratumClient::parse_subscribe_result(const std::string& response) {
+    m_extranonce1.clear();  // Not carried over from a previous pool
     
     // Parse subscription response
     // Format: {"id":1,"result":[[["mining.set_difficulty","..."],["mining.notify","..."]],"extranonce1","extranonce2_size"],"error":null}
@@ -266,69 +718,33 @@ bool StratumClient::subscribe() {
         }
     }
     
+    // Subscription id: the string after "mining.notify" in the result
+    m_session_id.clear();
+    m_session_pool = m_host + ":" + std::to_string(m_port);
+    size_t notify = response.find("\"mining.notify\"");
+    if (notify != std::string::npos) {
+        size_t open = response.find('"', notify + 15);
+        size_t close = open == std::string::npos ? open : response.find('"', open + 1);
+        if (close != std::string::npos && response.find(']', notify) > open) {
+            m_session_id = response.substr(open + 1, close - open - 1);
+        }
+    }
+    
     LOG_INFO("Subscribed - extranonce1: %s, extranonce2_size: %d", 
              m_extranonce1.c_str(), (int)m_extranonce2_size);
-    
-    return true;
 }
 
-bool StratumClient::authorize(const std::string& username, const std::string& password) {
-    uint64_t auth_id = m_message_id++;
-    
-    std::stringstream ss;
-    ss << "{\"id\":" << auth_id
-       << ",\"method\":\"mining.authorize\""
-       << ",\"params\":[\"" << json_escape(username) << "\",\"" << json_escape(password) << "\"]}\n";
-    
-    if (!send_message(ss.str())) {
-        return false;
+bool StratumClient::authorize_succeeded(const std::string& response) {
+    // Success: result true, or no error (result could be various formats)
+    if (response.find("\"result\":true") != std::string::npos ||
+        response.find("\"result\": true") != std::string::npos) {
+        return true;
     }
-    
-    // Wait for response - may receive notifications before auth response
-    for (int attempts = 0; attempts < 10; attempts++) {
-        std::string response = receive_line();
-        if (response.empty()) {
-            LOG_ERROR("No response to authorize");
-            return false;
-        }
-        
-        // Check if this is a notification (has "method" field)
-        if (response.find("\"method\"") != std::string::npos) {
-            // It's a notification - process it and continue waiting
-            process_message(response);
-            continue;
-        }
-        
-        // Check for auth success
-        if (response.find("\"result\":true") != std::string::npos ||
-            response.find("\"result\": true") != std::string::npos) {
-            m_username = username;  // Store for share submission
-            LOG_INFO("Authorized as %s", username.c_str());
-            return true;
-        }
-        
-        // Check if this response has an error
-        if (response.find("\"error\":null") != std::string::npos ||
-            response.find("\"error\": null") != std::string::npos) {
-            // No error means success (result could be various formats)
-            m_username = username;  // Store for share submission
-            LOG_INFO("Authorized as %s", username.c_str());
-            return true;
-        }
-        
-        // Check for explicit error
-        if (response.find("\"error\":[") != std::string::npos ||
-            response.find("\"error\": [") != std::string::npos) {
-            LOG_ERROR("Authorization failed: %s", response.c_str());
-            return false;
-        }
-    }
-    
-    LOG_ERROR("Authorization timed out");
-    return false;
+    return response.find("\"error\":null") != std::string::npos ||
+           response.find("\"error\": null") != std::string::npos;
 }
 
-void StratumClient::submit_share(const Share& share) {
+bool StratumClient::submit_share(const Share& share) {
     // Verus stratum submit format (from ccminer-verus):
     // ["user", "jobid", "timehex", "noncestr", "solhex"]
     //
@@ -355,7 +771,7 @@ void StratumClient::submit_share(const Share& share) {
     // BUG-001: validate extranonce1 before computing sizes to prevent stack overflow
     if (m_extranonce1.length() % 2 != 0 || m_extranonce1.length() > 16) {
         LOG_WARN("Invalid extranonce1 length (%zu), skipping share", m_extranonce1.length());
-        return;
+        return true;  // Not worth retrying
     }
     size_t xnonce1_bytes = m_extranonce1.length() / 2;
 
@@ -477,17 +893,73 @@ void StratumClient::submit_share(const Share& share) {
     
     std::string msg = ss.str();
     
+    {
+        std::lock_guard<std::mutex> lock(m_pending_mutex);
+        m_pending_submits[submit_id] = {std::chrono::steady_clock::now(), share.difficulty};
+    }
     std::lock_guard<std::mutex> lock(m_send_mutex);
-    send_message(msg);
+    if (!send_message(msg)) {
+        std::lock_guard<std::mutex> pending_lock(m_pending_mutex);
+        m_pending_submits.erase(submit_id);
+        return false;
+    }
+    return true;
 }
 
 bool StratumClient::send_message(const std::string& message) {
     if (!m_connected || m_socket < 0) return false;
     
+    std::unique_lock<std::mutex> lock(m_ssl_mutex);
+    if (m_ssl != nullptr) {
+        // Non-blocking socket: wait out a full send buffer, holding the lock so
+        // SSL_write is retried with the same arguments as OpenSSL requires
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        int rc;
+        while ((rc = SSL_write(m_ssl, message.c_str(), static_cast<int>(message.length()))) <= 0) {
+            if (!wait_for_ssl(m_ssl, rc, m_socket, deadline)) {
+                ERR_clear_error();
+                return false;
+            }
+        }
+        return true;
+    }
+    lock.unlock();
+    
     ssize_t sent = send(m_socket, message.c_str(), message.length(), 0);
     return sent == static_cast<ssize_t>(message.length());
 }
 
+ssize_t StratumClient::read_some(char* buf, size_t len) {
+    bool tls;
+    {
+        std::lock_guard<std::mutex> lock(m_ssl_mutex);
+        tls = m_ssl != nullptr;
+    }
+    if (!tls) {
+        return recv(m_socket, buf, len, 0);
+    }
+    
+    // TLS: wait for data without the lock, so submits can write meanwhile
+    while (m_connected) {
+        int fd;
+        {
+            std::lock_guard<std::mutex> lock(m_ssl_mutex);
+            if (m_ssl == nullptr) return -1;  // Disconnected from another thread
+            int n = SSL_read(m_ssl, buf, static_cast<int>(len));
+            if (n > 0) return n;
+            int err = SSL_get_error(m_ssl, n);
+            if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) {
+                ERR_clear_error();
+                return -1;
+            }
+            fd = m_socket;
+        }
+        struct pollfd pfd = {fd, POLLIN, 0};
+        poll(&pfd, 1, 1000);
+    }
+    return -1;
+}
+
 std::string StratumClient::receive_line() {
     const size_t MAX_LINE_LENGTH = 65536;  // 64KB limit to prevent memory exhaustion
     char tmp[4096];
@@ -509,7 +981,7 @@ std::string StratumClient::receive_line() {
             return "";
         }
 
-        ssize_t n = recv(m_socket, tmp, sizeof(tmp), 0);
+        ssize_t n = read_some(tmp, sizeof(tmp));
         if (n <= 0) {
             m_connected = false;
             return "";
@@ -666,9 +1138,35 @@ void StratumClient::handle_notification(const std::string& method, const std::st
 void StratumClient::handle_response(uint64_t id, bool success, const std::string& result, const std::string& error) {
     (void)result;  // Unused for now
     
+    // Share round trip: EWMA over submits answered on this connection
+    double rtt_ms = 0.0;
+    double difficulty = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(m_pending_mutex);
+        auto it = m_pending_submits.find(id);
+        if (it != m_pending_submits.end()) {
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - it->second.sent).count();
+            double prev = m_submit_rtt_ms;
+            m_submit_rtt_ms = prev == 0.0 ? ms : prev + 0.3 * (ms - prev);
+            m_submit_rtt_hist.observe(ms / 1000.0);
+            rtt_ms = ms;
+            difficulty = it->second.difficulty;
+            m_pending_submits.erase(it);
+        }
+    }
+    
+    // Pools that do not know mining.suggest_difficulty answer with an error
+    if (id == m_suggest_id) {
+        if (!success) {
+            LOG_DEBUG("Pool declined suggested difficulty: %s", error.c_str());
+        }
+        return;
+    }
+    
     // This is likely a share response
     if (m_share_callback) {
-        m_share_callback(success, error);
+        m_share_callback(success, error, rtt_ms, difficulty);
     }
     
     if (!success && !error.empty()) {
@@ -825,6 +1323,7 @@ void StratumClient::construct_header(Job& job) {
     // The next 4 bytes will be our mining nonce
     // Rest is padding (zeros)
     utils::hex_to_bytes(m_extranonce1, job.header + 108, m_extranonce1.length() / 2);
+    job.extranonce1 = m_extranonce1;
     // extranonce2 and padding are already zero from memset
     
     job.header_len = 140;  // Full Verus header
@@ -0,0 +1,80 @@
+/*
+ * bloxminer-stat: print the running miner's stats as HiveOS agent JSON
+ *
+ * Reads the shared-memory segment the miner updates every stats interval,
+ * so an agent poll is one short-lived process and no log parsing.
+ *
+ *   bloxminer-stat [--max-age SEC] [PATH]
+ *
+ * PATH defaults to /tmp/bloxminer-<uid>/stats.shm. Exits 1 (and prints
+ * zeroed stats) if the segment is missing, from another layout version,
+ * or older than --max-age seconds (default 60), i.e. the miner is not
+ * running.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "../../include/utils/shared_stats.hpp"
+
+using bloxminer::utils::SharedStats;
+
+static void print_idle() {
+    printf("{\"hs\":[],\"hs_units\":\"khs\",\"temp\":[],\"fan\":[],\"khs\":0,\"ac\":0,\"rj\":0,"
+           "\"algo\":\"verushash\"}\n");
+}
+
+int main(int argc, char** argv) {
+    std::string path = bloxminer::utils::shared_stats_path();
+    double max_age = 60.0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--max-age") == 0 && i + 1 < argc) {
+            max_age = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printf("Usage: %s [--max-age SEC] [PATH]\n", argv[0]);
+            return 0;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    SharedStats stats;
+    std::string error;
+    if (!bloxminer::utils::read_shared_stats(path, stats, error)) {
+        fprintf(stderr, "bloxminer-stat: %s\n", error.c_str());
+        print_idle();
+        return 1;
+    }
+
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    double age = (now_ms - stats.updated_ms) / 1000.0;
+    if (age > max_age) {
+        fprintf(stderr, "bloxminer-stat: stats are %.0f s old, miner not running\n", age);
+        print_idle();
+        return 1;
+    }
+
+    // One temperature per thread: HiveOS pairs hs[] and temp[] by index
+    uint32_t threads = stats.num_threads < SharedStats::MAX_THREADS ? stats.num_threads
+                                                                     : static_cast<uint32_t>(SharedStats::MAX_THREADS);
+    stats.version[sizeof(stats.version) - 1] = '\0';
+    stats.algo[sizeof(stats.algo) - 1] = '\0';
+
+    printf("{\"hs\":[");
+    for (uint32_t i = 0; i < threads; i++) {
+        printf("%s%.3f", i ? "," : "", stats.thread_hashrate[i] / 1000.0);
+    }
+    printf("],\"hs_units\":\"khs\",\"temp\":[");
+    for (uint32_t i = 0; i < threads; i++) {
+        printf("%s%.0f", i ? "," : "", stats.cpu_temp);
+    }
+    printf("],\"fan\":[],\"uptime\":%.0f,\"khs\":%.3f,\"ac\":%llu,\"rj\":%llu,\"ver\":\"%s\",\"algo\":\"%s\"}\n",
+           stats.uptime, stats.hashrate / 1000.0,
+           static_cast<unsigned long long>(stats.accepted), static_cast<unsigned long long>(stats.rejected),
+           stats.version, stats.algo);
+    return 0;
+}
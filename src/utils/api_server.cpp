@@ -0,0 +1,637 @@
+#include "../../include/utils/api_server.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+namespace bloxminer {
+namespace utils {
+
+void ApiServer::publish(std::string stats_json) {
+    std::atomic_store(&m_snapshot, std::make_shared<const std::string>(std::move(stats_json)));
+}
+
+bool ApiServer::start(uint16_t port, StatsCallback stats_callback, const std::string& bind_address) {
+    if (m_running) return true;
+
+    m_port = port;
+    m_stats_callback = stats_callback;
+    m_bind_address = bind_address;
+
+    // Create socket
+    m_socket = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_socket < 0) {
+        return false;
+    }
+
+    // Allow address reuse
+    int opt = 1;
+    setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    // Bind to specified address (default localhost for security)
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) <= 0) {
+        // Fallback to localhost if parse fails
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    }
+    addr.sin_port = htons(port);
+
+    socklen_t addr_len = sizeof(addr);
+    if (bind(m_socket, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        listen(m_socket, static_cast<int>(MAX_CONNECTIONS)) < 0 ||
+        getsockname(m_socket, (struct sockaddr*)&addr, &addr_len) < 0) {
+        close(m_socket);
+        m_socket = -1;
+        return false;
+    }
+    m_port = ntohs(addr.sin_port);
+
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    m_wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    bool ok = m_epoll >= 0 && m_wake >= 0;
+    if (ok) {
+        ev.data.fd = m_socket;
+        ok = epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_socket, &ev) == 0;
+    }
+    if (ok) {
+        ev.data.fd = m_wake;
+        ok = epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &ev) == 0;
+    }
+    if (ok && m_event_bus) {
+        ev.data.fd = m_event_bus->notify_fd();
+        ok = epoll_ctl(m_epoll, EPOLL_CTL_ADD, ev.data.fd, &ev) == 0;
+    }
+    if (ok && m_control_callback) {
+        m_control_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        ev.data.fd = m_control_fd;
+        ok = m_control_fd >= 0 && epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_control_fd, &ev) == 0;
+    }
+    if (!ok) {
+        if (m_epoll >= 0) close(m_epoll);
+        if (m_wake >= 0) close(m_wake);
+        if (m_control_fd >= 0) close(m_control_fd);
+        close(m_socket);
+        m_epoll = m_wake = m_control_fd = m_socket = -1;
+        return false;
+    }
+
+    std::string endpoints = R"("/api/stats")";
+    if (m_metrics_callback) endpoints += R"(,"/metrics")";
+    if (m_event_bus) endpoints += R"(,"/events")";
+    m_not_found = std::make_shared<const std::string>(
+        R"({"error":"not found","endpoints":[)" + endpoints + R"(,"/health"]})");
+
+    m_running = true;
+    m_thread = std::thread(&ApiServer::server_thread, this);
+    if (m_control_callback) {
+        m_control_thread = std::thread(&ApiServer::control_thread, this);
+    }
+
+    return true;
+}
+
+void ApiServer::stop() {
+    if (!m_running) return;
+
+    m_running = false;
+
+    // Wake epoll_wait
+    uint64_t one = 1;
+    ssize_t ignored = write(m_wake, &one, sizeof(one));
+    (void)ignored;
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    // An action already running finishes; queued ones are dropped
+    {
+        std::lock_guard<std::mutex> lock(m_control_mutex);
+        m_control_queue.clear();
+    }
+    m_control_cv.notify_all();
+    if (m_control_thread.joinable()) {
+        m_control_thread.join();
+    }
+    m_control_done.clear();
+
+    while (!m_connections.empty()) {
+        close_connection(m_connections.begin()->first);
+    }
+    close(m_epoll);
+    close(m_wake);
+    if (m_control_fd >= 0) close(m_control_fd);
+    close(m_socket);
+    m_epoll = m_wake = m_control_fd = m_socket = -1;
+}
+
+void ApiServer::server_thread() {
+    struct epoll_event events[64];
+
+    while (m_running) {
+        // Wakes at least every 250 ms to enforce connection deadlines
+        int n = epoll_wait(m_epoll, events, 64, 250);
+        if (n < 0 && errno != EINTR) break;
+
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == m_wake) continue;  // stop(): loop condition ends the thread
+            if (fd == m_socket) {
+                accept_clients();
+                continue;
+            }
+            if (m_event_bus && fd == m_event_bus->notify_fd()) {
+                on_events();
+                continue;
+            }
+            if (fd == m_control_fd) {
+                on_control_done();
+                continue;
+            }
+
+            auto it = m_connections.find(fd);
+            if (it == m_connections.end()) continue;
+            Connection& conn = it->second;
+
+            bool open = true;
+            if (events[i].events & EPOLLIN) {
+                open = on_readable(conn, fd);
+            }
+            if (open && (events[i].events & EPOLLOUT)) {
+                open = serve(conn, fd);
+            }
+            if (open && (events[i].events & (EPOLLERR | EPOLLHUP))) {
+                open = false;
+            }
+            if (!open) {
+                close_connection(fd);
+            }
+        }
+
+        // Idle keep-alives, slow senders and clients not reading their response;
+        // a quiet stream gets a heartbeat comment instead
+        auto now = Clock::now();
+        std::vector<int> expired;
+        for (auto& entry : m_connections) {
+            Connection& conn = entry.second;
+            if (conn.deadline > now) continue;
+            if (conn.stream && !conn.writing) {
+                queue_chunk(conn, ":\n\n");
+                if (serve(conn, entry.first)) continue;
+            }
+            expired.push_back(entry.first);
+        }
+        for (int fd : expired) {
+            close_connection(fd);
+        }
+    }
+}
+
+void ApiServer::accept_clients() {
+    while (true) {
+        int client = accept4(m_socket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            return;  // EAGAIN: backlog drained; anything else: retry on the next event
+        }
+        if (m_connections.size() >= MAX_CONNECTIONS) {
+            close(client);
+            continue;
+        }
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = client;
+        if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, client, &ev) < 0) {
+            close(client);
+            continue;
+        }
+        Connection& conn = m_connections[client];
+        conn.serial = ++m_next_serial;
+        conn.events = EPOLLIN;
+        conn.deadline = Clock::now() + std::chrono::milliseconds(REQUEST_TIMEOUT_MS);
+        m_connection_count = m_connections.size();
+    }
+}
+
+bool ApiServer::on_readable(Connection& conn, int fd) {
+    char buffer[4096];
+    while (true) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            // A new request starts its own clock; a busy keep-alive can't stretch it
+            if (conn.in.empty() && !conn.writing) {
+                conn.deadline = Clock::now() + std::chrono::milliseconds(REQUEST_TIMEOUT_MS);
+            }
+            conn.in.append(buffer, static_cast<size_t>(n));
+            if (conn.in.size() > 2 * MAX_REQUEST_BYTES) {
+                return false;  // Pipelining far ahead of what we have answered
+            }
+            continue;
+        }
+        if (n == 0) {
+            conn.eof = true;
+            break;
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        return false;
+    }
+
+    // Nothing is read from a stream after its request
+    if (conn.stream) {
+        conn.in.clear();
+        return !conn.eof;
+    }
+
+    // Replies go out in request order: the rest waits for the current one
+    if (conn.writing) {
+        watch(conn, fd, true);
+        return true;
+    }
+    return serve(conn, fd);
+}
+
+bool ApiServer::serve(Connection& conn, int fd) {
+    while (true) {
+        if (conn.stream && !conn.writing && !pump(conn)) {
+            watch(conn, fd, false);
+            return true;
+        }
+        if (conn.writing) {
+            const size_t head_size = conn.head.size();
+            const size_t total = head_size + conn.body->size();
+            struct iovec iov[2];
+            int iov_count = 0;
+            if (conn.sent < head_size) {
+                iov[iov_count].iov_base = const_cast<char*>(conn.head.data() + conn.sent);
+                iov[iov_count].iov_len = head_size - conn.sent;
+                iov_count++;
+            }
+            size_t body_offset = conn.sent > head_size ? conn.sent - head_size : 0;
+            if (body_offset < conn.body->size()) {
+                iov[iov_count].iov_base = const_cast<char*>(conn.body->data() + body_offset);
+                iov[iov_count].iov_len = conn.body->size() - body_offset;
+                iov_count++;
+            }
+
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = iov;
+            msg.msg_iovlen = iov_count;
+            ssize_t n = iov_count > 0 ? sendmsg(fd, &msg, MSG_NOSIGNAL) : 0;
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    watch(conn, fd, true);
+                    return true;
+                }
+                return false;
+            }
+            conn.sent += static_cast<size_t>(n);
+            if (conn.sent < total) continue;
+
+            conn.writing = false;
+            conn.head.clear();
+            conn.body.reset();
+            if (conn.close_after) return false;
+            if (conn.stream) continue;
+            conn.deadline = Clock::now() + std::chrono::milliseconds(
+                conn.in.empty() ? IDLE_TIMEOUT_MS : REQUEST_TIMEOUT_MS);
+        }
+
+        // Pipelined requests wait behind a control action
+        if (conn.controlling) {
+            watch(conn, fd, false);
+            return true;
+        }
+
+        Request request;
+        int parsed = parse_request(conn.in, request);
+        if (parsed == 0) {
+            if (conn.eof) return false;
+            watch(conn, fd, false);
+            return true;
+        }
+        if (parsed < 0) {
+            conn.in.clear();
+            conn.close_after = true;
+            static const auto bad_request =
+                std::make_shared<const std::string>(R"({"error":"bad request"})");
+            queue(conn, 400, "application/json", bad_request, false);
+            continue;
+        }
+        respond(conn, fd, request);
+    }
+}
+
+void ApiServer::respond(Connection& conn, int fd, const Request& request) {
+    if (!request.keep_alive) {
+        conn.close_after = true;
+    }
+
+    static const std::string control_prefix = "/api/control/";
+    if (m_control_callback && request.method == "POST" &&
+        request.path.compare(0, control_prefix.size(), control_prefix) == 0) {
+        // Answered from on_control_done()
+        ControlCall call;
+        call.fd = fd;
+        call.serial = conn.serial;
+        call.action = request.path.substr(control_prefix.size());
+        call.body = request.body;
+        conn.controlling = true;
+        conn.deadline = Clock::now() + std::chrono::milliseconds(CONTROL_TIMEOUT_MS);
+        {
+            std::lock_guard<std::mutex> lock(m_control_mutex);
+            m_control_queue.push_back(std::move(call));
+        }
+        m_control_cv.notify_one();
+        return;
+    }
+
+    if (request.method == "GET" &&
+        (request.path == "/api/stats" || request.path == "/summary" || request.path == "/")) {
+        // The published snapshot; rendered here only before the first publish()
+        std::shared_ptr<const std::string> snapshot = std::atomic_load(&m_snapshot);
+        if (!snapshot) {
+            snapshot = std::make_shared<const std::string>(m_stats_callback ? m_stats_callback() : "{}");
+        }
+        queue(conn, 200, "application/json", std::move(snapshot), true);
+    } else if (m_metrics_callback && request.method == "GET" && request.path == "/metrics") {
+        queue(conn, 200, "text/plain; version=0.0.4",
+              std::make_shared<const std::string>(m_metrics_callback()), true);
+    } else if (m_event_bus && request.method == "GET" && request.path == "/events") {
+        open_stream(conn, request);
+    } else if (request.method == "GET" && request.path == "/health") {
+        static const auto health = std::make_shared<const std::string>(R"({"status":"ok"})");
+        queue(conn, 200, "application/json", health, true);
+    } else {
+        queue(conn, 404, "application/json", m_not_found, true);
+    }
+}
+
+void ApiServer::open_stream(Connection& conn, const Request& request) {
+    // An EventSource reconnecting resumes after the last id it saw, if the
+    // ring still has it; read() reports whatever was lost in between
+    conn.cursor = m_event_bus->head();
+    if (!request.last_event_id.empty()) {
+        uint64_t next = std::strtoull(request.last_event_id.c_str(), nullptr, 10) + 1;
+        if (next < conn.cursor) {
+            conn.cursor = next;
+        }
+    }
+    conn.stream = true;
+    conn.close_after = false;
+    conn.in.clear();
+    m_event_bus->subscribe();
+
+    queue_chunk(conn, "HTTP/1.1 200 OK\r\n"
+                      "Content-Type: text/event-stream\r\n"
+                      "Cache-Control: no-cache\r\n"
+                      "Connection: keep-alive\r\n"
+                      "Access-Control-Allow-Origin: *\r\n"
+                      "\r\n"
+                      "retry: 2000\n\n");
+}
+
+bool ApiServer::pump(Connection& conn) {
+    std::vector<EventBus::Event> events;
+    uint64_t dropped = 0;
+    m_event_bus->read(conn.cursor, events, STREAM_BATCH, dropped);
+    if (events.empty() && dropped == 0) {
+        return false;
+    }
+
+    std::string chunk;
+    if (dropped > 0) {
+        chunk += "event: dropped\ndata: {\"count\":" + std::to_string(dropped) + "}\n\n";
+    }
+    for (const auto& event : events) {
+        // Stamp the payload object with the bus time
+        std::string data(event.data, event.data_len);
+        std::string ts = R"({"ts":)" + std::to_string(event.time_ms);
+        chunk += "id: " + std::to_string(event.id) + "\nevent: " + event.type + "\ndata: " + ts +
+                 (data.size() > 2 ? "," + data.substr(1) : "}") + "\n\n";
+    }
+    queue_chunk(conn, std::move(chunk));
+    return true;
+}
+
+void ApiServer::on_events() {
+    m_event_bus->clear_notify();
+    std::vector<int> failed;
+    for (auto& entry : m_connections) {
+        Connection& conn = entry.second;
+        if (conn.stream && !conn.writing && !serve(conn, entry.first)) {
+            failed.push_back(entry.first);
+        }
+    }
+    for (int fd : failed) {
+        close_connection(fd);
+    }
+}
+
+void ApiServer::control_thread() {
+    std::unique_lock<std::mutex> lock(m_control_mutex);
+    while (true) {
+        m_control_cv.wait(lock, [this] { return !m_running || !m_control_queue.empty(); });
+        if (!m_running) return;
+        ControlCall call = std::move(m_control_queue.front());
+        m_control_queue.pop_front();
+
+        lock.unlock();
+        // A throwing action answers 500; it must not take the miner down
+        try {
+            call.status = m_control_callback(call.action, call.body, call.response);
+        } catch (...) {
+            call.status = 500;
+            call.response = R"({"error":"control action failed"})";
+        }
+        lock.lock();
+
+        m_control_done.push_back(std::move(call));
+        uint64_t one = 1;
+        ssize_t ignored = write(m_control_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void ApiServer::on_control_done() {
+    uint64_t count;
+    ssize_t ignored = read(m_control_fd, &count, sizeof(count));
+    (void)ignored;
+
+    std::vector<ControlCall> done;
+    {
+        std::lock_guard<std::mutex> lock(m_control_mutex);
+        done.swap(m_control_done);
+    }
+    for (ControlCall& call : done) {
+        // The client may have timed out, and its fd gone to someone else
+        auto it = m_connections.find(call.fd);
+        if (it == m_connections.end() || it->second.serial != call.serial || !it->second.controlling) {
+            continue;
+        }
+        Connection& conn = it->second;
+        conn.controlling = false;
+        queue(conn, call.status, "application/json",
+              std::make_shared<const std::string>(std::move(call.response)), false);
+        if (!serve(conn, call.fd)) {
+            close_connection(call.fd);
+        }
+    }
+}
+
+void ApiServer::queue_chunk(Connection& conn, std::string data) {
+    // Stream writes carry everything in head; a consumer that stops reading
+    // loses events in the ring, and is closed only once it has not taken a
+    // byte for a whole idle period
+    static const auto empty = std::make_shared<const std::string>();
+    conn.head = std::move(data);
+    conn.body = empty;
+    conn.sent = 0;
+    conn.writing = true;
+    conn.deadline = Clock::now() + std::chrono::milliseconds(IDLE_TIMEOUT_MS);
+}
+
+void ApiServer::queue(Connection& conn, int status, const char* content_type,
+                      std::shared_ptr<const std::string> body, bool cors) {
+    std::stringstream ss;
+    ss << "HTTP/1.1 " << status << " " << status_text(status) << "\r\n"
+       << "Content-Type: " << content_type << "\r\n"
+       << "Content-Length: " << body->size() << "\r\n"
+       << "Connection: " << (conn.close_after ? "close" : "keep-alive") << "\r\n";
+    if (cors) {
+        ss << "Access-Control-Allow-Origin: *\r\n";
+    }
+    ss << "\r\n";
+
+    conn.head = ss.str();
+    conn.body = std::move(body);
+    conn.sent = 0;
+    conn.writing = true;
+    conn.deadline = Clock::now() + std::chrono::milliseconds(WRITE_TIMEOUT_MS);
+}
+
+void ApiServer::watch(Connection& conn, int fd, bool writing) {
+    // Stop polling for input once the client has shut down its side
+    uint32_t events = (conn.eof ? 0 : static_cast<uint32_t>(EPOLLIN)) |
+                      (writing ? static_cast<uint32_t>(EPOLLOUT) : 0);
+    if (conn.events == events) return;
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.fd = fd;
+    epoll_ctl(m_epoll, EPOLL_CTL_MOD, fd, &ev);
+    conn.events = events;
+}
+
+void ApiServer::close_connection(int fd) {
+    auto it = m_connections.find(fd);
+    if (it != m_connections.end() && it->second.stream) {
+        m_event_bus->unsubscribe();
+    }
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    m_connections.erase(fd);
+    m_connection_count = m_connections.size();
+}
+
+int ApiServer::parse_request(std::string& in, Request& request) {
+    size_t header_end = in.find("\r\n\r\n");
+    if (header_end == std::string::npos) {
+        return in.size() > MAX_REQUEST_BYTES ? -1 : 0;
+    }
+
+    // Request line: METHOD SP target SP version
+    size_t line_end = in.find("\r\n");
+    std::istringstream line(in.substr(0, line_end));
+    std::string target, version;
+    if (!(line >> request.method >> target >> version) || version.compare(0, 5, "HTTP/") != 0) {
+        return -1;
+    }
+    request.path = target.substr(0, target.find('?'));
+
+    // Header names are case-insensitive
+    size_t content_length = 0;
+    std::string connection;
+    size_t pos = line_end + 2;
+    while (pos < header_end) {
+        size_t end = in.find("\r\n", pos);
+        size_t colon = in.find(':', pos);
+        if (colon != std::string::npos && colon < end) {
+            std::string name = in.substr(pos, colon - pos);
+            std::transform(name.begin(), name.end(), name.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            std::string value = in.substr(colon + 1, end - colon - 1);
+            value.erase(0, value.find_first_not_of(" \t"));
+            if (name == "content-length") {
+                // Digits only, bounded before any arithmetic: "-1" or 2^64 - 1 would wrap the framing
+                value.erase(value.find_last_not_of(" \t") + 1);
+                if (value.empty() || value.size() > 9 ||
+                    value.find_first_not_of("0123456789") != std::string::npos) {
+                    return -1;
+                }
+                content_length = std::strtoul(value.c_str(), nullptr, 10);
+                if (content_length > MAX_REQUEST_BYTES) {
+                    return -1;
+                }
+            } else if (name == "last-event-id") {
+                request.last_event_id = value;
+            } else if (name == "connection") {
+                std::transform(value.begin(), value.end(), value.begin(),
+                               [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                connection = value;
+            }
+        }
+        pos = end + 2;
+    }
+
+    // HTTP/1.1 keeps the connection unless told otherwise; 1.0 only when asked
+    if (version == "HTTP/1.0") {
+        request.keep_alive = connection.find("keep-alive") != std::string::npos;
+    } else {
+        request.keep_alive = connection.find("close") == std::string::npos;
+    }
+
+    if (header_end + 4 + content_length > MAX_REQUEST_BYTES) {
+        return -1;
+    }
+    if (in.size() < header_end + 4 + content_length) {
+        return 0;
+    }
+    request.body = in.substr(header_end + 4, content_length);
+    in.erase(0, header_end + 4 + content_length);
+    return 1;
+}
+
+std::string ApiServer::status_text(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 409: return "Conflict";
+        case 500: return "Internal Server Error";
+        default:  return "Error";
+    }
+}
+
+}  // namespace utils
+}  // namespace bloxminer
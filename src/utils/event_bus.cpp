@@ -0,0 +1,102 @@
+#include "../../include/utils/event_bus.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+namespace bloxminer {
+namespace utils {
+
+EventBus::EventBus(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    m_slots.reset(new Slot[size]);
+    m_mask = size - 1;
+    m_notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+EventBus::~EventBus() {
+    if (m_notify_fd >= 0) {
+        close(m_notify_fd);
+    }
+}
+
+void EventBus::clear_notify() {
+    uint64_t count;
+    ssize_t ignored = ::read(m_notify_fd, &count, sizeof(count));
+    (void)ignored;
+}
+
+bool EventBus::publish(const char* type, const std::string& data) {
+    if (data.size() > DATA_SIZE) {
+        return false;
+    }
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    uint64_t id = m_head.fetch_add(1, std::memory_order_acq_rel);
+    Slot& slot = m_slots[id & m_mask];
+
+    // Seqlock write: readers that see an odd or changed sequence retry or skip
+    slot.seq.store(2 * id + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.event.id = id;
+    slot.event.time_ms = now_ms;
+    strncpy(slot.event.type, type, TYPE_SIZE - 1);
+    slot.event.type[TYPE_SIZE - 1] = '\0';
+    memcpy(slot.event.data, data.data(), data.size());
+    slot.event.data_len = static_cast<uint32_t>(data.size());
+    slot.seq.store(2 * id + 2, std::memory_order_release);
+
+    if (m_subscribers.load(std::memory_order_relaxed) > 0 && m_notify_fd >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(m_notify_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+    return true;
+}
+
+uint64_t EventBus::tail() const {
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    return head > capacity() ? head - capacity() : 0;
+}
+
+size_t EventBus::read(uint64_t& cursor, std::vector<Event>& out, size_t max, uint64_t& dropped) const {
+    size_t copied = 0;
+    while (copied < max) {
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        if (cursor >= head) break;
+
+        // Lapped: skip what the ring no longer holds
+        if (head - cursor > capacity()) {
+            dropped += head - capacity() - cursor;
+            cursor = head - capacity();
+        }
+
+        const Slot& slot = m_slots[cursor & m_mask];
+        const uint64_t ready = 2 * cursor + 2;
+        uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before < ready) {
+            break;  // Claimed but not written yet; the writer notifies when done
+        }
+        if (before == ready) {
+            Event event;
+            memcpy(&event, &slot.event, sizeof(event));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) == ready) {
+                out.push_back(event);
+                copied++;
+                cursor++;
+                continue;
+            }
+        }
+        // Overwritten by a newer event before or while we copied it
+        dropped++;
+        cursor++;
+    }
+    return copied;
+}
+
+}  // namespace utils
+}  // namespace bloxminer
@@ -0,0 +1,303 @@
+#include "../../include/utils/journal.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace bloxminer {
+namespace utils {
+
+static int64_t unix_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string journal_path() {
+    return "/tmp/bloxminer-" + std::to_string(static_cast<int>(getuid())) + "/journal.bin";
+}
+
+bool Journal::open(const std::string& path, size_t records) {
+    close();
+
+    size_t capacity = 64;
+    while (capacity < records) {
+        capacity <<= 1;
+    }
+
+    size_t slash = path.rfind('/');
+    if (slash != std::string::npos && slash > 0) {
+        mkdir(path.substr(0, slash).c_str(), 0700);
+    }
+
+    // Keep the previous run's journal: it is the one worth reading after a crash
+    struct stat st;
+    if (lstat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+        rename(path.c_str(), (path + ".1").c_str());
+    }
+
+    // O_NOFOLLOW refuses a symlink planted at the path
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    size_t size = sizeof(JournalHeader) + capacity * sizeof(JournalRecord);
+    if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
+        ::close(fd);
+        return false;
+    }
+    void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    // The file is fresh and zeroed, so every record reads as unwritten;
+    // readers check the header before trusting the layout, so fill it last
+    JournalHeader* header = static_cast<JournalHeader*>(map);
+    header->version = JournalHeader::VERSION;
+    header->header_size = sizeof(JournalHeader);
+    header->record_size = sizeof(JournalRecord);
+    header->capacity = capacity;
+    header->pid = static_cast<uint32_t>(getpid());
+    header->start_tsc = journal_clock();
+    header->start_unix_ns = unix_now_ns();
+    header->head.store(0, std::memory_order_relaxed);
+
+    m_header = header;
+    m_records = reinterpret_cast<JournalRecord*>(static_cast<char*>(map) + sizeof(JournalHeader));
+    m_mask = capacity - 1;
+    m_map_size = size;
+
+    // A first rate good enough until the run is long enough to refine it
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    calibrate();
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = JournalHeader::MAGIC;
+    return true;
+}
+
+void Journal::close() {
+    if (m_header) {
+        calibrate();
+        munmap(m_header, m_map_size);
+        m_header = nullptr;
+        m_records = nullptr;
+    }
+}
+
+void Journal::calibrate() {
+    if (!m_header) return;
+    m_header->anchor_tsc = journal_clock();
+    m_header->anchor_unix_ns = unix_now_ns();
+}
+
+bool read_journal(const std::string& path, std::vector<JournalEntry>& out, std::string& error) {
+    out.clear();
+    int fd = ::open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(JournalHeader)) {
+        ::close(fd);
+        error = path + ": not a journal";
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    const JournalHeader* header = static_cast<const JournalHeader*>(map);
+    uint64_t capacity = header->capacity;
+
+    bool ok = false;
+    if (header->magic != JournalHeader::MAGIC) {
+        error = path + ": not a journal";
+    } else if (header->version != JournalHeader::VERSION || header->header_size != sizeof(JournalHeader) ||
+               header->record_size != sizeof(JournalRecord)) {
+        error = path + ": layout version " + std::to_string(header->version) + ", expected " +
+                std::to_string(JournalHeader::VERSION);
+    } else if (capacity == 0 || (capacity & (capacity - 1)) != 0 ||
+               capacity > (size - sizeof(JournalHeader)) / sizeof(JournalRecord)) {
+        error = path + ": truncated journal";
+    } else {
+        ok = true;
+        const JournalRecord* records = reinterpret_cast<const JournalRecord*>(
+            static_cast<const char*>(map) + sizeof(JournalHeader));
+
+        // Ticks per ns from the two anchors; 1 where the clock is already ns
+        double rate = 1.0;
+        if (header->anchor_tsc > header->start_tsc && header->anchor_unix_ns > header->start_unix_ns) {
+            rate = static_cast<double>(header->anchor_tsc - header->start_tsc) /
+                   static_cast<double>(header->anchor_unix_ns - header->start_unix_ns);
+        }
+
+        uint64_t head = header->head.load(std::memory_order_acquire);
+        uint64_t first = head > capacity ? head - capacity : 0;
+        out.reserve(static_cast<size_t>(head - first));
+        for (uint64_t index = first; index < head; index++) {
+            const JournalRecord& r = records[index & (capacity - 1)];
+            uint32_t seq = r.seq.load(std::memory_order_acquire);
+            if (seq != static_cast<uint32_t>(index + 1)) {
+                continue;  // Still being written, never finished, or already overwritten
+            }
+            JournalEntry entry;
+            entry.index = index;
+            uint64_t tsc = r.tsc;
+            entry.type = static_cast<JournalEvent>(r.type);
+            entry.thread = r.thread;
+            entry.a = r.a;
+            entry.b = r.b;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (r.seq.load(std::memory_order_relaxed) != seq) {
+                continue;
+            }
+            double ticks = static_cast<double>(static_cast<int64_t>(tsc - header->start_tsc));
+            entry.unix_ns = header->start_unix_ns + static_cast<int64_t>(ticks / rate);
+            out.push_back(entry);
+        }
+    }
+    munmap(map, size);
+    return ok;
+}
+
+const char* journal_event_name(JournalEvent type) {
+    switch (type) {
+        case JournalEvent::JobReceived: return "job_received";
+        case JournalEvent::JobPrepared: return "job_prepared";
+        case JournalEvent::ShareFound: return "share_found";
+        case JournalEvent::ShareSubmitted: return "share_submitted";
+        case JournalEvent::ShareResult: return "share_result";
+        case JournalEvent::PoolConnected: return "pool_connected";
+        case JournalEvent::PoolLost: return "pool_lost";
+        case JournalEvent::PoolSwitch: return "pool_switch";
+        case JournalEvent::ThreadStall: return "thread_stall";
+        case JournalEvent::Governor: return "governor";
+        case JournalEvent::Throttle: return "throttle";
+        case JournalEvent::Pause: return "pause";
+        case JournalEvent::Stats: return "stats";
+        case JournalEvent::Heal: return "heal";
+    }
+    return "unknown";
+}
+
+std::string format_journal_entry(const JournalEntry& entry, bool json) {
+    // Named fields, rendered bare in both forms unless quoted is set
+    struct Field {
+        const char* name;
+        std::string value;
+        bool quoted;
+    };
+    auto number = [](uint64_t v) { return std::to_string(v); };
+    auto flag = [](bool v) { return std::string(v ? "true" : "false"); };
+    std::vector<Field> fields;
+    const uint64_t a = entry.a;
+    const uint64_t b = entry.b;
+    switch (entry.type) {
+        case JournalEvent::JobReceived:
+            fields = {{"job", number(a), false}, {"clean", flag(b & 1), false}, {"resumed", flag(b & 2), false}};
+            break;
+        case JournalEvent::JobPrepared:
+            fields = {{"job", number(a), false}, {"latency_ns", number(b), false}};
+            break;
+        case JournalEvent::ShareFound: {
+            char hex[16];
+            snprintf(hex, sizeof(hex), "%08llx", static_cast<unsigned long long>(a));
+            fields = {{"nonce", hex, true}, {"job", number(b), false}};
+            break;
+        }
+        case JournalEvent::ShareSubmitted: {
+            char hex[16];
+            snprintf(hex, sizeof(hex), "%08llx", static_cast<unsigned long long>(a));
+            const char* via = b == 0 ? "sent" : (b == 1 ? "buffered" : "replayed");
+            fields = {{"nonce", hex, true}, {"via", via, true}};
+            break;
+        }
+        case JournalEvent::ShareResult:
+            fields = {{"accepted", flag(a != 0), false}, {"rtt_us", number(b), false}};
+            break;
+        case JournalEvent::PoolConnected:
+            fields = {{"pool", number(a), false}, {"reconnect", flag(b != 0), false}};
+            break;
+        case JournalEvent::PoolLost:
+            fields = {{"pool", number(a), false}};
+            break;
+        case JournalEvent::PoolSwitch:
+            fields = {{"from", number(a), false}, {"to", number(b), false}};
+            break;
+        case JournalEvent::ThreadStall:
+            fields = {{"stalled_ms", number(a), false}};
+            break;
+        case JournalEvent::Governor:
+            fields = {{"threads", number(a), false}, {"duty_permille", number(b), false}};
+            break;
+        case JournalEvent::Throttle:
+            fields = {{"threads", number(a), false}, {"previous", number(b), false}};
+            break;
+        case JournalEvent::Pause:
+            fields = {{"paused", flag(a != 0), false}};
+            break;
+        case JournalEvent::Stats:
+            fields = {{"hashrate", number(a), false}, {"threads", number(b), false}};
+            break;
+        case JournalEvent::Heal: {
+            const char* action = a == 0 ? "moved" : (a == 1 ? "retired" : "kept");
+            uint32_t to = static_cast<uint32_t>(b);
+            fields = {{"action", action, true}, {"from_cpu", number(b >> 32), false},
+                      {"to_cpu", to == 0xffffffffu ? "null" : number(to), false}};
+            break;
+        }
+        default:
+            fields = {{"type", number(static_cast<uint16_t>(entry.type)), false},
+                      {"a", number(a), false}, {"b", number(b), false}};
+            break;
+    }
+
+    std::string line;
+    if (json) {
+        line = "{\"index\":" + number(entry.index) + ",\"unix_ns\":" + std::to_string(entry.unix_ns) +
+               ",\"event\":\"" + journal_event_name(entry.type) + "\"";
+        if (entry.thread != JournalRecord::NO_THREAD) {
+            line += ",\"thread\":" + number(entry.thread);
+        }
+        for (const Field& f : fields) {
+            line += ",\"" + std::string(f.name) + "\":" + (f.quoted ? "\"" + f.value + "\"" : f.value);
+        }
+        line += "}";
+        return line;
+    }
+
+    // Local time to the microsecond, like the log
+    time_t seconds = static_cast<time_t>(entry.unix_ns / 1000000000);
+    struct tm tm_buf;
+    localtime_r(&seconds, &tm_buf);
+    char stamp[48];
+    size_t n = strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm_buf);
+    snprintf(stamp + n, sizeof(stamp) - n, ".%06lld", static_cast<long long>((entry.unix_ns / 1000) % 1000000));
+
+    char thread[8] = "-";
+    if (entry.thread != JournalRecord::NO_THREAD) {
+        snprintf(thread, sizeof(thread), "t%u", static_cast<unsigned>(entry.thread));
+    }
+    char prefix[96];
+    snprintf(prefix, sizeof(prefix), "%s %-4s %-15s", stamp, thread, journal_event_name(entry.type));
+    line = prefix;
+    for (const Field& f : fields) {
+        line += " " + std::string(f.name) + "=" + f.value;
+    }
+    return line;
+}
+
+}  // namespace utils
+}  // namespace bloxminer
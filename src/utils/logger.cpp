@@ -1,185 +1,390 @@
 #include "../../include/utils/logger.hpp"
 #include "../../include/utils/display.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
 #include <iomanip>
 
 namespace bloxminer {
 namespace utils {
 
-void Logger::hashrate(double hashrate, const std::string& unit) {
-    std::string formatted_unit = unit;
+Logger::Logger() {
+    // Constructed first so it is destroyed after the final drain below
+    Display::instance();
+    m_writer = std::thread(&Logger::writer_loop, this);
+}
 
-    // Auto-scale hashrate
-    if (hashrate >= 1e12) {
-        hashrate /= 1e12;
-        formatted_unit = "TH/s";
-    } else if (hashrate >= 1e9) {
-        hashrate /= 1e9;
-        formatted_unit = "GH/s";
-    } else if (hashrate >= 1e6) {
-        hashrate /= 1e6;
-        formatted_unit = "MH/s";
-    } else if (hashrate >= 1e3) {
-        hashrate /= 1e3;
-        formatted_unit = "KH/s";
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+        m_stop = true;
     }
+    m_wake.notify_all();
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+    drain();
+}
 
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+Logger::Ring* Logger::local_ring() {
+    // Registered once per thread; the writer frees it after the thread exits
+    struct Handle {
+        std::shared_ptr<Ring> ring;
+        ~Handle() {
+            if (ring) ring->retired.store(true, std::memory_order_release);
+        }
+    };
+    thread_local Handle handle;
+    if (!handle.ring) {
+        handle.ring = std::make_shared<Ring>();
+        std::lock_guard<std::mutex> lock(m_rings_mutex);
+        m_rings.push_back(handle.ring);
+    }
+    return handle.ring.get();
+}
 
-    std::stringstream ss;
-    ss << "\033[90m" << std::put_time(std::localtime(&time), "%H:%M:%S")
-       << "." << std::setfill('0') << std::setw(3) << ms.count() << "\033[0m "
-       << "\033[36m[HASH]\033[0m "
-       << std::fixed << std::setprecision(2) << hashrate << " " << formatted_unit;
+bool Logger::set_file(const std::string& path, uint64_t max_bytes, uint32_t keep) {
+    std::lock_guard<std::mutex> lock(m_drain_mutex);
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+    m_file_path = path;
+    m_file_max = max_bytes;
+    m_file_keep = keep;
+    if (path.empty()) {
+        return true;
+    }
+    m_file.open(path, std::ios::out | std::ios::app);
+    if (!m_file) {
+        return false;
+    }
+    m_file.seekp(0, std::ios::end);
+    m_file_size = static_cast<uint64_t>(std::max<std::streamoff>(0, m_file.tellp()));
+    return true;
+}
 
-    Display::instance().log(ss.str());
+void Logger::flush() {
+    drain();
 }
 
-void Logger::hashrate_with_stats(double hashrate, double cpu_temp, double cpu_power) {
-    std::string formatted_unit = "H/s";
+void Logger::writer_loop() {
+    std::unique_lock<std::mutex> lock(m_wake_mutex);
+    while (!m_stop) {
+        lock.unlock();
+        drain();
+        lock.lock();
+        m_wake.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS), [this] { return m_stop; });
+    }
+}
+
+// "HH:MM:SS.mmm" in gray, as every line starts
+static void write_timestamp(std::ostream& os, int64_t time_ns) {
+    time_t seconds = static_cast<time_t>(time_ns / 1000000000);
+    struct tm tm_buf;
+    localtime_r(&seconds, &tm_buf);
+    char stamp[16];
+    strftime(stamp, sizeof(stamp), "%H:%M:%S", &tm_buf);
+    os << "\033[90m" << stamp << "." << std::setfill('0') << std::setw(3)
+       << (time_ns / 1000000) % 1000 << std::setfill(' ') << "\033[0m ";
+}
+
+static void write_arg(std::ostream& os, const Logger::Record& r, size_t i) {
+    const Logger::Arg& arg = r.args[i];
+    switch (arg.kind) {
+        case Logger::Arg::Int: os << arg.i; break;
+        case Logger::Arg::UInt: os << arg.u; break;
+        case Logger::Arg::Double: os << arg.d; break;
+        case Logger::Arg::Bool: os << (arg.u != 0); break;
+        case Logger::Arg::Char: os << static_cast<char>(arg.u); break;
+        case Logger::Arg::String: os.write(r.str(i), static_cast<std::streamsize>(r.len(i))); break;
+        case Logger::Arg::Pointer: os << arg.p; break;
+    }
+}
+
+// Substitute arguments in order; once they run out the rest is literal
+static void write_message(std::ostream& os, const Logger::Record& r) {
+    const char* fmt = r.fmt;
+    size_t next = 0;
+    while (*fmt && next < r.nargs) {
+        if (*fmt == '%' && *(fmt + 1)) {
+            fmt++;
+            // Skip length modifiers (l, ll, h, hh, z)
+            while (*fmt == 'l' || *fmt == 'h' || *fmt == 'z') {
+                fmt++;
+            }
+            switch (*fmt) {
+                case 's':
+                case 'd':
+                case 'u':
+                case 'f':
+                case 'x':
+                case 'X':
+                case 'p':
+                case 'i':
+                    write_arg(os, r, next++);
+                    break;
+                case '%':
+                    os << '%';
+                    break;
+                default:
+                    os << '%' << *fmt;
+                    break;
+            }
+            if (*fmt) fmt++;
+        } else {
+            os << *fmt++;
+        }
+    }
+    os << fmt;
+}
 
-    // Auto-scale hashrate
+// The terminal gets colors; the file gets the same text without escapes
+static std::string strip_ansi(const std::string& line) {
+    std::string out;
+    out.reserve(line.size());
+    for (size_t i = 0; i < line.size(); i++) {
+        if (line[i] == '\033' && i + 1 < line.size() && line[i + 1] == '[') {
+            i += 2;
+            while (i < line.size() && !(line[i] >= '@' && line[i] <= '~')) i++;
+            continue;
+        }
+        out += line[i];
+    }
+    return out;
+}
+
+void Logger::drain() {
+    std::lock_guard<std::mutex> lock(m_drain_mutex);
+
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> rings_lock(m_rings_mutex);
+        rings = m_rings;
+    }
+
+    m_batch.clear();
+    uint64_t dropped = 0;
+    for (const auto& ring : rings) {
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        for (; tail < head; tail++) {
+            m_batch.push_back(ring->slots[tail % RING_SIZE]);
+        }
+        ring->tail.store(head, std::memory_order_release);
+        uint64_t lost = ring->dropped.load(std::memory_order_relaxed);
+        dropped += lost - ring->dropped_reported;
+        ring->dropped_reported = lost;
+    }
+
+    // Threads that exited and were drained above
+    {
+        std::lock_guard<std::mutex> rings_lock(m_rings_mutex);
+        m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(), [](const std::shared_ptr<Ring>& ring) {
+            return ring->retired.load(std::memory_order_acquire) &&
+                   ring->head.load(std::memory_order_acquire) == ring->tail.load(std::memory_order_relaxed);
+        }), m_rings.end());
+    }
+
+    if (m_batch.empty() && dropped == 0) {
+        return;
+    }
+    std::sort(m_batch.begin(), m_batch.end(), [](const Record& a, const Record& b) { return a.seq < b.seq; });
+
+    // One terminal write for the whole batch
+    std::string terminal;
+    for (const Record& r : m_batch) {
+        std::ostringstream ss;
+        write_timestamp(ss, r.time_ns);
+        if (r.render) {
+            r.render(ss, r);
+        } else {
+            const char* color = "";
+            const char* prefix = "";
+            switch (r.level) {
+                case LogLevel::DEBUG: color = "\033[36m"; prefix = "DBG"; break;
+                case LogLevel::INFO:  color = "\033[32m"; prefix = "INF"; break;
+                case LogLevel::WARN:  color = "\033[33m"; prefix = "WRN"; break;
+                case LogLevel::ERROR: color = "\033[31m"; prefix = "ERR"; break;
+            }
+            ss << color << "[" << prefix << "]\033[0m ";
+            write_message(ss, r);
+        }
+        std::string line = ss.str();
+        write_line(line);
+        if (!terminal.empty()) terminal += '\n';
+        terminal += line;
+    }
+    if (dropped > 0) {
+        m_dropped_total.fetch_add(dropped, std::memory_order_relaxed);
+        std::ostringstream ss;
+        write_timestamp(ss, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        ss << "\033[33m[WRN]\033[0m Logger: " << dropped << " message(s) dropped, a thread logged faster than "
+           << "they could be written";
+        std::string line = ss.str();
+        write_line(line);
+        if (!terminal.empty()) terminal += '\n';
+        terminal += line;
+    }
+    Display::instance().log(terminal);
+    if (m_file.is_open()) {
+        m_file.flush();
+    }
+}
+
+void Logger::write_line(const std::string& line) {
+    if (!m_file.is_open()) return;
+    std::string plain = strip_ansi(line);
+    m_file << plain << '\n';
+    m_file_size += plain.size() + 1;
+    if (m_file_max > 0 && m_file_size >= m_file_max) {
+        rotate();
+    }
+}
+
+void Logger::rotate() {
+    // path -> path.1 -> ... -> path.<keep>; the oldest falls off
+    m_file.close();
+    if (m_file_keep == 0) {
+        std::remove(m_file_path.c_str());
+    } else {
+        std::remove((m_file_path + "." + std::to_string(m_file_keep)).c_str());
+        for (uint32_t i = m_file_keep - 1; i >= 1; i--) {
+            std::rename((m_file_path + "." + std::to_string(i)).c_str(),
+                        (m_file_path + "." + std::to_string(i + 1)).c_str());
+        }
+        std::rename(m_file_path.c_str(), (m_file_path + ".1").c_str());
+    }
+    m_file.open(m_file_path, std::ios::out | std::ios::trunc);
+    m_file_size = 0;
+}
+
+// Tagged lines: the arguments are recorded by the caller, rendered here
+
+static void scale_hashrate(double& hashrate, std::string& unit) {
     if (hashrate >= 1e12) {
         hashrate /= 1e12;
-        formatted_unit = "TH/s";
+        unit = "TH/s";
     } else if (hashrate >= 1e9) {
         hashrate /= 1e9;
-        formatted_unit = "GH/s";
+        unit = "GH/s";
     } else if (hashrate >= 1e6) {
         hashrate /= 1e6;
-        formatted_unit = "MH/s";
+        unit = "MH/s";
     } else if (hashrate >= 1e3) {
         hashrate /= 1e3;
-        formatted_unit = "KH/s";
+        unit = "KH/s";
     }
+}
 
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+static void render_hashrate(std::ostream& os, const Logger::Record& r) {
+    double hashrate = r.args[0].d;
+    std::string unit(r.str(1), r.len(1));
+    scale_hashrate(hashrate, unit);
+    os << "\033[36m[HASH]\033[0m "
+       << std::fixed << std::setprecision(2) << hashrate << " " << unit;
+}
+
+void Logger::hashrate(double hashrate, const std::string& unit) {
+    push(LogLevel::INFO, nullptr, &render_hashrate, hashrate, unit);
+}
 
-    std::stringstream ss;
-    ss << "\033[90m" << std::put_time(std::localtime(&time), "%H:%M:%S")
-       << "." << std::setfill('0') << std::setw(3) << ms.count() << "\033[0m "
-       << "\033[36m[HASH]\033[0m "
-       << "\033[1m" << std::fixed << std::setprecision(2) << hashrate << " " << formatted_unit << "\033[0m";
+static void render_hashrate_with_stats(std::ostream& os, const Logger::Record& r) {
+    double hashrate = r.args[0].d;
+    double cpu_temp = r.args[1].d;
+    double cpu_power = r.args[2].d;
+    std::string unit = "H/s";
+    scale_hashrate(hashrate, unit);
+    os << "\033[36m[HASH]\033[0m "
+       << "\033[1m" << std::fixed << std::setprecision(2) << hashrate << " " << unit << "\033[0m";
 
     // Add temp if available
     if (cpu_temp > 0) {
-        ss << " | \033[33mTemp:\033[0m " << std::fixed << std::setprecision(0) << cpu_temp << "C";
+        os << " | \033[33mTemp:\033[0m " << std::fixed << std::setprecision(0) << cpu_temp << "C";
     }
 
     // Add power if available
     if (cpu_power > 0) {
-        ss << " | \033[35mPower:\033[0m " << std::fixed << std::setprecision(1) << cpu_power << "W";
+        os << " | \033[35mPower:\033[0m " << std::fixed << std::setprecision(1) << cpu_power << "W";
     }
-
-    Display::instance().log(ss.str());
 }
 
-void Logger::system_stats(double cpu_temp, double cpu_power) {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+void Logger::hashrate_with_stats(double hashrate, double cpu_temp, double cpu_power) {
+    push(LogLevel::INFO, nullptr, &render_hashrate_with_stats, hashrate, cpu_temp, cpu_power);
+}
 
-    std::stringstream ss;
-    ss << "\033[90m" << std::put_time(std::localtime(&time), "%H:%M:%S")
-       << "." << std::setfill('0') << std::setw(3) << ms.count() << "\033[0m "
-       << "\033[34m[SYS]\033[0m ";
+static void render_system_stats(std::ostream& os, const Logger::Record& r) {
+    double cpu_temp = r.args[0].d;
+    double cpu_power = r.args[1].d;
+    os << "\033[34m[SYS]\033[0m ";
 
     if (cpu_temp > 0) {
-        ss << "Temp: " << std::fixed << std::setprecision(0) << cpu_temp << "C";
+        os << "Temp: " << std::fixed << std::setprecision(0) << cpu_temp << "C";
     }
 
     if (cpu_power > 0) {
-        if (cpu_temp > 0) ss << " | ";
-        ss << "Power: " << std::fixed << std::setprecision(1) << cpu_power << "W";
+        if (cpu_temp > 0) os << " | ";
+        os << "Power: " << std::fixed << std::setprecision(1) << cpu_power << "W";
     }
+}
 
-    Display::instance().log(ss.str());
+void Logger::system_stats(double cpu_temp, double cpu_power) {
+    push(LogLevel::INFO, nullptr, &render_system_stats, cpu_temp, cpu_power);
 }
 
-void Logger::share_accepted(uint64_t accepted, uint64_t rejected) {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+static void render_share_accepted(std::ostream& os, const Logger::Record& r) {
+    os << "\033[32m[SHARE]\033[0m "
+       << "Accepted: \033[32m" << r.args[0].u << "\033[0m"
+       << " | Rejected: \033[31m" << r.args[1].u << "\033[0m";
+}
 
-    std::stringstream ss;
-    ss << "\033[90m" << std::put_time(std::localtime(&time), "%H:%M:%S")
-       << "." << std::setfill('0') << std::setw(3) << ms.count() << "\033[0m "
-       << "\033[32m[SHARE]\033[0m "
-       << "Accepted: \033[32m" << accepted << "\033[0m"
-       << " | Rejected: \033[31m" << rejected << "\033[0m";
+void Logger::share_accepted(uint64_t accepted, uint64_t rejected) {
+    push(LogLevel::INFO, nullptr, &render_share_accepted, accepted, rejected);
+}
 
-    Display::instance().log(ss.str());
+static void render_share_found(std::ostream& os, const Logger::Record& r) {
+    os << "\033[33m[FOUND]\033[0m "
+       << "Share found! Difficulty: " << std::fixed << std::setprecision(4) << r.args[0].d;
 }
 
 void Logger::share_found(double difficulty) {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
-
-    std::stringstream ss;
-    ss << "\033[90m" << std::put_time(std::localtime(&time), "%H:%M:%S")
-       << "." << std::setfill('0') << std::setw(3) << ms.count() << "\033[0m "
-       << "\033[33m[FOUND]\033[0m "
-       << "Share found! Difficulty: " << std::fixed << std::setprecision(4) << difficulty;
+    push(LogLevel::INFO, nullptr, &render_share_found, difficulty);
+}
 
-    Display::instance().log(ss.str());
+static void render_connected(std::ostream& os, const Logger::Record& r) {
+    os << "\033[32m[CONN]\033[0m "
+       << "Connected to ";
+    os.write(r.str(0), static_cast<std::streamsize>(r.len(0)));
+    os << ":" << r.args[1].u;
 }
 
 void Logger::connected(const std::string& host, uint16_t port) {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
-
-    std::stringstream ss;
-    ss << "\033[90m" << std::put_time(std::localtime(&time), "%H:%M:%S")
-       << "." << std::setfill('0') << std::setw(3) << ms.count() << "\033[0m "
-       << "\033[32m[CONN]\033[0m "
-       << "Connected to " << host << ":" << port;
+    push(LogLevel::INFO, nullptr, &render_connected, host, port);
+}
 
-    Display::instance().log(ss.str());
+static void render_disconnected(std::ostream& os, const Logger::Record& r) {
+    os << "\033[31m[DISC]\033[0m "
+       << "Disconnected: ";
+    os.write(r.str(0), static_cast<std::streamsize>(r.len(0)));
 }
 
 void Logger::disconnected(const std::string& reason) {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
-
-    std::stringstream ss;
-    ss << "\033[90m" << std::put_time(std::localtime(&time), "%H:%M:%S")
-       << "." << std::setfill('0') << std::setw(3) << ms.count() << "\033[0m "
-       << "\033[31m[DISC]\033[0m "
-       << "Disconnected: " << reason;
+    push(LogLevel::INFO, nullptr, &render_disconnected, reason);
+}
 
-    Display::instance().log(ss.str());
+static void render_new_job(std::ostream& os, const Logger::Record& r) {
+    os << "\033[35m[JOB]\033[0m "
+       << "New job: ";
+    os.write(r.str(0), static_cast<std::streamsize>(r.len(0)));
+    os << "... "
+       << "Difficulty: " << std::fixed << std::setprecision(4) << r.args[1].d;
 }
 
 void Logger::new_job(const std::string& job_id, double difficulty) {
     // Job notifications are DEBUG level - skip if log level is higher
     if (m_level > LogLevel::DEBUG) return;
 
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
-
-    std::stringstream ss;
-    ss << "\033[90m" << std::put_time(std::localtime(&time), "%H:%M:%S")
-       << "." << std::setfill('0') << std::setw(3) << ms.count() << "\033[0m "
-       << "\033[35m[JOB]\033[0m "
-       << "New job: " << job_id.substr(0, 8) << "... "
-       << "Difficulty: " << std::fixed << std::setprecision(4) << difficulty;
-
-    Display::instance().log(ss.str());
+    push(LogLevel::DEBUG, nullptr, &render_new_job, job_id.substr(0, 8), difficulty);
 }
 
 }  // namespace utils
@@ -0,0 +1,98 @@
+#include "../../include/utils/metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+namespace bloxminer {
+namespace utils {
+
+Histogram::Histogram(std::initializer_list<double> bounds)
+    : m_bounds(bounds), m_buckets(new std::atomic<uint64_t>[bounds.size() + 1]) {
+    std::sort(m_bounds.begin(), m_bounds.end());
+    for (size_t i = 0; i <= m_bounds.size(); i++) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::observe(double value) {
+    // Buckets are few; a linear scan beats a binary search here
+    size_t i = 0;
+    while (i < m_bounds.size() && value > m_bounds[i]) i++;
+    m_buckets[i].fetch_add(1, std::memory_order_relaxed);
+
+    double sum = m_sum.load(std::memory_order_relaxed);
+    while (!m_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t Histogram::count() const {
+    uint64_t n = 0;
+    for (size_t i = 0; i <= m_bounds.size(); i++) {
+        n += bucket(i);
+    }
+    return n;
+}
+
+void MetricsWriter::family(const std::string& name, const char* type, const char* help) {
+    m_out << "# HELP " << name << " " << help << "\n"
+          << "# TYPE " << name << " " << type << "\n";
+}
+
+void MetricsWriter::name_and_labels(const std::string& name, const std::string& labels) {
+    m_out << name;
+    if (!labels.empty()) {
+        m_out << "{" << labels << "}";
+    }
+    m_out << " ";
+}
+
+void MetricsWriter::sample(const std::string& name, const std::string& labels, double value) {
+    name_and_labels(name, labels);
+    if (std::isnan(value)) {
+        m_out << "NaN";
+    } else {
+        m_out << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+    }
+    m_out << "\n";
+}
+
+void MetricsWriter::sample(const std::string& name, const std::string& labels, uint64_t value) {
+    name_and_labels(name, labels);
+    m_out << value << "\n";
+}
+
+void MetricsWriter::histogram(const std::string& name, const char* help, const Histogram& h) {
+    family(name, "histogram", help);
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < h.bounds().size(); i++) {
+        cumulative += h.bucket(i);
+        std::ostringstream le;
+        le << "le=\"" << h.bounds()[i] << "\"";
+        sample(name + "_bucket", le.str(), cumulative);
+    }
+    cumulative += h.bucket(h.bounds().size());
+    sample(name + "_bucket", "le=\"+Inf\"", cumulative);
+    sample(name + "_sum", "", h.sum());
+    sample(name + "_count", "", cumulative);
+}
+
+std::string MetricsWriter::escape(const std::string& value) {
+    std::string out;
+    out.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+}  // namespace utils
+}  // namespace bloxminer
@@ -0,0 +1,138 @@
+#include "../../include/utils/perf_counters.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace bloxminer {
+namespace utils {
+
+#ifdef __linux__
+
+static int perf_event_open(perf_event_attr* attr, int group_fd) {
+    // This thread, any CPU
+    return static_cast<int>(syscall(SYS_perf_event_open, attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+bool PerfCounters::open(std::string& error) {
+    close();
+
+    struct Event {
+        uint32_t type;
+        uint64_t config;
+    };
+    const Event events[COUNT] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_REF_CPU_CYCLES},
+    };
+
+    for (int i = 0; i < COUNT; i++) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[i].type;
+        attr.config = events[i].config;
+        attr.exclude_kernel = 1;  // Allowed at the default perf_event_paranoid
+        attr.exclude_hv = 1;
+        if (i == Cycles) {
+            attr.disabled = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+        }
+        int fd = perf_event_open(&attr, i == Cycles ? -1 : m_fd[Cycles]);
+        if (fd < 0) {
+            if (i == Cycles) {
+                error = std::string("cycles: ") + strerror(errno);
+                if (errno == EACCES || errno == EPERM) {
+                    error += " (kernel.perf_event_paranoid or container policy)";
+                } else if (errno == ENOENT || errno == ENODEV || errno == EOPNOTSUPP) {
+                    error += " (no hardware PMU, e.g. a VM or container)";
+                }
+                return false;
+            }
+            continue;  // Not offered here; the rest still count
+        }
+        m_fd[i] = fd;
+        m_slot[i] = m_members++;
+        m_available |= 1u << i;
+    }
+
+    if (ioctl(m_fd[Cycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP) < 0 ||
+        ioctl(m_fd[Cycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) < 0) {
+        error = std::string("enable: ") + strerror(errno);
+        close();
+        return false;
+    }
+    return true;
+}
+
+void PerfCounters::close() {
+    for (int i = COUNT - 1; i >= 0; i--) {
+        if (m_fd[i] >= 0) {
+            ::close(m_fd[i]);
+            m_fd[i] = -1;
+        }
+        m_slot[i] = -1;
+    }
+    m_members = 0;
+    m_available = 0;
+}
+
+bool PerfCounters::read(PerfSample& out) const {
+    if (!is_open()) return false;
+
+    // PERF_FORMAT_GROUP: nr, time_enabled, time_running, then one value per member
+    uint64_t buffer[3 + COUNT];
+    ssize_t n = ::read(m_fd[Cycles], buffer, sizeof(buffer));
+    if (n < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buffer[0] != static_cast<uint64_t>(m_members)) {
+        return false;
+    }
+    uint64_t enabled = buffer[1];
+    uint64_t running = buffer[2];
+
+    // More groups than hardware counters: the kernel rotates them and
+    // reports how long this one was actually counting
+    auto value = [&](Counter c) -> uint64_t {
+        if (m_slot[c] < 0) return 0;
+        uint64_t v = buffer[3 + m_slot[c]];
+        if (running > 0 && running < enabled) {
+            v = static_cast<uint64_t>(static_cast<double>(v) * enabled / running);
+        }
+        return v;
+    };
+    out.cycles = value(Cycles);
+    out.instructions = value(Instructions);
+    out.branch_misses = value(BranchMisses);
+    out.l1d_misses = value(L1dMisses);
+    out.ref_cycles = value(RefCycles);
+    out.running_ns = enabled;
+    return true;
+}
+
+#else
+
+bool PerfCounters::open(std::string& error) {
+    error = "perf_event is Linux only";
+    return false;
+}
+
+void PerfCounters::close() {}
+
+bool PerfCounters::read(PerfSample& out) const {
+    return false;
+}
+
+#endif
+
+}  // namespace utils
+}  // namespace bloxminer
@@ -0,0 +1,120 @@
+#include "../../include/utils/shared_stats.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace bloxminer {
+namespace utils {
+
+std::string shared_stats_path() {
+    return "/tmp/bloxminer-" + std::to_string(static_cast<int>(getuid())) + "/stats.shm";
+}
+
+bool SharedStatsWriter::open(const std::string& path) {
+    close();
+
+    size_t slash = path.rfind('/');
+    if (slash != std::string::npos && slash > 0) {
+        mkdir(path.substr(0, slash).c_str(), 0700);
+    }
+
+    // O_NOFOLLOW refuses a symlink planted at the path
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    if (ftruncate(fd, sizeof(SharedStatsSegment)) < 0) {
+        ::close(fd);
+        return false;
+    }
+    void* map = mmap(nullptr, sizeof(SharedStatsSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    // Readers check the header before trusting the layout; fill it last
+    m_segment = static_cast<SharedStatsSegment*>(map);
+    m_segment->magic = 0;
+    m_segment->sequence.store(0, std::memory_order_relaxed);
+    memset(&m_segment->stats, 0, sizeof(m_segment->stats));
+    m_segment->version = SharedStatsSegment::VERSION;
+    m_segment->size = sizeof(SharedStatsSegment);
+    m_segment->reserved = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    m_segment->magic = SharedStatsSegment::MAGIC;
+    return true;
+}
+
+void SharedStatsWriter::close() {
+    if (m_segment) {
+        munmap(m_segment, sizeof(SharedStatsSegment));
+        m_segment = nullptr;
+    }
+}
+
+void SharedStatsWriter::publish(const SharedStats& stats) {
+    if (!m_segment) return;
+    uint64_t seq = m_segment->sequence.load(std::memory_order_relaxed);
+    m_segment->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&m_segment->stats, &stats, sizeof(stats));
+    m_segment->sequence.store(seq + 2, std::memory_order_release);
+}
+
+bool read_shared_stats(const std::string& path, SharedStats& out, std::string& error) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(SharedStatsSegment)) {
+        ::close(fd);
+        error = path + ": not a stats segment";
+        return false;
+    }
+    void* map = mmap(nullptr, sizeof(SharedStatsSegment), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    const SharedStatsSegment* segment = static_cast<const SharedStatsSegment*>(map);
+
+    bool ok = false;
+    if (segment->magic != SharedStatsSegment::MAGIC) {
+        error = path + ": not a stats segment";
+    } else if (segment->version != SharedStatsSegment::VERSION || segment->size != sizeof(SharedStatsSegment)) {
+        error = path + ": layout version " + std::to_string(segment->version) + ", expected " +
+                std::to_string(SharedStatsSegment::VERSION);
+    } else {
+        // The miner writes a few KB once per interval; a handful of retries always suffices
+        for (int attempt = 0; attempt < 1000 && !ok; attempt++) {
+            uint64_t before = segment->sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            memcpy(&out, &segment->stats, sizeof(out));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            ok = segment->sequence.load(std::memory_order_relaxed) == before;
+        }
+        if (!ok) {
+            error = path + ": no consistent snapshot";
+        } else if (out.updated_ms == 0) {
+            ok = false;
+            error = path + ": miner has not published stats yet";
+        }
+    }
+    munmap(map, sizeof(SharedStatsSegment));
+    return ok;
+}
+
+}  // namespace utils
+}  // namespace bloxminer
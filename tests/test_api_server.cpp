@@ -0,0 +1,284 @@
+/*
+ * API server test
+ *
+ * Starts the server on a free loopback port and talks raw HTTP to it:
+ * published snapshots are served, keep-alive and pipelined requests are
+ * answered in order on one connection, a client that stalls mid-request
+ * neither blocks others nor outlives its deadline, control requests whose
+ * body arrives in a later segment still reach the callback, a slow control
+ * action holds up only its own connection, one that throws is answered
+ * with a 500, a malformed Content-Length is refused, and /events
+ * streams bus events as they are published, resuming from Last-Event-ID.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "utils/api_server.hpp"
+#include "utils/event_bus.hpp"
+
+using bloxminer::utils::ApiServer;
+using bloxminer::utils::EventBus;
+
+namespace {
+
+int connect_to(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    struct timeval tv = {2, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return fd;
+}
+
+void send_all(int fd, const std::string& data) {
+    send(fd, data.c_str(), data.size(), MSG_NOSIGNAL);
+}
+
+// Read exactly one response (headers plus Content-Length body)
+std::string read_response(int fd, std::string& pending) {
+    char buffer[4096];
+    while (true) {
+        size_t header_end = pending.find("\r\n\r\n");
+        if (header_end != std::string::npos) {
+            size_t cl = pending.find("Content-Length: ");
+            size_t length = cl < header_end ? std::strtoul(pending.c_str() + cl + 16, nullptr, 10) : 0;
+            if (pending.size() >= header_end + 4 + length) {
+                std::string response = pending.substr(0, header_end + 4 + length);
+                pending.erase(0, header_end + 4 + length);
+                return response;
+            }
+        }
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) return "";
+        pending.append(buffer, static_cast<size_t>(n));
+    }
+}
+
+std::string body_of(const std::string& response) {
+    size_t header_end = response.find("\r\n\r\n");
+    return header_end == std::string::npos ? "" : response.substr(header_end + 4);
+}
+
+// Read until delimiter (inclusive); empty on timeout or close
+std::string read_until(int fd, std::string& pending, const std::string& delimiter) {
+    char buffer[4096];
+    while (true) {
+        size_t end = pending.find(delimiter);
+        if (end != std::string::npos) {
+            std::string out = pending.substr(0, end + delimiter.size());
+            pending.erase(0, end + delimiter.size());
+            return out;
+        }
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) return "";
+        pending.append(buffer, static_cast<size_t>(n));
+    }
+}
+
+// true once the server has closed its side
+bool closed_by_server(int fd) {
+    char c;
+    return recv(fd, &c, 1, 0) == 0;
+}
+
+}  // namespace
+
+int main() {
+    EventBus bus(16);
+    ApiServer server;
+    server.set_event_bus(&bus);
+    std::string control_body;
+    server.set_control_callback([&](const std::string& action, const std::string& body, std::string& response) {
+        if (action == "slow") {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        } else if (action == "throw") {
+            throw std::runtime_error("bad field");
+        }
+        control_body = action + ":" + body;
+        response = R"({"ok":true})";
+        return 200;
+    });
+    if (!server.start(0, [] { return std::string(R"({"rendered":true})"); })) {
+        fprintf(stderr, "Server did not start\n");
+        return 1;
+    }
+    const uint16_t port = server.port();
+
+    // Before publish() the callback renders; afterwards the snapshot is sent
+    int a = connect_to(port);
+    std::string pending;
+    send_all(a, "GET /api/stats HTTP/1.1\r\nHost: x\r\n\r\n");
+    std::string r1 = read_response(a, pending);
+    server.publish(R"({"snapshot":1})");
+    send_all(a, "GET /summary?x=1 HTTP/1.1\r\nHost: x\r\n\r\n");
+    std::string r2 = read_response(a, pending);
+    if (body_of(r1) != R"({"rendered":true})" || body_of(r2) != R"({"snapshot":1})" ||
+        r2.find("Connection: keep-alive") == std::string::npos) {
+        fprintf(stderr, "Keep-alive stats requests were not answered from the snapshot:\n%s\n%s\n",
+                r1.c_str(), r2.c_str());
+        return 1;
+    }
+
+    // Pipelined: three requests in one segment, answered in order
+    send_all(a, "GET /health HTTP/1.1\r\n\r\nGET /nope HTTP/1.1\r\n\r\nGET / HTTP/1.1\r\n\r\n");
+    std::string p1 = read_response(a, pending);
+    std::string p2 = read_response(a, pending);
+    std::string p3 = read_response(a, pending);
+    if (body_of(p1) != R"({"status":"ok"})" || p2.compare(0, 12, "HTTP/1.1 404") != 0 ||
+        body_of(p3) != R"({"snapshot":1})") {
+        fprintf(stderr, "Pipelined requests were not answered in order\n");
+        return 1;
+    }
+
+    // A client stalled mid-request does not hold up another one
+    int stalled = connect_to(port);
+    send_all(stalled, "GET /api/st");
+    int b = connect_to(port);
+    std::string pending_b;
+    send_all(b, "GET /api/stats HTTP/1.1\r\nConnection: close\r\n\r\n");
+    std::string rb = read_response(b, pending_b);
+    if (body_of(rb) != R"({"snapshot":1})" || rb.find("Connection: close") == std::string::npos ||
+        !closed_by_server(b)) {
+        fprintf(stderr, "Second client was not served and closed while another stalled\n");
+        return 1;
+    }
+    close(b);
+
+    // Control body in a later segment than its headers
+    int c = connect_to(port);
+    std::string pending_c;
+    send_all(c, "POST /api/control/threads HTTP/1.1\r\nContent-Length: 14\r\n\r\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    send_all(c, R"({"threads": 3})");
+    std::string rc = read_response(c, pending_c);
+    if (body_of(rc) != R"({"ok":true})" || control_body != R"(threads:{"threads": 3})") {
+        fprintf(stderr, "Control request was not assembled: %s\n", control_body.c_str());
+        return 1;
+    }
+    close(c);
+
+    // A slow control action: others are served meanwhile, and a request pipelined
+    // behind it on the same connection waits for its answer
+    int s1 = connect_to(port);
+    std::string pending_s1;
+    auto slow_start = std::chrono::steady_clock::now();
+    send_all(s1, "POST /api/control/slow HTTP/1.1\r\nContent-Length: 2\r\n\r\n{}GET /health HTTP/1.1\r\n\r\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    int s2 = connect_to(port);
+    std::string pending_s2;
+    send_all(s2, "GET /api/stats HTTP/1.1\r\n\r\n");
+    std::string other = read_response(s2, pending_s2);
+    double other_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - slow_start).count();
+    std::string slow = read_response(s1, pending_s1);
+    std::string after = read_response(s1, pending_s1);
+    if (body_of(other) != R"({"snapshot":1})" || other_ms >= 400.0 || body_of(slow) != R"({"ok":true})" ||
+        control_body != "slow:{}" || body_of(after) != R"({"status":"ok"})") {
+        fprintf(stderr, "Slow control action held up other clients (%.0f ms) or its own pipeline\n", other_ms);
+        return 1;
+    }
+    close(s1);
+    close(s2);
+
+    // A throwing action answers 500 and the server carries on
+    int t = connect_to(port);
+    std::string pending_t;
+    send_all(t, "POST /api/control/throw HTTP/1.1\r\nContent-Length: 0\r\n\r\nGET /health HTTP/1.1\r\n\r\n");
+    std::string thrown = read_response(t, pending_t);
+    std::string alive = read_response(t, pending_t);
+    if (thrown.compare(0, 12, "HTTP/1.1 500") != 0 || body_of(alive) != R"({"status":"ok"})") {
+        fprintf(stderr, "Throwing control action was not answered with 500:\n%s\n", thrown.c_str());
+        return 1;
+    }
+    close(t);
+
+    // A Content-Length that is not a small decimal number is refused, not wrapped
+    for (const char* length : {"-1", "18446744073709551615", "12abc", "99999"}) {
+        int l = connect_to(port);
+        std::string pending_l;
+        send_all(l, std::string("POST /api/control/threads HTTP/1.1\r\nContent-Length: ") + length +
+                        "\r\n\r\n{}GET /health HTTP/1.1\r\n\r\n");
+        std::string refused = read_response(l, pending_l);
+        if (refused.compare(0, 12, "HTTP/1.1 400") != 0 || !closed_by_server(l)) {
+            fprintf(stderr, "Content-Length %s was not refused:\n%s\n", length, refused.c_str());
+            return 1;
+        }
+        close(l);
+    }
+
+    // HTTP/1.0 without keep-alive closes after the response
+    int d = connect_to(port);
+    std::string pending_d;
+    send_all(d, "GET /health HTTP/1.0\r\n\r\n");
+    if (read_response(d, pending_d).empty() || !closed_by_server(d)) {
+        fprintf(stderr, "HTTP/1.0 request did not close the connection\n");
+        return 1;
+    }
+    close(d);
+
+    // Event stream: only events published after subscribing, pushed as they happen
+    bus.publish("job", R"({"job":"old"})");
+    int e = connect_to(port);
+    std::string pending_e;
+    send_all(e, "GET /events HTTP/1.1\r\n\r\n");
+    std::string stream_head = read_until(e, pending_e, "retry: 2000\n\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    bus.publish("share", R"({"nonce":7})");
+    std::string event = read_until(e, pending_e, "\n\n");
+    if (stream_head.find("Content-Type: text/event-stream") == std::string::npos ||
+        event.find("id: 1\nevent: share\ndata: ") != 0 ||
+        event.find(R"(,"nonce":7})") == std::string::npos || event.find(R"({"ts":)") == std::string::npos) {
+        fprintf(stderr, "Event stream did not deliver the share event:\n%s%s\n", stream_head.c_str(), event.c_str());
+        return 1;
+    }
+
+    // Reconnect after id 1: ids 2 and 3 are replayed from the ring
+    bus.publish("job", R"({"job":"2"})");
+    bus.publish("job", R"({"job":"3"})");
+    read_until(e, pending_e, "\n\n");
+    read_until(e, pending_e, "\n\n");
+    close(e);
+    int f = connect_to(port);
+    std::string pending_f;
+    send_all(f, "GET /events HTTP/1.1\r\nLast-Event-ID: 1\r\n\r\n");
+    read_until(f, pending_f, "retry: 2000\n\n");
+    std::string resumed = read_until(f, pending_f, "\n\n") + read_until(f, pending_f, "\n\n");
+    if (resumed.find("id: 2\n") == std::string::npos || resumed.find("id: 3\n") == std::string::npos) {
+        fprintf(stderr, "Stream did not resume after Last-Event-ID:\n%s\n", resumed.c_str());
+        return 1;
+    }
+    close(f);
+
+    // The stalled request runs out of time
+    auto stall_start = std::chrono::steady_clock::now();
+    struct timeval tv = {ApiServer::REQUEST_TIMEOUT_MS / 1000 + 2, 0};
+    setsockopt(stalled, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    if (!closed_by_server(stalled)) {
+        fprintf(stderr, "Stalled request was not timed out\n");
+        return 1;
+    }
+    double waited = std::chrono::duration<double>(std::chrono::steady_clock::now() - stall_start).count();
+    close(stalled);
+    close(a);
+
+    server.stop();
+    printf("API server: keep-alive, pipelining, event streams and timeouts (stalled client closed after %.1f s)\n", waited);
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+ * Legacy CLHash known-answer test
+ *
+ * Pins VerusHash v2.0 and v2.1 (Hasher::hash_raw with CLHash) for fixed
+ * 64-byte inputs. The expected hashes come from the v2.0/v2.1 kernels as
+ * they were before the CLHash variants shared one template, with only the
+ * AES key fix applied. One input per version has the two mutated key
+ * entries alias (prand == prandex) in a case where the store order decides
+ * which value the key keeps, so v2.2's order leaking into the older
+ * versions fails here.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+#include "verus_hash.h"
+
+static void fill_input(uint8_t* data, uint32_t seed) {
+    for (uint32_t i = 0; i < 64; i++) {
+        data[i] = static_cast<uint8_t>(i * 131 + seed * 7 + (seed >> 8) * i + (seed >> 16));
+    }
+}
+
+static void to_hex(const uint8_t* data, size_t len, char* out) {
+    for (size_t i = 0; i < len; i++) {
+        snprintf(out + i * 2, 3, "%02x", data[i]);
+    }
+}
+
+int main() {
+    if (!verus_hash_supported()) {
+        printf("SKIP: CPU lacks AES-NI/AVX/PCLMUL\n");
+        return 0;
+    }
+
+    struct Vector {
+        int solution_version;
+        const char* name;
+        uint32_t seed;
+        const char* hash;
+    };
+    const Vector vectors[] = {
+        {SOLUTION_VERUSHHASH_V2, "v2.0", 0, "193521b9c4122fd67f36bf784aa62e36a6cf41ca3645b65063de533b27249870"},
+        {SOLUTION_VERUSHHASH_V2, "v2.0", 1956, "755fbed6e8218871384f239c902698ac70cbc11bff442d1415298c1dd6f53e1e"},  // Aliasing
+        {SOLUTION_VERUSHHASH_V2_1, "v2.1", 0, "43a6de7956f4d979efa9322d9696c86949f42934fb8f943a577ad8d32db41008"},
+        {SOLUTION_VERUSHHASH_V2_1, "v2.1", 671, "1c803e7203d52d6d0955a0fc3d959744caec33f3494e8e0568cc4d6cb5cdb5b4"},  // Aliasing
+    };
+
+    for (const Vector& v : vectors) {
+        uint8_t data[64];
+        fill_input(data, v.seed);
+        verus::Hasher hasher(v.solution_version);
+        uint8_t hash[32];
+        hasher.hash_raw(data, sizeof(data), hash);
+        char hex[65];
+        to_hex(hash, sizeof(hash), hex);
+        if (strcmp(hex, v.hash) != 0) {
+            fprintf(stderr, "%s input %u: %s, expected %s\n", v.name, v.seed, hex, v.hash);
+            return 1;
+        }
+    }
+
+    // The C entry point for v2.1 goes through the same kernel
+    uint8_t data[64];
+    fill_input(data, 671);
+    uint8_t hash[32];
+    char hex[65];
+    verus_hash_v2_1(hash, data, sizeof(data));
+    to_hex(hash, sizeof(hash), hex);
+    if (strcmp(hex, vectors[3].hash) != 0) {
+        fprintf(stderr, "verus_hash_v2_1 input 671: %s, expected %s\n", hex, vectors[3].hash);
+        return 1;
+    }
+
+    printf("Legacy CLHash v2.0/v2.1 known answers match, aliasing inputs included\n");
+    return 0;
+}
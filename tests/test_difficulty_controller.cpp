@@ -0,0 +1,100 @@
+/*
+ * Difficulty suggestion controller test
+ *
+ * Checks the difficulty/hashes relation, that the first suggestion waits
+ * for a settled hashrate and targets the configured share interval, that
+ * small hashrate changes do not trigger new suggestions while material
+ * ones do, that every reconnect suggests again, and the share interval
+ * statistics.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <initializer_list>
+
+#include "difficulty_controller.hpp"
+
+using bloxminer::DifficultyController;
+
+static bool near(double a, double b) {
+    return std::fabs(a - b) <= 1e-6 * std::max(std::fabs(a), std::fabs(b));
+}
+
+int main() {
+    DifficultyController::Options options;  // 10 s per share, 25% drift, 3 samples
+    const double per_diff1 = DifficultyController::hashes_per_share(1.0);
+
+    if (per_diff1 < 4.29e9 || per_diff1 > 4.30e9) {
+        fprintf(stderr, "Difficulty 1 should take about 2^32 hashes, got %f\n", per_diff1);
+        return 1;
+    }
+
+    // 30 MH/s for 10 s per share: 3e8 hashes per share
+    {
+        DifficultyController ctl(options);
+        if (ctl.update(30e6) != 0.0 || ctl.update(30e6) != 0.0) {
+            fprintf(stderr, "Suggested before the hashrate settled\n");
+            return 1;
+        }
+        double d = ctl.update(30e6);
+        if (!near(d, 3e8 / per_diff1)) {
+            fprintf(stderr, "Expected difficulty %f, got %f\n", 3e8 / per_diff1, d);
+            return 1;
+        }
+        if (!near(ctl.expected_interval(d), 10.0)) {
+            fprintf(stderr, "Suggested difficulty gives %f s per share\n", ctl.expected_interval(d));
+            return 1;
+        }
+
+        // Jitter of a few percent: nothing new to say
+        for (double hr : {28e6, 32e6, 29e6, 31e6}) {
+            if (ctl.update(hr) != 0.0) {
+                fprintf(stderr, "Suggested again on a small change\n");
+                return 1;
+            }
+        }
+
+        // Governor halves the threads: hashrate drops by half
+        double next = 0.0;
+        for (int i = 0; i < 10 && next == 0.0; i++) {
+            next = ctl.update(15e6);
+        }
+        if (next == 0.0 || next > 0.8 * d || ctl.suggestions() != 2) {
+            fprintf(stderr, "Halved hashrate did not lower the suggestion (%f)\n", next);
+            return 1;
+        }
+
+        // Reconnect: suggest with the handshake
+        if (!near(ctl.on_connect(), ctl.ideal(ctl.hashrate())) || ctl.suggestions() != 3) {
+            fprintf(stderr, "Reconnect did not suggest again\n");
+            return 1;
+        }
+    }
+
+    // No hashrate yet at the first connect: nothing to send
+    {
+        DifficultyController ctl(options);
+        if (ctl.on_connect() != 0.0) {
+            fprintf(stderr, "Suggested with no hashrate\n");
+            return 1;
+        }
+    }
+
+    // Share interval EWMA
+    {
+        DifficultyController ctl(options);
+        auto t = std::chrono::steady_clock::now();
+        for (int i = 0; i < 5; i++) {
+            ctl.record_share(t + std::chrono::seconds(4 * i));
+        }
+        if (!near(ctl.observed_interval(), 4.0)) {
+            fprintf(stderr, "Observed interval %f, expected 4\n", ctl.observed_interval());
+            return 1;
+        }
+    }
+
+    printf("Difficulty controller targets the share interval without chasing jitter\n");
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * Effective hashrate and luck test
+ *
+ * Simulates a 1 MH/s miner whose shares arrive as a Poisson process at
+ * one per 10 s, fed to the estimator the way the miner does: hashes every
+ * stats interval, each share found, and the pool's answer. Checks the
+ * Poisson intervals, that effective hashrate and luck bracket the truth,
+ * that rejected shares show up as lost difficulty and as a gap, that pools
+ * and windows are kept apart, and that history ends after 24 hours.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "difficulty_controller.hpp"
+#include "effective_hashrate.hpp"
+
+using bloxminer::DifficultyController;
+using bloxminer::EffectiveHashrate;
+using Clock = EffectiveHashrate::Clock;
+
+static bool near(double value, double expected, double tolerance) {
+    return std::fabs(value - expected) <= tolerance * expected;
+}
+
+// Mine `seconds` on a pool, one 10 s step at a time; a share is rejected with probability reject
+static void mine(EffectiveHashrate& e, Clock::time_point& now, std::mt19937& rng, double seconds,
+                 size_t pool, double hashrate, double difficulty, double reject) {
+    const double step = 10.0;
+    const double shares_per_step = hashrate * step / DifficultyController::hashes_per_share(difficulty);
+    std::poisson_distribution<int> shares(shares_per_step > 0.0 ? shares_per_step : 1.0);
+    std::bernoulli_distribution rejected(reject);
+    for (double t = 0.0; t < seconds; t += step) {
+        now += std::chrono::milliseconds(static_cast<int64_t>(step * 1000));
+        e.add_work(now, pool, hashrate * step, difficulty);
+        for (int n = shares_per_step > 0.0 ? shares(rng) : 0; n > 0; n--) {
+            e.add_found(now, pool, difficulty);
+            e.add_result(now, pool, difficulty, !rejected(rng));
+        }
+    }
+}
+
+int main() {
+    // Wilson-Hilferty against exact Poisson limits
+    {
+        double low, high;
+        EffectiveHashrate::poisson_interval(0, low, high);
+        if (low != 0.0 || !near(high, 3.689, 0.01)) {
+            fprintf(stderr, "Interval for 0: [%.3f, %.3f], expected [0, 3.689]\n", low, high);
+            return 1;
+        }
+        EffectiveHashrate::poisson_interval(100, low, high);
+        if (!near(low, 81.36, 0.01) || !near(high, 121.63, 0.01)) {
+            fprintf(stderr, "Interval for 100: [%.2f, %.2f], expected [81.36, 121.63]\n", low, high);
+            return 1;
+        }
+    }
+
+    const double hashrate = 1e6;
+    const double difficulty = hashrate * 10.0 / DifficultyController::hashes_per_share(1.0);  // One share per 10 s
+
+    // All accepted: effective and luck bracket the truth, gap is luck alone
+    {
+        std::mt19937 rng(1);
+        Clock::time_point start = Clock::now();
+        Clock::time_point now = start;
+        EffectiveHashrate e(start);
+        mine(e, now, rng, 6 * 3600.0, 0, hashrate, difficulty, 0.0);
+        for (double seconds : {3600.0, 6 * 3600.0}) {
+            EffectiveHashrate::Window w = e.window(now, seconds);
+            if (!near(w.local, hashrate, 0.005) || w.seconds < seconds || w.seconds > seconds + 60.0) {
+                fprintf(stderr, "%.0f s window: local %.0f H/s over %.0f s\n", seconds, w.local, w.seconds);
+                return 1;
+            }
+            if (w.effective_low > hashrate || w.effective_high < hashrate ||
+                w.luck_low > 1.0 || w.luck_high < 1.0 || w.rejected != 0 || w.lost != 0.0) {
+                fprintf(stderr, "%.0f s window: effective %.0f [%.0f, %.0f], luck %.3f [%.3f, %.3f]\n", seconds,
+                        w.effective, w.effective_low, w.effective_high, w.luck, w.luck_low, w.luck_high);
+                return 1;
+            }
+            if (std::fabs(w.gap - (1.0 - w.luck)) > 1e-9 || !near(w.expected, seconds / 10.0, 0.02)) {
+                fprintf(stderr, "%.0f s window: gap %.4f with luck %.4f, %.1f shares expected\n", seconds,
+                        w.gap, w.luck, w.expected);
+                return 1;
+            }
+        }
+        // The interval narrows with more shares
+        double w1 = e.window(now, 3600.0).effective_high - e.window(now, 3600.0).effective_low;
+        double w6 = e.window(now, 6 * 3600.0).effective_high - e.window(now, 6 * 3600.0).effective_low;
+        if (w6 >= w1 * 0.6) {
+            fprintf(stderr, "Interval did not narrow: %.0f over 1 h, %.0f over 6 h\n", w1, w6);
+            return 1;
+        }
+    }
+
+    // 10% rejected: lost difficulty shows it, and the gap exceeds the luck shortfall
+    {
+        std::mt19937 rng(2);
+        Clock::time_point start = Clock::now();
+        Clock::time_point now = start;
+        EffectiveHashrate e(start);
+        mine(e, now, rng, 6 * 3600.0, 0, hashrate, difficulty, 0.10);
+        EffectiveHashrate::Window w = e.window(now, 6 * 3600.0);
+        if (std::fabs(w.lost - 0.10) > 0.03 || w.rejected == 0 ||
+            std::fabs(w.gap - (1.0 - w.luck * (1.0 - w.lost))) > 1e-9 || w.effective_high > hashrate) {
+            fprintf(stderr, "Rejects: lost %.3f, gap %.3f, luck %.3f, effective high %.0f\n",
+                    w.lost, w.gap, w.luck, w.effective_high);
+            return 1;
+        }
+    }
+
+    // Pools and windows apart; early windows cover only the run so far; 24 h of history
+    {
+        std::mt19937 rng(3);
+        Clock::time_point start = Clock::now();
+        Clock::time_point now = start;
+        EffectiveHashrate e(start);
+        mine(e, now, rng, 1800.0, 0, hashrate, difficulty, 0.0);
+        EffectiveHashrate::Window early = e.window(now, 3600.0);
+        if (!near(early.seconds, 1800.0, 0.001) || !near(early.local, hashrate, 0.001)) {
+            fprintf(stderr, "Early window: %.0f s, %.0f H/s\n", early.seconds, early.local);
+            return 1;
+        }
+        mine(e, now, rng, 1800.0, 1, 2 * hashrate, difficulty, 0.0);
+        EffectiveHashrate::Window p0 = e.window(now, 3600.0, 0);
+        EffectiveHashrate::Window p1 = e.window(now, 3600.0, 1);
+        EffectiveHashrate::Window all = e.window(now, 3600.0);
+        if (!near(p0.local, hashrate / 2, 0.05) || !near(p1.local, hashrate, 0.05) ||
+            !near(all.local, 1.5 * hashrate, 0.05) || p0.found + p1.found != all.found) {
+            fprintf(stderr, "Per pool: %.0f + %.0f H/s of %.0f\n", p0.local, p1.local, all.local);
+            return 1;
+        }
+        mine(e, now, rng, 24 * 3600.0 + 120.0, 1, 0.0, difficulty, 0.0);  // A day idle
+        EffectiveHashrate::Window day = e.window(now, 24 * 3600.0);
+        if (day.found != 0 || day.local != 0.0 || !std::isnan(day.luck) || !std::isnan(day.gap)) {
+            fprintf(stderr, "History older than 24 h still counted (%llu shares)\n",
+                    static_cast<unsigned long long>(day.found));
+            return 1;
+        }
+    }
+
+    printf("Effective hashrate: intervals cover the truth, rejects show as lost difficulty\n");
+    return 0;
+}
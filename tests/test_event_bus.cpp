@@ -0,0 +1,107 @@
+/*
+ * Event bus test
+ *
+ * Publishes into the ring and reads it back at independent cursors: events
+ * arrive in order, a reader that falls a full ring behind loses exactly its
+ * oldest events and is told how many, oversized payloads are refused, and
+ * several threads publishing at once neither block nor tear an event.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/event_bus.hpp"
+
+using bloxminer::utils::EventBus;
+
+int main() {
+    // In order, each reader at its own cursor
+    {
+        EventBus bus(8);
+        uint64_t a = bus.head();
+        bus.publish("job", R"({"n":0})");
+        bus.publish("share", R"({"n":1})");
+        uint64_t b = bus.head();
+        bus.publish("job", R"({"n":2})");
+
+        std::vector<EventBus::Event> out;
+        uint64_t dropped = 0;
+        bus.read(a, out, 16, dropped);
+        std::vector<EventBus::Event> late;
+        bus.read(b, late, 16, dropped);
+        if (out.size() != 3 || strcmp(out[1].type, "share") != 0 ||
+            std::string(out[2].data, out[2].data_len) != R"({"n":2})" || out[2].id != 2 ||
+            late.size() != 1 || late[0].id != 2 || dropped != 0 || a != 3) {
+            fprintf(stderr, "Events not read back in order (%zu, %zu)\n", out.size(), late.size());
+            return 1;
+        }
+    }
+
+    // Lapped reader loses its oldest events, and only those
+    {
+        EventBus bus(4);
+        uint64_t cursor = 0;
+        for (int i = 0; i < 10; i++) {
+            bus.publish("tick", "{\"n\":" + std::to_string(i) + "}");
+        }
+        std::vector<EventBus::Event> out;
+        uint64_t dropped = 0;
+        bus.read(cursor, out, 16, dropped);
+        if (dropped != 6 || out.size() != 4 || out[0].id != 6 || bus.tail() != 6) {
+            fprintf(stderr, "Lapped reader: %llu dropped, %zu read\n",
+                    static_cast<unsigned long long>(dropped), out.size());
+            return 1;
+        }
+    }
+
+    // Oversized payloads are refused rather than truncated
+    {
+        EventBus bus(4);
+        if (bus.publish("big", std::string(EventBus::DATA_SIZE + 1, 'x')) || bus.head() != 0) {
+            fprintf(stderr, "Oversized event was published\n");
+            return 1;
+        }
+    }
+
+    // Concurrent writers: every event is whole and ids are unique
+    {
+        const int writers = 4;
+        const int per_writer = 200;
+        EventBus bus(writers * per_writer);
+        std::vector<std::thread> threads;
+        for (int w = 0; w < writers; w++) {
+            threads.emplace_back([&bus, w] {
+                for (int i = 0; i < per_writer; i++) {
+                    bus.publish("w", "{\"w\":" + std::to_string(w) + ",\"i\":" + std::to_string(i) + "}");
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+
+        uint64_t cursor = 0;
+        uint64_t dropped = 0;
+        std::vector<EventBus::Event> out;
+        bus.read(cursor, out, writers * per_writer, dropped);
+        std::vector<int> next(writers, 0);
+        for (size_t i = 0; i < out.size(); i++) {
+            int w = -1, n = -1;
+            std::string data(out[i].data, out[i].data_len);
+            if (out[i].id != i || sscanf(data.c_str(), "{\"w\":%d,\"i\":%d}", &w, &n) != 2 ||
+                w < 0 || w >= writers || n != next[w]) {
+                fprintf(stderr, "Torn or reordered event %zu: %s\n", i, data.c_str());
+                return 1;
+            }
+            next[w]++;
+        }
+        if (out.size() != static_cast<size_t>(writers * per_writer) || dropped != 0) {
+            fprintf(stderr, "Expected %d events, read %zu\n", writers * per_writer, out.size());
+            return 1;
+        }
+    }
+
+    printf("Event bus delivers in order and drops a slow reader's oldest events\n");
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * Power/thermal governor test
+ *
+ * Drives the governor against simple simulated rigs: package power linear
+ * in capacity, a lagging temperature, and a hashrate that stops scaling
+ * past a core count so KH/W has a peak. Checks that limits are held, that
+ * an unreachable limit bottoms out at the floor, and that the efficiency
+ * search settles next to the peak.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "governor.hpp"
+
+using bloxminer::Governor;
+using bloxminer::GovernorMode;
+
+// 40 W idle plus 100 W at full capacity
+static double rig_power(const Governor::Decision& d) {
+    return 40.0 + 100.0 * d.capacity;
+}
+
+int main() {
+    const double dt = 2.0;
+
+    // Power limit: settles at 100 W, i.e. 60% capacity
+    {
+        Governor gov(GovernorMode::Power, 100.0, 16);
+        Governor::Decision d = gov.current();
+        for (int i = 0; i < 200; i++) {
+            d = gov.update(rig_power(d), dt);
+        }
+        double power = rig_power(d);
+        if (std::fabs(power - 100.0) > 1.0) {
+            fprintf(stderr, "Power settled at %.2f W, target 100 W\n", power);
+            return 1;
+        }
+        if (d.threads != 10 || std::fabs(d.duty - 0.96) > 0.02) {
+            fprintf(stderr, "Expected 10 threads at ~96%% duty, got %u at %.3f\n", d.threads, d.duty);
+            return 1;
+        }
+    }
+
+    // Temperature limit with a first-order thermal lag: 30 C ambient + 60 C at full load
+    {
+        Governor gov(GovernorMode::Temperature, 75.0, 8);
+        Governor::Decision d = gov.current();
+        double temp = 30.0;
+        double peak = 0.0;
+        for (int i = 0; i < 400; i++) {
+            double steady = 30.0 + 60.0 * d.capacity;
+            temp += (steady - temp) * 0.2;
+            peak = std::max(peak, i >= 200 ? temp : 0.0);
+            d = gov.update(temp, dt);
+        }
+        if (std::fabs(temp - 75.0) > 1.0 || peak > 76.0) {
+            fprintf(stderr, "Temperature settled at %.2f C (late peak %.2f), target 75 C\n", temp, peak);
+            return 1;
+        }
+    }
+
+    // Unreachable limit: floor is min_threads workers at MIN_DUTY
+    {
+        Governor gov(GovernorMode::Power, 10.0, 8, 2);
+        Governor::Decision d = gov.current();
+        for (int i = 0; i < 200; i++) {
+            d = gov.update(rig_power(d), dt);
+        }
+        if (d.threads != 2 || std::fabs(d.duty - Governor::MIN_DUTY) > 1e-9) {
+            fprintf(stderr, "Expected floor of 2 threads at min duty, got %u at %.3f\n", d.threads, d.duty);
+            return 1;
+        }
+        // Missing readings hold the decision
+        Governor::Decision held = gov.update(0.0, dt);
+        if (held.capacity != d.capacity) {
+            fprintf(stderr, "Missing reading changed the decision\n");
+            return 1;
+        }
+    }
+
+    // Efficiency: hashrate scales to 12 of 16 threads, power keeps rising,
+    // so KH/W peaks at 12
+    {
+        Governor gov(GovernorMode::Efficiency, 0.0, 16);
+        Governor::Decision d = gov.current();
+        for (int i = 0; i < 60; i++) {
+            double threads = d.capacity * 16;
+            double khs = 1000.0 * std::min(threads, 12.0);
+            double watts = 20.0 + 6.0 * threads;
+            d = gov.update(khs / watts, dt);
+        }
+        if (d.threads < 11 || d.threads > 13) {
+            fprintf(stderr, "Efficiency search ended at %u threads, peak is 12\n", d.threads);
+            return 1;
+        }
+    }
+
+    // Off never throttles
+    {
+        Governor gov(GovernorMode::Off, 0.0, 4);
+        Governor::Decision d = gov.update(500.0, dt);
+        if (d.threads != 4 || d.duty != 1.0) {
+            fprintf(stderr, "Off mode throttled to %u threads at %.3f\n", d.threads, d.duty);
+            return 1;
+        }
+    }
+
+    printf("Governor holds its limits and finds the efficiency peak\n");
+    return 0;
+}
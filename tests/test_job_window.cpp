@@ -0,0 +1,114 @@
+/*
+ * Job validity window test
+ *
+ * Checks that jobs sent without clean_jobs stay valid for shares, that
+ * clean_jobs or a new block, session or pool drops them, that the window
+ * is bounded, and that identical work sent again resumes from its saved
+ * nonce ranges, including those workers handed back on the switch.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "job_window.hpp"
+
+using bloxminer::JobWindow;
+using bloxminer::NonceScheduler;
+using bloxminer::stratum::Job;
+
+static Job make_job(const std::string& id, const std::string& prev_hash, bool clean,
+                    const std::string& extranonce1 = "abcdef01") {
+    Job job;
+    job.job_id = id;
+    job.prev_hash = prev_hash;
+    job.clean_jobs = clean;
+    job.extranonce1 = extranonce1;
+    job.solution = "0700";
+    memset(job.header, 0, sizeof(job.header));
+    memset(job.target, 0xff, sizeof(job.target));
+    job.header_len = 140;
+    // Job id stands in for the merkle root: different ids, different work
+    memcpy(job.header + 36, id.data(), id.size());
+    memcpy(job.header + 4, prev_hash.data(), prev_hash.size());
+    return job;
+}
+
+int main() {
+    const std::string pool = "pool:3956";
+    NonceScheduler::Progress progress;
+
+    // Rotating jobs on one block: all stay valid until clean_jobs
+    {
+        JobWindow window(4);
+        window.add(1, pool, make_job("a", "aa", true), progress);
+        window.add(2, pool, make_job("b", "aa", false), progress);
+        window.add(3, pool, make_job("c", "aa", false), progress);
+        if (!window.find(1) || !window.find(2) || window.find(2)->job_id != "b") {
+            fprintf(stderr, "Jobs without clean_jobs were dropped\n");
+            return 1;
+        }
+        window.add(4, pool, make_job("d", "aa", true), progress);
+        if (window.find(1) || window.find(3) || !window.find(4)) {
+            fprintf(stderr, "clean_jobs did not drop the earlier jobs\n");
+            return 1;
+        }
+    }
+
+    // A new block, session or pool invalidates even without clean_jobs
+    {
+        JobWindow window(4);
+        window.add(1, pool, make_job("a", "aa", true), progress);
+        window.add(2, pool, make_job("b", "bb", false), progress);
+        window.add(3, pool, make_job("c", "bb", false, "12345678"), progress);
+        window.add(4, "other:3956", make_job("d", "bb", false, "12345678"), progress);
+        if (window.size() != 1 || !window.find(4)) {
+            fprintf(stderr, "Window kept %zu jobs across block/session/pool changes\n", window.size());
+            return 1;
+        }
+    }
+
+    // Bounded: the oldest job falls out
+    {
+        JobWindow window(2);
+        window.add(1, pool, make_job("a", "aa", true), progress);
+        window.add(2, pool, make_job("b", "aa", false), progress);
+        window.add(3, pool, make_job("c", "aa", false), progress);
+        if (window.find(1) || !window.find(2) || !window.find(3)) {
+            fprintf(stderr, "Window did not evict the oldest job\n");
+            return 1;
+        }
+    }
+
+    // Identical work sent again (even with clean_jobs) resumes its saved ranges
+    {
+        JobWindow window(4);
+        window.add(1, pool, make_job("a", "aa", true), progress);
+        NonceScheduler::Progress saved;
+        saved.pass = 0;
+        saved.ranges.push_back({1000, 2000, 0});
+        window.suspend(1, saved);
+        window.give_back(1, {500, 600, 0});
+        window.add(2, pool, make_job("b", "aa", false), progress);
+        window.suspend(2, NonceScheduler::Progress());
+
+        NonceScheduler::Progress resume;
+        if (!window.add(3, pool, make_job("a", "aa", true), resume) || resume.ranges.size() != 2 ||
+            window.resumed() != 1) {
+            fprintf(stderr, "Identical work did not resume its saved ranges\n");
+            return 1;
+        }
+        if (window.find(1) || !window.find(3)) {
+            fprintf(stderr, "Resumed job should replace the old entry\n");
+            return 1;
+        }
+        NonceScheduler::Progress none;
+        if (window.add(4, pool, make_job("e", "aa", false), none)) {
+            fprintf(stderr, "New work matched a saved job\n");
+            return 1;
+        }
+    }
+
+    printf("Job window keeps valid jobs and resumes repeated work\n");
+    return 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * Event journal test
+ *
+ * Records into a small ring in a scratch directory and checks that records
+ * read back with their fields and wall-clock times, that concurrent writers
+ * never leave a torn record for a reader, that the ring keeps exactly the
+ * newest records once it wraps, that a restart keeps the previous journal,
+ * and that the decoder's text and JSON lines say what was recorded.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "utils/journal.hpp"
+#include "nlohmann/json.hpp"
+
+using bloxminer::utils::Journal;
+using bloxminer::utils::JournalEntry;
+using bloxminer::utils::JournalEvent;
+using bloxminer::utils::JournalHeader;
+using bloxminer::utils::JournalRecord;
+using bloxminer::utils::format_journal_entry;
+using bloxminer::utils::read_journal;
+
+static int64_t unix_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+int main() {
+    char dir[] = "/tmp/test_journal_XXXXXX";
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "mkdtemp failed\n");
+        return 1;
+    }
+    const std::string path = std::string(dir) + "/journal.bin";
+    std::vector<JournalEntry> entries;
+    std::string error;
+
+    if (read_journal(path, entries, error)) {
+        fprintf(stderr, "Read a journal from a missing file\n");
+        return 1;
+    }
+
+    // Recorded, then read back in order with times inside the window
+    Journal journal;
+    if (!journal.open(path, 100)) {
+        fprintf(stderr, "Could not create %s\n", path.c_str());
+        return 1;
+    }
+    int64_t before = unix_now_ns();
+    journal.record(JournalEvent::JobReceived, 7, 1);
+    journal.record_thread(JournalEvent::ShareFound, 3, 42, 7);
+    journal.record(JournalEvent::ShareResult, 1, 850);
+    int64_t after = unix_now_ns();
+    if (!read_journal(path, entries, error) || entries.size() != 3) {
+        fprintf(stderr, "Expected 3 records, read %zu: %s\n", entries.size(), error.c_str());
+        return 1;
+    }
+    if (entries[0].type != JournalEvent::JobReceived || entries[0].a != 7 ||
+        entries[0].thread != JournalRecord::NO_THREAD || entries[1].type != JournalEvent::ShareFound ||
+        entries[1].thread != 3 || entries[1].a != 42 || entries[1].b != 7 || entries[2].b != 850) {
+        fprintf(stderr, "Records read back with the wrong fields\n");
+        return 1;
+    }
+    for (const JournalEntry& e : entries) {
+        // The 10 ms calibration at open is coarse; allow a little slack
+        if (e.unix_ns < before - 5000000 || e.unix_ns > after + 5000000) {
+            fprintf(stderr, "Record %llu at %lld, outside [%lld, %lld]\n",
+                    static_cast<unsigned long long>(e.index), static_cast<long long>(e.unix_ns),
+                    static_cast<long long>(before), static_cast<long long>(after));
+            return 1;
+        }
+    }
+
+    // Decoded lines
+    std::string text = format_journal_entry(entries[1], false);
+    if (text.find(" t3 ") == std::string::npos || text.find("share_found") == std::string::npos ||
+        text.find("nonce=0000002a job=7") == std::string::npos) {
+        fprintf(stderr, "Unexpected text line: %s\n", text.c_str());
+        return 1;
+    }
+    nlohmann::json line = nlohmann::json::parse(format_journal_entry(entries[0], true));
+    if (line["event"] != "job_received" || line["job"] != 7 || line["clean"] != true ||
+        line["resumed"] != false || line.contains("thread")) {
+        fprintf(stderr, "Unexpected JSON line: %s\n", line.dump().c_str());
+        return 1;
+    }
+
+    // Writers on every thread; a concurrent reader must only see whole records
+    const int WRITERS = 4;
+    const uint64_t PER_WRITER = 50000;
+    std::atomic<int> running{WRITERS};
+    std::vector<std::thread> writers;
+    for (int w = 0; w < WRITERS; w++) {
+        writers.emplace_back([&, w] {
+            for (uint64_t i = 0; i < PER_WRITER; i++) {
+                uint64_t a = (static_cast<uint64_t>(w) << 32) | i;
+                journal.record_thread(JournalEvent::Stats, static_cast<uint16_t>(w), a, ~a);
+            }
+            running--;
+        });
+    }
+    uint64_t checked = 0;
+    while (running > 0) {
+        if (!read_journal(path, entries, error)) {
+            fprintf(stderr, "Read failed during writes: %s\n", error.c_str());
+            return 1;
+        }
+        for (const JournalEntry& e : entries) {
+            if (e.type == JournalEvent::Stats && (e.b != ~e.a || e.thread != (e.a >> 32))) {
+                fprintf(stderr, "Torn record at index %llu\n", static_cast<unsigned long long>(e.index));
+                return 1;
+            }
+            checked++;
+        }
+    }
+    for (auto& t : writers) {
+        t.join();
+    }
+
+    // Wrapped: exactly the newest `capacity` records, contiguous
+    const uint64_t total = 3 + WRITERS * PER_WRITER;
+    if (!read_journal(path, entries, error) || entries.size() != 128 ||
+        entries.front().index != total - 128 || entries.back().index != total - 1) {
+        fprintf(stderr, "Wrapped ring holds %zu records from %llu\n", entries.size(),
+                entries.empty() ? 0ull : static_cast<unsigned long long>(entries.front().index));
+        return 1;
+    }
+
+    // A reservation that never finished (writer died mid-record) is skipped
+    {
+        int fd = open(path.c_str(), O_RDWR);
+        uint64_t head = total + 1;
+        pwrite(fd, &head, sizeof(head), offsetof(JournalHeader, head));
+        close(fd);
+        if (!read_journal(path, entries, error) || entries.size() != 127 || entries.back().index != total - 1) {
+            fprintf(stderr, "Unfinished record not skipped: %zu records\n", entries.size());
+            return 1;
+        }
+    }
+
+    // Restart: the previous journal moves aside and stays readable
+    journal.close();
+    if (!journal.open(path, 100) || !read_journal(path, entries, error) || !entries.empty()) {
+        fprintf(stderr, "Reopened journal is not empty\n");
+        return 1;
+    }
+    if (!read_journal(path + ".1", entries, error) || entries.size() != 127) {
+        fprintf(stderr, "Previous journal not kept: %s\n", error.c_str());
+        return 1;
+    }
+    journal.close();
+
+    // Another layout version is refused, not misread
+    {
+        int fd = open(path.c_str(), O_RDWR);
+        uint32_t version = JournalHeader::VERSION + 1;
+        pwrite(fd, &version, sizeof(version), offsetof(JournalHeader, version));
+        close(fd);
+        if (read_journal(path, entries, error) || error.find("layout version") == std::string::npos) {
+            fprintf(stderr, "Accepted a journal from another layout version\n");
+            return 1;
+        }
+    }
+
+    unlink(path.c_str());
+    unlink((path + ".1").c_str());
+    rmdir(dir);
+    printf("Journal: %llu records checked during concurrent writes\n", static_cast<unsigned long long>(checked));
+    return 0;
+}
@@ -0,0 +1,141 @@
+/*
+ * Asynchronous logger test
+ *
+ * Captures the terminal output and checks that records format as the
+ * synchronous logger did, that string arguments are copied at the call,
+ * that each thread's lines come out in order, that a thread logging faster
+ * than the writer drops and reports lines instead of blocking, and that
+ * the log file is written without colors and rotated.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "utils/logger.hpp"
+
+using bloxminer::utils::Logger;
+using bloxminer::utils::LogLevel;
+
+static bool file_exists(const std::string& path) {
+    return access(path.c_str(), F_OK) == 0;
+}
+
+int main() {
+    std::stringstream captured;
+    std::streambuf* terminal = std::cout.rdbuf(captured.rdbuf());
+    Logger& logger = Logger::instance();
+
+    // Formatting matches the synchronous logger: no width or precision
+    LOG_INFO("a %s b %d c %u d %zu e %f %% f %s", "str", -3, 7u, size_t(9), 1.5, std::string("x"));
+    logger.share_found(1.23456);
+    char buffer[16] = "before";
+    LOG_WARN("copied %s", buffer);
+    strcpy(buffer, "after!");
+    logger.set_level(LogLevel::WARN);
+    LOG_INFO("filtered out");
+    logger.set_level(LogLevel::INFO);
+    logger.flush();
+    std::string out = captured.str();
+    if (out.find("[INF]\033[0m a str b -3 c 7 d 9 e 1.5 % f x") == std::string::npos ||
+        out.find("Share found! Difficulty: 1.2346") == std::string::npos ||
+        out.find("[WRN]\033[0m copied before") == std::string::npos ||
+        out.find("filtered out") != std::string::npos) {
+        std::cout.rdbuf(terminal);
+        fprintf(stderr, "Unexpected output:\n%s\n", out.c_str());
+        return 1;
+    }
+
+    // Each thread's lines in the order it logged them
+    captured.str("");
+    const int THREADS = 4;
+    const int LINES = 100;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([t] {
+            for (int n = 0; n < LINES; n++) {
+                LOG_INFO("thread %d line %d", t, n);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    logger.flush();
+    out = captured.str();
+    for (int t = 0; t < THREADS; t++) {
+        size_t pos = 0;
+        for (int n = 0; n < LINES; n++) {
+            std::string line = "thread " + std::to_string(t) + " line " + std::to_string(n) + "\n";
+            pos = out.find(line, pos);
+            if (pos == std::string::npos) {
+                std::cout.rdbuf(terminal);
+                fprintf(stderr, "Thread %d line %d missing or out of order\n", t, n);
+                return 1;
+            }
+        }
+    }
+
+    // A burst beyond the ring is dropped and reported, never waited on
+    captured.str("");
+    const int BURST = 5000;
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < BURST; n++) {
+        LOG_DEBUG("not logged at INFO %d", n);
+        LOG_INFO("burst %d of %s", n, "a long enough line to be worth formatting later");
+    }
+    double burst_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    logger.flush();
+    out = captured.str();
+    if (logger.dropped() == 0 || out.find("message(s) dropped") == std::string::npos ||
+        out.find("burst 0 of") == std::string::npos) {
+        std::cout.rdbuf(terminal);
+        fprintf(stderr, "Burst of %d lines: %llu dropped, no report\n", BURST,
+                static_cast<unsigned long long>(logger.dropped()));
+        return 1;
+    }
+
+    // File output: plain text, rotated to path.1 .. path.keep
+    char dir[] = "/tmp/test_logger_XXXXXX";
+    if (!mkdtemp(dir)) {
+        std::cout.rdbuf(terminal);
+        fprintf(stderr, "mkdtemp failed\n");
+        return 1;
+    }
+    const std::string path = std::string(dir) + "/miner.log";
+    if (!logger.set_file(path, 2000, 2)) {
+        std::cout.rdbuf(terminal);
+        fprintf(stderr, "Could not open %s\n", path.c_str());
+        return 1;
+    }
+    for (int n = 0; n < 200; n++) {
+        LOG_INFO("file line %d", n);
+        if (n % 50 == 49) logger.flush();  // Stay within the ring
+    }
+    logger.flush();
+    logger.set_file("", 0, 0);
+    std::ifstream file(path);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    bool rotated = file_exists(path + ".1") && file_exists(path + ".2") && !file_exists(path + ".3");
+    std::cout.rdbuf(terminal);
+    if (!rotated || contents.find("[INF] file line 199") == std::string::npos ||
+        contents.find('\033') != std::string::npos) {
+        fprintf(stderr, "Log file not rotated or not plain text:\n%s\n", contents.c_str());
+        return 1;
+    }
+    unlink(path.c_str());
+    unlink((path + ".1").c_str());
+    unlink((path + ".2").c_str());
+    rmdir(dir);
+
+    printf("Logger: %d calls in %.0f us, %llu dropped without blocking\n", BURST * 2, burst_us,
+           static_cast<unsigned long long>(logger.dropped()));
+    return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * Prometheus metrics test
+ *
+ * Checks histogram bucketing (upper bounds inclusive, overflow to +Inf),
+ * that concurrent observers lose no counts, and the text exposition:
+ * cumulative buckets, _sum/_count, label escaping.
+ */
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/metrics.hpp"
+
+using bloxminer::utils::Histogram;
+using bloxminer::utils::MetricsWriter;
+
+static bool contains(const std::string& text, const std::string& line) {
+    if (text.find(line + "\n") == std::string::npos) {
+        fprintf(stderr, "Missing line: %s\n--- output ---\n%s", line.c_str(), text.c_str());
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    // Bucketing: le is inclusive, anything above the last bound is +Inf only
+    {
+        Histogram h({0.1, 0.01, 1.0});  // Sorted on construction
+        for (double v : {0.005, 0.01, 0.05, 0.5, 2.0}) h.observe(v);
+        if (h.bucket(0) != 2 || h.bucket(1) != 1 || h.bucket(2) != 1 || h.bucket(3) != 1 || h.count() != 5) {
+            fprintf(stderr, "Wrong bucket counts\n");
+            return 1;
+        }
+
+        MetricsWriter w;
+        w.histogram("test_seconds", "Test histogram", h);
+        std::string text = w.str();
+        if (!contains(text, "# TYPE test_seconds histogram") ||
+            !contains(text, "test_seconds_bucket{le=\"0.01\"} 2") ||
+            !contains(text, "test_seconds_bucket{le=\"0.1\"} 3") ||
+            !contains(text, "test_seconds_bucket{le=\"1\"} 4") ||
+            !contains(text, "test_seconds_bucket{le=\"+Inf\"} 5") ||
+            !contains(text, "test_seconds_count 5") ||
+            !contains(text, "test_seconds_sum 2.5649999999999999")) {
+            return 1;
+        }
+    }
+
+    // Concurrent observers: nothing lost
+    {
+        Histogram h({1.0});
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&h] {
+                for (int i = 0; i < 100000; i++) h.observe(0.5);
+            });
+        }
+        for (auto& t : threads) t.join();
+        if (h.count() != 400000 || h.sum() != 200000.0) {
+            fprintf(stderr, "Lost observations: count %llu, sum %f\n",
+                    static_cast<unsigned long long>(h.count()), h.sum());
+            return 1;
+        }
+    }
+
+    // Counters and gauges with labels
+    {
+        MetricsWriter w;
+        w.family("test_shares_total", "counter", "Shares");
+        w.sample("test_shares_total", "pool=\"" + MetricsWriter::escape("a\"b\\c") + "\",result=\"accepted\"",
+                 static_cast<uint64_t>(7));
+        w.family("test_temp_celsius", "gauge", "Temperature");
+        w.sample("test_temp_celsius", "", 55.5);
+        std::string text = w.str();
+        if (!contains(text, "# HELP test_shares_total Shares") ||
+            !contains(text, "test_shares_total{pool=\"a\\\"b\\\\c\",result=\"accepted\"} 7") ||
+            !contains(text, "test_temp_celsius 55.5")) {
+            return 1;
+        }
+    }
+
+    printf("Metrics render valid Prometheus text\n");
+    return 0;
+}
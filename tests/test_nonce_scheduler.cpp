@@ -0,0 +1,221 @@
+/*
+ * Work-stealing nonce scheduler test
+ *
+ * Checks that one pass over the nonce space hands out every nonce exactly
+ * once, with and without a slow worker forcing steals, when the pool grows
+ * mid-pass or a worker hands back part of a range, that a suspended job
+ * resumes with exactly the nonces it had not handed out, that stale epochs
+ * get nothing, and that chunk size follows the reported rate.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "nonce_scheduler.hpp"
+
+using bloxminer::NonceScheduler;
+
+// Sort ranges and check they tile [0, space) with no gap or overlap
+static bool covers_exactly(std::vector<NonceScheduler::Range> ranges, uint64_t space) {
+    std::sort(ranges.begin(), ranges.end(),
+              [](const NonceScheduler::Range& a, const NonceScheduler::Range& b) { return a.begin < b.begin; });
+    uint64_t next = 0;
+    for (const auto& r : ranges) {
+        if (r.begin != next || r.end <= r.begin) {
+            fprintf(stderr, "Expected range at %llu, got [%llu, %llu)\n",
+                    (unsigned long long)next, (unsigned long long)r.begin, (unsigned long long)r.end);
+            return false;
+        }
+        next = r.end;
+    }
+    if (next != space) {
+        fprintf(stderr, "Ranges end at %llu, space is %llu\n", (unsigned long long)next, (unsigned long long)space);
+        return false;
+    }
+    return true;
+}
+
+// Run workers until each sees the space restart; return the first-pass ranges
+static std::vector<NonceScheduler::Range> run_pass(NonceScheduler& sched, uint32_t workers, uint32_t slow_worker) {
+    std::vector<NonceScheduler::Range> ranges;
+    std::mutex ranges_mutex;
+    std::vector<std::thread> threads;
+
+    for (uint32_t w = 0; w < workers; w++) {
+        threads.emplace_back([&, w] {
+            NonceScheduler::Range r;
+            while (sched.acquire(w, 1, r) && r.pass == 0) {
+                if (w == slow_worker) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                }
+                sched.report(w, r.size(), w == slow_worker ? 0.01 : 0.0001);
+                std::lock_guard<std::mutex> lock(ranges_mutex);
+                ranges.push_back(r);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    return ranges;
+}
+
+int main() {
+    const uint64_t space = 1ULL << 24;
+
+    // Single worker of four drains every other worker's range by stealing
+    {
+        NonceScheduler sched(50, space);
+        sched.reset(1, 4);
+        std::vector<NonceScheduler::Range> ranges;
+        NonceScheduler::Range r;
+        while (sched.acquire(0, 1, r) && r.pass == 0) {
+            ranges.push_back(r);
+        }
+        if (!covers_exactly(ranges, space)) {
+            fprintf(stderr, "Single worker did not cover the space\n");
+            return 1;
+        }
+        if (sched.steals() == 0 || sched.wraps() != 1) {
+            fprintf(stderr, "Expected steals and one wrap, got %llu steals, %llu wraps\n",
+                    (unsigned long long)sched.steals(), (unsigned long long)sched.wraps());
+            return 1;
+        }
+    }
+
+    // Concurrent workers, one of them slow
+    for (uint32_t workers : {2u, 4u, 8u}) {
+        NonceScheduler sched(50, space);
+        sched.reset(1, workers);
+        auto ranges = run_pass(sched, workers, 0);
+        if (!covers_exactly(ranges, space)) {
+            fprintf(stderr, "%u workers did not cover the space\n", workers);
+            return 1;
+        }
+        if (sched.steals() == 0) {
+            fprintf(stderr, "%u workers with a slow one never stole\n", workers);
+            return 1;
+        }
+    }
+
+    // Pool grows from 2 to 6 workers after the first ranges are handed out
+    {
+        NonceScheduler sched(50, space);
+        sched.reset(1, 2);
+        std::vector<NonceScheduler::Range> ranges;
+        NonceScheduler::Range r;
+        for (uint32_t w = 0; w < 2; w++) {
+            if (!sched.acquire(w, 1, r)) {
+                fprintf(stderr, "Worker %u got no range before resize\n", w);
+                return 1;
+            }
+            ranges.push_back(r);
+        }
+        sched.resize(6);
+        auto rest = run_pass(sched, 6, 6);
+        ranges.insert(ranges.end(), rest.begin(), rest.end());
+        if (!covers_exactly(ranges, space)) {
+            fprintf(stderr, "Grown pool did not cover the space\n");
+            return 1;
+        }
+    }
+
+    // Worker 1 retires halfway through its first range and hands back the tail
+    {
+        NonceScheduler sched(50, space);
+        sched.reset(1, 4);
+        NonceScheduler::Range r;
+        if (!sched.acquire(1, 1, r)) {
+            fprintf(stderr, "Worker 1 got no range\n");
+            return 1;
+        }
+        NonceScheduler::Range done = r, tail = r;
+        done.end = tail.begin = r.begin + r.size() / 2;
+        if (!sched.release(1, 1, tail)) {
+            fprintf(stderr, "Tail could not be handed back\n");
+            return 1;
+        }
+        std::vector<NonceScheduler::Range> ranges = {done};
+        for (uint32_t w : {0u, 2u, 3u}) {
+            while (sched.acquire(w, 1, r) && r.pass == 0) {
+                ranges.push_back(r);
+            }
+        }
+        if (!covers_exactly(ranges, space)) {
+            fprintf(stderr, "Handed-back tail was not rescheduled\n");
+            return 1;
+        }
+    }
+
+    // Job 1 is left for job 2 after a few ranges, then resumed with fewer workers:
+    // the ranges before and after tile the space once, nothing is handed out twice
+    {
+        NonceScheduler sched(50, space);
+        sched.reset(1, 4);
+        std::vector<NonceScheduler::Range> ranges;
+        NonceScheduler::Range r;
+        for (uint32_t w : {0u, 1u, 1u, 3u}) {
+            if (!sched.acquire(w, 1, r)) {
+                fprintf(stderr, "Worker %u got no range before suspending\n", w);
+                return 1;
+            }
+            ranges.push_back(r);
+        }
+        NonceScheduler::Progress progress = sched.suspend(1);
+        sched.reset(2, 4);
+        if (sched.suspend(1).ranges.size() != 0) {
+            fprintf(stderr, "Suspending a stale epoch returned ranges\n");
+            return 1;
+        }
+        sched.resume(3, 2, progress);
+        if (sched.acquire(0, 2, r)) {
+            fprintf(stderr, "Job 2 still handed out ranges after resuming job 1\n");
+            return 1;
+        }
+        for (uint32_t w : {0u, 1u}) {
+            while (sched.acquire(w, 3, r) && r.pass == 0) {
+                ranges.push_back(r);
+            }
+        }
+        if (!covers_exactly(ranges, space)) {
+            fprintf(stderr, "Resumed job did not continue where it left off\n");
+            return 1;
+        }
+    }
+
+    // Stale epochs get nothing
+    {
+        NonceScheduler sched(50, space);
+        sched.reset(1, 2);
+        sched.reset(2, 2);
+        NonceScheduler::Range r;
+        if (sched.acquire(0, 1, r)) {
+            fprintf(stderr, "Stale epoch was handed a range\n");
+            return 1;
+        }
+        if (!sched.acquire(0, 2, r) || r.begin != 0) {
+            fprintf(stderr, "Current epoch should start at worker 0's range\n");
+            return 1;
+        }
+    }
+
+    // Chunk follows the reported rate: 1M nonces/s at 50 ms is 50000 nonces
+    {
+        NonceScheduler sched(50, space);
+        sched.report(0, 100000, 0.1);
+        if (sched.chunk_size(0) != 50000) {
+            fprintf(stderr, "Expected chunk 50000, got %llu\n", (unsigned long long)sched.chunk_size(0));
+            return 1;
+        }
+        sched.report(1, 10, 1.0);
+        if (sched.chunk_size(1) != NonceScheduler::MIN_CHUNK) {
+            fprintf(stderr, "Chunk should be clamped to MIN_CHUNK\n");
+            return 1;
+        }
+    }
+
+    printf("Nonce scheduler covers the space exactly once per pass\n");
+    return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Performance counter test
+ *
+ * Where the kernel offers a PMU, checks that the group counts user-space
+ * work on this thread and keeps counting across reads. Where it does not
+ * (VMs, containers, perf_event_paranoid), checks that open() says why and
+ * read() reports nothing, which is what the miner relies on to go on
+ * without counters.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "utils/perf_counters.hpp"
+
+using bloxminer::utils::PerfCounters;
+using bloxminer::utils::PerfSample;
+
+static volatile uint64_t g_sink;
+
+static void spin(uint64_t iterations) {
+    uint64_t x = 88172645463325252ull;
+    for (uint64_t i = 0; i < iterations; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        if (x & 1) g_sink = x;  // A data-dependent branch to mispredict
+    }
+}
+
+int main() {
+    PerfCounters perf;
+    std::string error;
+    PerfSample sample;
+
+    if (!perf.open(error)) {
+        if (error.empty() || perf.is_open() || perf.read(sample) || perf.available() != 0) {
+            fprintf(stderr, "Failed open left counters half set up (error: '%s')\n", error.c_str());
+            return 1;
+        }
+        printf("Perf counters: unavailable here (%s), miner runs without them\n", error.c_str());
+        return 0;
+    }
+    if (!(perf.available() & (1u << PerfCounters::Cycles))) {
+        fprintf(stderr, "Opened without the cycles leader\n");
+        return 1;
+    }
+
+    PerfSample first, second;
+    spin(1000000);
+    if (!perf.read(first) || first.cycles == 0 || first.running_ns == 0) {
+        fprintf(stderr, "No cycles counted for a busy loop\n");
+        return 1;
+    }
+    spin(10000000);
+    if (!perf.read(second) || second.cycles <= first.cycles || second.running_ns <= first.running_ns) {
+        fprintf(stderr, "Counters did not advance\n");
+        return 1;
+    }
+    if ((perf.available() & (1u << PerfCounters::Instructions)) && second.instructions < 10000000) {
+        fprintf(stderr, "Counted %llu instructions for 10M loop iterations\n",
+                static_cast<unsigned long long>(second.instructions));
+        return 1;
+    }
+
+    double cycles = static_cast<double>(second.cycles - first.cycles);
+    double ns = static_cast<double>(second.running_ns - first.running_ns);
+    printf("Perf counters: %.2f IPC at %.2f GHz, %llu branch misses, counters 0x%x\n",
+           static_cast<double>(second.instructions - first.instructions) / cycles, cycles / ns,
+           static_cast<unsigned long long>(second.branch_misses - first.branch_misses), perf.available());
+    perf.close();
+    return perf.is_open() ? 1 : 0;
+}
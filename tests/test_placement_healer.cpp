@@ -0,0 +1,165 @@
+/*
+ * Self-healing placement test
+ *
+ * Simulates rigs where each CPU has its own speed: most at 1000 H/s, a few
+ * slowed by interrupts or a busy sibling. Checks that noise and brief dips
+ * are left alone, that a persistent outlier is moved to a spare CPU and the
+ * bad one is never used again, that without a spare CPU only a worker that
+ * is mostly starved is retired, and that a worker still slow after a move
+ * is kept where it is.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+#include "placement_healer.hpp"
+
+using bloxminer::PlacementHealer;
+
+// One interval's rates: each worker runs at its CPU's speed
+static std::vector<double> rates(const PlacementHealer& h, const std::map<int, double>& slow_cpus) {
+    std::vector<double> r;
+    for (uint32_t i = 0; i < h.workers(); i++) {
+        int cpu = h.cpu_for(i);
+        auto it = slow_cpus.find(cpu);
+        // +-2% of noise, the same pattern every interval
+        r.push_back((it != slow_cpus.end() ? it->second : 1000.0) * (1.0 + 0.02 * ((i % 3) - 1.0)));
+    }
+    return r;
+}
+
+static std::vector<int> cpu_range(int n) {
+    std::vector<int> cpus;
+    for (int i = 0; i < n; i++) cpus.push_back(i);
+    return cpus;
+}
+
+int main() {
+    PlacementHealer::Options options;  // 10% below the median, 3 intervals
+
+    // Noise and a two-interval dip: nothing to do
+    {
+        PlacementHealer h(cpu_range(8), options);
+        h.resize(8);
+        for (int i = 0; i < 10; i++) {
+            auto r = rates(h, i == 4 || i == 5 ? std::map<int, double>{{3, 700.0}} : std::map<int, double>{});
+            if (!h.update(r).empty()) {
+                fprintf(stderr, "Acted on noise or a brief dip (interval %d)\n", i);
+                return 1;
+            }
+        }
+    }
+
+    // Persistent outlier with spare CPUs: moved on the third slow interval
+    {
+        PlacementHealer h(cpu_range(8), options);
+        h.resize(6);
+        const std::map<int, double> slow = {{2, 850.0}};
+        std::vector<PlacementHealer::Decision> d;
+        int interval = 0;
+        while (d.empty() && interval < 10) {
+            d = h.update(rates(h, slow));
+            interval++;
+        }
+        if (interval != 3 || d.size() != 1 || d[0].action != PlacementHealer::Action::Move ||
+            d[0].thread != 2 || d[0].from_cpu != 2 || d[0].to_cpu != 6 || h.cpu_for(2) != 6) {
+            fprintf(stderr, "Outlier not moved to the spare CPU after 3 intervals\n");
+            return 1;
+        }
+        // Healthy now; CPU 2 is out for good, even for a new worker
+        for (int i = 0; i < 10; i++) {
+            if (!h.update(rates(h, slow)).empty()) {
+                fprintf(stderr, "Acted again after a successful move\n");
+                return 1;
+            }
+        }
+        h.resize(8);
+        if (h.cpu_for(6) != 7 || h.cpu_for(7) != -1 || h.allowed() != 7 || h.moves() != 1) {
+            fprintf(stderr, "Excluded CPU reused (worker 6 on %d, worker 7 on %d, allowed %u)\n",
+                    h.cpu_for(6), h.cpu_for(7), h.allowed());
+            return 1;
+        }
+    }
+
+    // No spare CPU: a mildly slow worker is kept and reported once
+    {
+        PlacementHealer h(cpu_range(8), options);
+        h.resize(8);
+        const std::map<int, double> slow = {{5, 800.0}};
+        int decisions = 0;
+        for (int i = 0; i < 12; i++) {
+            for (const auto& d : h.update(rates(h, slow))) {
+                if (d.action != PlacementHealer::Action::Keep || d.thread != 5) {
+                    fprintf(stderr, "Mildly slow worker moved or retired without a spare CPU\n");
+                    return 1;
+                }
+                decisions++;
+            }
+        }
+        if (decisions != 1 || h.workers() != 8) {
+            fprintf(stderr, "Keep reported %d times, %u workers\n", decisions, h.workers());
+            return 1;
+        }
+    }
+
+    // No spare CPU: a starved worker is retired and takes the top worker's CPU
+    {
+        PlacementHealer h(cpu_range(8), options);
+        h.resize(8);
+        const std::map<int, double> slow = {{1, 300.0}};
+        std::vector<PlacementHealer::Decision> d;
+        for (int i = 0; i < 3; i++) {
+            d = h.update(rates(h, slow));
+        }
+        if (d.size() != 1 || d[0].action != PlacementHealer::Action::Retire || d[0].thread != 1 ||
+            d[0].from_cpu != 1 || d[0].to_cpu != 7 || h.workers() != 7 || h.cpu_for(1) != 7 ||
+            h.allowed() != 7 || h.retired() != 1) {
+            fprintf(stderr, "Starved worker not retired onto the top worker's CPU\n");
+            return 1;
+        }
+        if (std::fabs(d[0].median - 1000.0) > 25.0) {
+            fprintf(stderr, "Median %.1f, expected about 1000\n", d[0].median);
+            return 1;
+        }
+    }
+
+    // The CPU was not the cause: still slow after a move, so kept there
+    {
+        PlacementHealer h(cpu_range(6), options);
+        h.resize(4);
+        const std::vector<double> r = {1000.0, 1000.0, 700.0, 1000.0};
+        int moves = 0, keeps = 0;
+        for (int i = 0; i < 15; i++) {
+            for (const auto& d : h.update(r)) {
+                if (d.action == PlacementHealer::Action::Move) moves++;
+                if (d.action == PlacementHealer::Action::Keep) keeps++;
+            }
+        }
+        if (moves != 1 || keeps != 1 || h.excluded().size() != 1) {
+            fprintf(stderr, "Slow worker chased across CPUs: %d moves, %d keeps\n", moves, keeps);
+            return 1;
+        }
+        h.reset(cpu_range(6));
+        if (!h.excluded().empty() || h.cpu_for(2) != 2) {
+            fprintf(stderr, "Reset kept excluded CPUs\n");
+            return 1;
+        }
+    }
+
+    // Too few workers to compare, or a pool size that does not match
+    {
+        PlacementHealer h(cpu_range(4), options);
+        h.resize(3);
+        for (int i = 0; i < 10; i++) {
+            if (!h.update({1000.0, 1000.0, 100.0}).empty() || !h.update({1000.0, 100.0}).empty()) {
+                fprintf(stderr, "Acted with fewer than %u workers\n", PlacementHealer::MIN_WORKERS);
+                return 1;
+            }
+        }
+    }
+
+    printf("Placement healer: outliers moved or retired, noise and slow-anywhere workers left alone\n");
+    return 0;
+}
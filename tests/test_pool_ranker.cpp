@@ -0,0 +1,108 @@
+/*
+ * Pool latency ranking test
+ *
+ * Feeds probe rounds for three pools and checks the ranking, that a faster
+ * pool only wins after beating the current one by the margin on several
+ * rounds in a row, that jitter around the margin never causes a switch,
+ * and that failed probes demote a pool and steer failover.
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include "pool_ranker.hpp"
+
+using bloxminer::PoolRanker;
+
+static void round_of(PoolRanker& ranker, const std::vector<double>& rtts) {
+    for (size_t i = 0; i < rtts.size(); i++) {
+        bool ok = rtts[i] > 0;
+        ranker.record_probe(i, ok, ok ? rtts[i] / 2 : 0.0, ok ? rtts[i] : 0.0);
+    }
+}
+
+int main() {
+    PoolRanker::Options options;  // 10 ms and 20%, 3 rounds, 2 failures
+
+    // Ranking by smoothed stratum RTT; unmeasured pools last
+    {
+        PoolRanker ranker(3, options);
+        ranker.record_probe(1, true, 20.0, 40.0);
+        ranker.record_probe(2, true, 5.0, 12.0);
+        std::vector<size_t> order = ranker.ranking();
+        if (order != std::vector<size_t>{2, 1, 0}) {
+            fprintf(stderr, "Ranking %zu,%zu,%zu, expected 2,1,0\n", order[0], order[1], order[2]);
+            return 1;
+        }
+    }
+
+    // Hysteresis: pool 2 is much faster but must win three rounds in a row
+    {
+        PoolRanker ranker(3, options);
+        for (int r = 0; r < 2; r++) {
+            round_of(ranker, {120.0, 150.0, 30.0});
+            if (ranker.evaluate(0) != 0) {
+                fprintf(stderr, "Switched after %d round(s), expected 3\n", r + 1);
+                return 1;
+            }
+        }
+        round_of(ranker, {120.0, 150.0, 30.0});
+        if (ranker.evaluate(0) != 2) {
+            fprintf(stderr, "Did not switch to the faster pool after 3 rounds\n");
+            return 1;
+        }
+    }
+
+    // Jitter: a pool that is only sometimes faster by the margin never takes over
+    {
+        PoolRanker ranker(2, options);
+        for (int r = 0; r < 50; r++) {
+            round_of(ranker, {50.0, r % 3 == 0 ? 20.0 : 60.0});
+            if (ranker.evaluate(0) != 0) {
+                fprintf(stderr, "Switched on jitter at round %d\n", r);
+                return 1;
+            }
+        }
+    }
+
+    // Small gains are not worth a reconnect: 45 ms vs 50 ms fails both margins
+    {
+        PoolRanker ranker(2, options);
+        for (int r = 0; r < 10; r++) {
+            round_of(ranker, {50.0, 45.0});
+            if (ranker.evaluate(0) != 0) {
+                fprintf(stderr, "Switched for a 5 ms gain\n");
+                return 1;
+            }
+        }
+    }
+
+    // Failed probes: the fastest pool goes unhealthy and failover skips it
+    {
+        PoolRanker ranker(3, options);
+        round_of(ranker, {10.0, 80.0, 40.0});
+        round_of(ranker, {-1.0, 80.0, 40.0});
+        if (!ranker.healthy(0) || ranker.ranking().front() != 0) {
+            fprintf(stderr, "One failed probe demoted pool 0\n");
+            return 1;
+        }
+        round_of(ranker, {-1.0, 80.0, 40.0});
+        if (ranker.healthy(0) || ranker.ranking().front() != 2) {
+            fprintf(stderr, "Two failed probes did not demote pool 0\n");
+            return 1;
+        }
+        if (ranker.next_after_failure(2) != 1 || ranker.next_after_failure(1) != 2) {
+            fprintf(stderr, "Failover did not follow the ranking\n");
+            return 1;
+        }
+        // Recovered pools start from fresh samples
+        round_of(ranker, {12.0, 80.0, 40.0});
+        if (!ranker.healthy(0) || ranker.entry(0).rtt_ms != 12.0) {
+            fprintf(stderr, "Recovered pool kept stale RTT %.1f\n", ranker.entry(0).rtt_ms);
+            return 1;
+        }
+    }
+
+    printf("Pool ranker prefers the fastest healthy pool without flapping\n");
+    return 0;
+}
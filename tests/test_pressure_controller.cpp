@@ -0,0 +1,150 @@
+/*
+ * Background-mode pressure controller test
+ *
+ * Feeds 50 ms CPU pressure readings the way /proc/pressure/cpu would report
+ * them around a foreground burst. Checks that workers are halved on every
+ * high reading down to the floor, that they come back one at a time only
+ * after the recovery time below the low mark, and that the cost and
+ * benefit of shedding are accounted. Then feeds the workers' own wait back
+ * in from a simulated host, and checks that the count settles where the
+ * workers fit instead of oscillating.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "pressure_controller.hpp"
+
+using bloxminer::PressureController;
+
+int main() {
+    const double dt = 0.05;
+    const double thread_rate = 1000.0;  // H/s per worker
+
+    // Burst: 16 -> 8 -> 4 -> 2 -> 1 on consecutive high readings, then held at the floor
+    {
+        PressureController pc(16, 10.0, 2.0, 2000);
+        const uint32_t expected[] = {8, 4, 2, 1, 1, 1};
+        for (uint32_t want : expected) {
+            uint32_t allowed = pc.update(40.0, 0.0, dt, thread_rate);
+            if (allowed != want) {
+                fprintf(stderr, "High pressure: allowed %u, expected %u\n", allowed, want);
+                return 1;
+            }
+        }
+        if (pc.stats().shed_events != 4) {
+            fprintf(stderr, "Expected 4 shed events, got %llu\n",
+                    static_cast<unsigned long long>(pc.stats().shed_events));
+            return 1;
+        }
+    }
+
+    // Recovery: one worker per 2 s of calm; in-between readings reset the clock
+    {
+        PressureController pc(4, 10.0, 2.0, 2000);
+        pc.update(50.0, 0.0, dt, thread_rate);
+        pc.update(50.0, 0.0, dt, thread_rate);  // 1 worker
+        for (int i = 0; i < 39; i++) {
+            pc.update(1.0, 0.0, dt, thread_rate);
+        }
+        if (pc.allowed() != 1) {
+            fprintf(stderr, "Restored a worker before the recovery time (allowed %u)\n", pc.allowed());
+            return 1;
+        }
+        pc.update(5.0, 0.0, dt, thread_rate);  // Between the marks: start over
+        for (int i = 0; i < 39; i++) {
+            pc.update(1.0, 0.0, dt, thread_rate);
+        }
+        if (pc.allowed() != 1) {
+            fprintf(stderr, "Mid-band reading did not reset recovery (allowed %u)\n", pc.allowed());
+            return 1;
+        }
+        pc.update(1.0, 0.0, dt, thread_rate);
+        if (pc.allowed() != 2) {
+            fprintf(stderr, "Expected 2 workers after 2 s calm, got %u\n", pc.allowed());
+            return 1;
+        }
+        for (int i = 0; i < 80; i++) {
+            pc.update(0.0, 0.0, dt, thread_rate);
+        }
+        if (pc.allowed() != 4) {
+            fprintf(stderr, "Expected full recovery to 4 workers, got %u\n", pc.allowed());
+            return 1;
+        }
+    }
+
+    // Accounting: 1 s at half the workers after a 30% trigger, pressure down to 0
+    {
+        PressureController pc(8, 10.0, 2.0, 60000);
+        pc.update(30.0, 0.0, dt, thread_rate);  // 4 shed for this reading too
+        for (int i = 0; i < 19; i++) {
+            pc.update(0.0, 0.0, dt, thread_rate);
+        }
+        const auto& s = pc.stats();
+        if (std::fabs(s.worker_seconds_shed - 4.0) > 1e-6 ||
+            std::fabs(s.hashes_forgone - 4000.0) > 1e-3) {
+            fprintf(stderr, "Shed %.3f worker-s / %.1f hashes, expected 4 / 4000\n",
+                    s.worker_seconds_shed, s.hashes_forgone);
+            return 1;
+        }
+        if (std::fabs(s.stall_avoided - 0.3 * 19 * dt) > 1e-6) {
+            fprintf(stderr, "Stall avoided %.4f s, expected %.4f\n", s.stall_avoided, 0.3 * 19 * dt);
+            return 1;
+        }
+    }
+
+    // Resizing the pool restores every worker
+    {
+        PressureController pc(8, 10.0, 2.0, 2000);
+        pc.update(90.0, 0.0, dt, thread_rate);
+        pc.set_max_threads(6);
+        if (pc.allowed() != 6) {
+            fprintf(stderr, "Resize left %u workers allowed, expected 6\n", pc.allowed());
+            return 1;
+        }
+    }
+
+    // 16 CPUs, foreground holding 2: each worker beyond 14 waits, which is the miner's own pressure.
+    // Sheds one at a time to 14 and stays there, probing less and less often; climbs back once the
+    // foreground is gone
+    {
+        const uint32_t cpus = 16;
+        uint32_t free_cpus = 14;
+        PressureController pc(cpus, 10.0, 2.0, 2000);
+        auto own = [&](uint32_t workers) {
+            return workers > free_cpus ? (workers - free_cpus) * 100.0 / cpus : 0.0;
+        };
+        uint32_t allowed = cpus;
+        uint32_t lowest = cpus;
+        int readings_above = 0;
+        for (int i = 0; i < 600 * 20; i++) {  // 10 minutes
+            allowed = pc.update(0.0, own(allowed), dt, thread_rate);
+            if (i >= 20) {
+                lowest = std::min(lowest, allowed);
+                readings_above += allowed > free_cpus;
+            }
+        }
+        if (lowest != free_cpus || allowed != free_cpus) {
+            fprintf(stderr, "Own pressure: dropped to %u, ended at %u, expected to settle at %u\n",
+                    lowest, allowed, free_cpus);
+            return 1;
+        }
+        if (pc.stats().shed_events > 12 || readings_above > 12) {
+            fprintf(stderr, "Own pressure: %llu sheds, %d readings above %u workers in 10 min\n",
+                    static_cast<unsigned long long>(pc.stats().shed_events), readings_above, free_cpus);
+            return 1;
+        }
+        free_cpus = cpus;
+        for (int i = 0; i < 300 * 20; i++) {
+            allowed = pc.update(0.0, own(allowed), dt, thread_rate);
+        }
+        if (allowed != cpus) {
+            fprintf(stderr, "Own pressure: %u workers after the foreground left, expected %u\n", allowed, cpus);
+            return 1;
+        }
+    }
+
+    printf("Pressure controller sheds fast, recovers slowly and accounts for both\n");
+    return 0;
+}
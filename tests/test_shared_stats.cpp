@@ -0,0 +1,128 @@
+/*
+ * Shared stats test
+ *
+ * Maps a segment in a scratch directory and checks that a reader sees what
+ * the writer published, that a reader racing a writer only ever sees whole
+ * updates, and that missing files, foreign files and other layout versions
+ * are refused instead of misread.
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "utils/shared_stats.hpp"
+
+using bloxminer::utils::SharedStats;
+using bloxminer::utils::SharedStatsSegment;
+using bloxminer::utils::SharedStatsWriter;
+using bloxminer::utils::read_shared_stats;
+
+static SharedStats make_stats(uint64_t n) {
+    SharedStats stats;
+    memset(&stats, 0, sizeof(stats));
+    strcpy(stats.version, "1.1.1");
+    strcpy(stats.algo, "verushash");
+    stats.updated_ms = 1000 + static_cast<int64_t>(n);
+    stats.num_threads = 4;
+    stats.accepted = n;
+    stats.rejected = n / 2;
+    stats.hashrate = 4.0 * static_cast<double>(n);
+    for (uint32_t i = 0; i < SharedStats::MAX_THREADS; i++) {
+        stats.thread_hashrate[i] = static_cast<double>(n);
+    }
+    return stats;
+}
+
+int main() {
+    char dir[] = "/tmp/test_shared_stats_XXXXXX";
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "mkdtemp failed\n");
+        return 1;
+    }
+    const std::string path = std::string(dir) + "/stats.shm";
+    std::string error;
+    SharedStats out;
+
+    // Nothing there yet
+    if (read_shared_stats(path, out, error)) {
+        fprintf(stderr, "Read stats from a missing file\n");
+        return 1;
+    }
+
+    // Published, then read back
+    SharedStatsWriter writer;
+    if (!writer.open(path)) {
+        fprintf(stderr, "Could not create %s\n", path.c_str());
+        return 1;
+    }
+    if (read_shared_stats(path, out, error)) {
+        fprintf(stderr, "Read stats before the first publish\n");
+        return 1;
+    }
+    writer.publish(make_stats(7));
+    if (!read_shared_stats(path, out, error) || out.accepted != 7 || out.num_threads != 4 ||
+        strcmp(out.algo, "verushash") != 0 || out.thread_hashrate[3] != 7.0) {
+        fprintf(stderr, "Published stats not read back: %s\n", error.c_str());
+        return 1;
+    }
+
+    // A reader racing the writer sees only whole updates
+    std::atomic<bool> done{false};
+    std::thread updater([&] {
+        for (uint64_t n = 8; n < 200000; n++) {
+            writer.publish(make_stats(n));
+        }
+        done = true;
+    });
+    uint64_t reads = 0;
+    while (!done) {
+        if (!read_shared_stats(path, out, error)) continue;
+        uint64_t n = out.accepted;
+        if (out.rejected != n / 2 || out.hashrate != 4.0 * static_cast<double>(n) ||
+            out.thread_hashrate[0] != static_cast<double>(n) ||
+            out.thread_hashrate[SharedStats::MAX_THREADS - 1] != static_cast<double>(n)) {
+            fprintf(stderr, "Torn snapshot at update %llu\n", static_cast<unsigned long long>(n));
+            return 1;
+        }
+        reads++;
+    }
+    updater.join();
+
+    // Another layout version is refused, not misread
+    {
+        int fd = open(path.c_str(), O_RDWR);
+        uint32_t version = SharedStatsSegment::VERSION + 1;
+        pwrite(fd, &version, sizeof(version), offsetof(SharedStatsSegment, version));
+        close(fd);
+        if (read_shared_stats(path, out, error) || error.find("layout version") == std::string::npos) {
+            fprintf(stderr, "Accepted a segment from another layout version\n");
+            return 1;
+        }
+    }
+
+    // A file that is not a segment
+    {
+        const std::string other = std::string(dir) + "/other";
+        int fd = open(other.c_str(), O_RDWR | O_CREAT, 0600);
+        ftruncate(fd, sizeof(SharedStatsSegment));
+        close(fd);
+        if (read_shared_stats(other, out, error)) {
+            fprintf(stderr, "Accepted a file without the segment header\n");
+            return 1;
+        }
+        unlink(other.c_str());
+    }
+
+    writer.close();
+    unlink(path.c_str());
+    rmdir(dir);
+    printf("Shared stats: %llu consistent reads during concurrent updates\n",
+           static_cast<unsigned long long>(reads));
+    return 0;
+}
@@ -0,0 +1,205 @@
+/*
+ * Stratum over TLS test
+ *
+ * Runs a stand-in pool in-process: a TLS server on 127.0.0.1 with a
+ * throwaway self-signed certificate that answers mining.subscribe and
+ * mining.authorize and then sends a job. Checks that the client connects,
+ * completes the pipelined handshake and receives the job over TLS, that a
+ * reconnect resumes the session from its ticket, that certificate checks
+ * reject the self-signed pool when verification is on, and that latency
+ * probes work against a TLS pool.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "stratum/stratum_client.hpp"
+
+using bloxminer::stratum::StratumClient;
+
+namespace {
+
+SSL_CTX* make_server_ctx() {
+    EVP_PKEY* key = EVP_EC_gen("P-256");
+    X509* cert = X509_new();
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                               reinterpret_cast<const unsigned char*>("stand-in pool"), -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    X509_sign(cert, key, EVP_sha256());
+
+    SSL_CTX* ctx = SSL_CTX_new(TLS_server_method());
+    SSL_CTX_set_min_proto_version(ctx, TLS1_3_VERSION);
+    SSL_CTX_use_certificate(ctx, cert);
+    SSL_CTX_use_PrivateKey(ctx, key);
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    return ctx;
+}
+
+void send_line(SSL* ssl, const std::string& line) {
+    std::string msg = line + "\n";
+    SSL_write(ssl, msg.c_str(), static_cast<int>(msg.length()));
+}
+
+// One stratum session: reply by id to subscribe/authorize, then send a job
+void serve(SSL* ssl) {
+    const std::string solution = "07000000" + std::string(2 * 1340, '0');
+    std::string buffer;
+    char tmp[4096];
+    int n;
+    while ((n = SSL_read(ssl, tmp, sizeof(tmp))) > 0) {
+        buffer.append(tmp, static_cast<size_t>(n));
+        size_t nl;
+        while ((nl = buffer.find('\n')) != std::string::npos) {
+            std::string line = buffer.substr(0, nl);
+            buffer.erase(0, nl + 1);
+            size_t id_pos = line.find("\"id\":");
+            std::string id = line.substr(id_pos + 5, line.find(',', id_pos) - id_pos - 5);
+            if (line.find("mining.subscribe") != std::string::npos) {
+                send_line(ssl, "{\"id\":" + id + ",\"result\":[[[\"mining.notify\",\"x\"]],\"abcdef01\",4],\"error\":null}");
+            } else if (line.find("mining.authorize") != std::string::npos) {
+                send_line(ssl, "{\"id\":" + id + ",\"result\":true,\"error\":null}");
+                send_line(ssl, "{\"id\":null,\"method\":\"mining.notify\",\"params\":[\"1\",\"04000100\",\"" +
+                               std::string(64, '1') + "\",\"" + std::string(64, '2') + "\",\"" +
+                               std::string(64, '3') + "\",\"5f5e1000\",\"1d00ffff\",true,\"" + solution + "\"]}");
+            }
+        }
+    }
+}
+
+class StandInPool {
+public:
+    StandInPool() : m_ctx(make_server_ctx()) {
+        m_listen = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(m_listen, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(m_listen, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        listen(m_listen, 8);
+        socklen_t len = sizeof(addr);
+        getsockname(m_listen, reinterpret_cast<sockaddr*>(&addr), &len);
+        m_port = ntohs(addr.sin_port);
+        m_thread = std::thread([this] { accept_loop(); });
+    }
+
+    ~StandInPool() {
+        m_stop = true;
+        shutdown(m_listen, SHUT_RDWR);
+        close(m_listen);
+        m_thread.join();
+        SSL_CTX_free(m_ctx);
+    }
+
+    uint16_t port() const { return m_port; }
+
+private:
+    SSL_CTX* m_ctx;
+    int m_listen;
+    uint16_t m_port;
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+
+    void accept_loop() {
+        while (!m_stop) {
+            int fd = accept(m_listen, nullptr, nullptr);
+            if (fd < 0) break;
+            std::thread([this, fd] {
+                SSL* ssl = SSL_new(m_ctx);
+                SSL_set_fd(ssl, fd);
+                if (SSL_accept(ssl) == 1) {
+                    serve(ssl);
+                }
+                SSL_free(ssl);
+                close(fd);
+            }).detach();
+        }
+    }
+};
+
+}  // namespace
+
+int main() {
+    StandInPool pool;
+
+    StratumClient client;
+    std::atomic<int> jobs{0};
+    client.on_job([&jobs](const bloxminer::stratum::Job&) { jobs++; });
+
+    // Full handshake, pipelined subscribe/authorize, job through run()
+    if (!client.connect("127.0.0.1", pool.port(), true, false)) {
+        fprintf(stderr, "TLS connect to the stand-in pool failed\n");
+        return 1;
+    }
+    if (!client.last_connect_timing().tls || client.last_connect_timing().tls_resumed) {
+        fprintf(stderr, "First connection should be a full TLS handshake\n");
+        return 1;
+    }
+    if (!client.handshake("RTest.worker", "x") || client.get_extranonce1() != "abcdef01") {
+        fprintf(stderr, "Subscribe/authorize over TLS failed\n");
+        return 1;
+    }
+    std::thread runner([&client] { client.run(); });
+    for (int i = 0; i < 200 && jobs == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    client.interrupt();
+    runner.join();
+    client.disconnect();
+    if (jobs == 0) {
+        fprintf(stderr, "No job received over TLS\n");
+        return 1;
+    }
+
+    // Reconnect: the ticket from the first session makes this an abbreviated handshake
+    if (!client.connect("127.0.0.1", pool.port(), true, false) || !client.handshake("RTest.worker", "x")) {
+        fprintf(stderr, "TLS reconnect failed\n");
+        return 1;
+    }
+    if (!client.last_connect_timing().tls_resumed || client.tls_resumptions() != 1 ||
+        client.tls_handshakes() != 2) {
+        fprintf(stderr, "Reconnect did not resume the session (%llu of %llu resumed)\n",
+                static_cast<unsigned long long>(client.tls_resumptions()),
+                static_cast<unsigned long long>(client.tls_handshakes()));
+        return 1;
+    }
+    printf("TLS handshake: full then resumed in %.2f ms\n", client.last_connect_timing().tls_ms);
+    client.disconnect();
+
+    // Verification on: a self-signed stand-in must be refused
+    StratumClient strict;
+    if (strict.connect("127.0.0.1", pool.port(), true, true)) {
+        fprintf(stderr, "Self-signed certificate was accepted with verification on\n");
+        return 1;
+    }
+
+    // Latency probe over TLS
+    double connect_ms = 0.0;
+    double rtt_ms = 0.0;
+    if (!StratumClient::probe("127.0.0.1", pool.port(), 2000, connect_ms, rtt_ms, true, false)) {
+        fprintf(stderr, "TLS probe failed\n");
+        return 1;
+    }
+
+    printf("Stratum over TLS connects, resumes sessions and verifies certificates\n");
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * libverushash batch verification test
+ *
+ * Checks that merged-mining canonicalization clears exactly the
+ * non-canonical fields, that single-block hashes agree with the streaming
+ * VerusHash v2.2 of the canonical block and with the miner's
+ * prepare_job() + hash_with_nonce() path, and that verus_verify_batch()
+ * produces the same hashes for any thread count and applies per-item
+ * targets.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+
+#include "verus_batch.h"
+#include "verus_hash.h"
+
+static uint64_t g_rng = 0x9e3779b97f4a7c15ULL;
+
+static uint8_t next_byte() {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return static_cast<uint8_t>(g_rng);
+}
+
+int main() {
+    if (!verus_hash_supported()) {
+        printf("SKIP: CPU lacks AES-NI/AVX/PCLMUL\n");
+        return 0;
+    }
+
+    const size_t count = 100;
+    std::vector<uint8_t> blocks(count * VERUS_BLOCK_SIZE);
+    for (auto& b : blocks) b = next_byte();
+
+    // Version 7 solutions; every other block is merged-mining (solution[5] > 0)
+    for (size_t i = 0; i < count; i++) {
+        uint8_t* solution = blocks.data() + i * VERUS_BLOCK_SIZE + VERUS_BLOCK_HEADER_SIZE + 3;
+        solution[0] = 7;
+        solution[5] = i % 2 == 0 ? 1 : 0;
+    }
+
+    // Canonicalization: the merged-mining fields are zeroed, nothing else changes,
+    // and blocks that are not merged-mining are left alone
+    for (size_t i = 0; i < 2; i++) {
+        const uint8_t* block = blocks.data() + i * VERUS_BLOCK_SIZE;
+        std::vector<uint8_t> canonical(block, block + VERUS_BLOCK_SIZE);
+        verus_block_canonicalize(canonical.data());
+        for (size_t j = 0; j < VERUS_BLOCK_SIZE; j++) {
+            bool cleared = i == 0 && ((j >= 4 && j < 100) ||        // hashPrevBlock, hashMerkleRoot, hashFinalSaplingRoot
+                                      (j >= 104 && j < 140) ||      // nBits, nNonce
+                                      (j >= 151 && j < 215));       // hashPrevMMRRoot, hashBlockMMRRoot in the solution
+            if (canonical[j] != (cleared ? 0 : block[j])) {
+                fprintf(stderr, "Canonicalized %s block: byte %zu is %02x, expected %02x\n",
+                        i == 0 ? "merged-mining" : "plain", j, canonical[j], cleared ? 0 : block[j]);
+                return 1;
+            }
+        }
+    }
+
+    // Single-block hashes against paths that do not go through hash_block(): the
+    // streaming VerusHash v2.2 of the canonical block, and for plain blocks the
+    // miner's own prepare_job() + hash_with_nonce()
+    std::vector<uint8_t> expected(count * 32);
+    verus::Hasher hasher;
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* block = blocks.data() + i * VERUS_BLOCK_SIZE;
+        verus_block_hash(block, expected.data() + i * 32);
+
+        alignas(32) uint8_t canonical[1536] = {0};
+        memcpy(canonical, block, VERUS_BLOCK_SIZE);
+        verus_block_canonicalize(canonical);
+        uint8_t streamed[32];
+        verus_hash_v2_2(streamed, canonical, VERUS_BLOCK_SIZE);
+        if (memcmp(streamed, expected.data() + i * 32, 32) != 0) {
+            fprintf(stderr, "Block %zu: hash differs from streaming VerusHash v2.2\n", i);
+            return 1;
+        }
+
+        if (i % 2 == 1) {
+            alignas(32) uint8_t padded[1536] = {0};
+            memcpy(padded, block, VERUS_BLOCK_SIZE);
+            uint8_t target[32];
+            memset(target, 0xff, sizeof(target));
+            verus::JobContext job;
+            hasher.prepare_job(padded, block + VERUS_NONCESPACE_OFFSET, target, job);
+            uint8_t mined[32];
+            hasher.hash_with_nonce(job.intermediate, block + VERUS_NONCESPACE_OFFSET, mined);
+            if (memcmp(mined, expected.data() + i * 32, 32) != 0) {
+                fprintf(stderr, "Block %zu: hash differs from the miner's prepare_job path\n", i);
+                return 1;
+            }
+        }
+    }
+
+    // Targets: even items get their own hash (pass on equality), odd items hash - 1 (fail)
+    std::vector<uint8_t> targets(expected);
+    size_t expected_pass = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i % 2 == 0) {
+            expected_pass++;
+            continue;
+        }
+        uint8_t* t = targets.data() + i * 32;
+        bool zero = true;
+        for (int j = 0; j < 32; j++) zero = zero && t[j] == 0;
+        if (zero) {
+            expected_pass++;  // Cannot go below zero; stays a pass
+            continue;
+        }
+        for (int j = 0; j < 32; j++) {
+            if (t[j]-- != 0) break;
+        }
+    }
+
+    for (unsigned threads : {1u, 3u, 8u}) {
+        std::vector<uint8_t> hashes(count * 32, 0);
+        std::vector<uint8_t> pass(count, 0xff);
+
+        int64_t passed = verus_verify_batch(blocks.data(), targets.data(), count, threads,
+                                            hashes.data(), pass.data());
+
+        if (hashes != expected) {
+            fprintf(stderr, "Batch hashes differ from single-block hashes (threads=%u)\n", threads);
+            return 1;
+        }
+        if (passed != static_cast<int64_t>(expected_pass)) {
+            fprintf(stderr, "Expected %zu passing items, got %lld (threads=%u)\n",
+                    expected_pass, static_cast<long long>(passed), threads);
+            return 1;
+        }
+        for (size_t i = 0; i < count; i += 2) {
+            if (pass[i] != 1) {
+                fprintf(stderr, "Item %zu should meet its target (threads=%u)\n", i, threads);
+                return 1;
+            }
+        }
+    }
+
+    // No targets: everything passes
+    if (verus_verify_batch(blocks.data(), nullptr, count, 4, nullptr, nullptr) != static_cast<int64_t>(count)) {
+        fprintf(stderr, "Batch without targets should pass every item\n");
+        return 1;
+    }
+
+    printf("Batch verification matches streaming and mining-path hashes\n");
+    return 0;
+}